@@ -0,0 +1,650 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*
+ * Micro-benchmarks for the hot paths of ALEX.
+ *
+ * Every benchmark is run for a set of parameters (degree, number of subintervals, number of
+ * threads...) and repeated until at least --min-time seconds have elapsed. The results are
+ * printed one per line, either as CSV (default) or as JSON objects (--json), with the columns
+ *
+ *     name, param, threads, iterations, ns_per_op, items_per_sec
+ *
+ * where an "op" is one call of the benchmarked function and "items" are the points, bins or
+ * elements it processes. Run ./build.sh bench to build this program.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "../include/algebra.h"
+#include "../include/approx.h"
+#include "../include/memo.h"
+#include "../include/dispatch.h"
+#include "../include/pool.h"
+#include "../include/cubature.h"
+#include "../include/diff.h"
+#include "../include/func.h"
+#include "../include/integrate.h"
+#include "../include/optimize.h"
+#include "../include/poly.h"
+#include "../include/polybatch.h"
+#include "../include/spoly.h"
+#include "../include/utils.h"
+
+#define BENCH_POINTS 65536u
+#define BENCH_SPARSE_POINTS 64u
+#define BENCH_PAIRS 65536u
+#define BENCH_BATCH 16384u
+#define BENCH_BATCH_DEG 8u
+#define BENCH_SUM_BINS 1000000ul
+
+static double min_time = 0.2;
+static int json = 0;
+static const char *filter = NULL;
+static volatile double sink;
+
+// a single-threaded benchmark, and one running on up to threads threads
+typedef void (*bench_fn)(unsigned long param);
+typedef void (*bench_par_fn)(unsigned long param, unsigned int threads);
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void report(const char *name, unsigned long param, unsigned int threads,
+        unsigned long iterations, double elapsed, double items) {
+    double ns = elapsed * 1e9 / iterations, rate = items * iterations / elapsed;
+    if (json) {
+        printf("{\"name\": \"%s\", \"param\": %lu, \"threads\": %u, \"iterations\": %lu, "
+                "\"ns_per_op\": %.3f, \"items_per_sec\": %.6g}\n", name, param, threads, iterations, ns, rate);
+    }
+    else {
+        printf("%s,%lu,%u,%lu,%.3f,%.6g\n", name, param, threads, iterations, ns, rate);
+    }
+    fflush(stdout);
+}
+
+/*
+ * Calls fn, or par_fn with threads, until min_time has elapsed, doubling the batch size each round.
+ */
+static void measure(const char *name, bench_fn fn, bench_par_fn par_fn, unsigned long param, unsigned int threads,
+        double items) {
+    if (filter != NULL && strstr(name, filter) == NULL) {
+        return;
+    }
+
+    // warm-up (caches, lazily computed tables)
+    if (fn != NULL) {
+        fn(param);
+    }
+    else {
+        par_fn(param, threads);
+    }
+
+    unsigned long iterations = 0, batch = 1;
+    double start = now(), elapsed;
+    do {
+        for (unsigned long i = 0; i < batch; ++i) {
+            if (fn != NULL) {
+                fn(param);
+            }
+            else {
+                par_fn(param, threads);
+            }
+        }
+        iterations += batch;
+        batch *= 2;
+    } while ((elapsed = now() - start) < min_time);
+
+    report(name, param, threads, iterations, elapsed, items);
+}
+
+static void run(const char *name, bench_fn fn, unsigned long param, double items) {
+    measure(name, fn, NULL, param, 1, items);
+}
+
+static void run_par(const char *name, bench_par_fn fn, unsigned long param, unsigned int threads, double items) {
+    measure(name, NULL, fn, param, threads, items);
+}
+
+static double gaussian(double x, void *ctx) {
+    (void) ctx;
+    return exp(-x * x / 2);
+}
+
+static double gaussian_plain(double x) {
+    return exp(-x * x / 2);
+}
+
+static void gaussian_nd(unsigned int dim, const double *x, double *y, size_t n, void *ctx) {
+    (void) ctx;
+    for (size_t i = 0; i < n; ++i, x += dim) {
+        double r2 = 0;
+        for (unsigned int j = 0; j < dim; ++j) {
+            r2 += x[j] * x[j];
+        }
+        y[i] = exp(-r2 / 2);
+    }
+}
+
+static double xs[BENCH_POINTS], ys[BENCH_POINTS];
+static double samples[2 * BENCH_POINTS]; // interleaved (x, y) records with irregular spacing
+static unsigned int gcd_a[BENCH_PAIRS], gcd_b[BENCH_PAIRS];
+static unsigned long gcdl_a[BENCH_PAIRS], gcdl_b[BENCH_PAIRS], gcdl_out[BENCH_PAIRS];
+static alex_poly *polys[4];
+static alex_poly **batch_polys;
+static alex_poly_batch *batch;
+static unsigned char *mem;
+static alex_range *range;
+
+static alex_poly *poly_of_deg(unsigned long deg) {
+    for (int i = 0; i < 4; ++i) {
+        if (polys[i]->deg == deg)
+            return polys[i];
+    }
+    return polys[0];
+}
+
+static void bench_poly_eval(unsigned long deg) {
+    alex_poly *p = poly_of_deg(deg);
+    double acc = 0;
+    for (unsigned int i = 0; i < BENCH_POINTS; ++i) {
+        acc += alex_poly_eval(p, xs[i]);
+    }
+    sink = acc;
+}
+
+static void bench_poly_coeff(unsigned long deg) {
+    // accessor calls in an inner loop, inlined when built with ALEX_INLINE or LTO=1
+    alex_poly *p = poly_of_deg(deg);
+    double acc = 0;
+    for (unsigned int i = 0; i < BENCH_POINTS; ++i) {
+        acc += alex_poly_coeff(p, i % (alex_poly_deg(p) + 1));
+    }
+    sink = acc;
+}
+
+static void bench_poly_eval_many(unsigned long deg) {
+    alex_poly_eval_many(poly_of_deg(deg), xs, ys, BENCH_POINTS);
+    sink = ys[BENCH_POINTS - 1];
+}
+
+static void bench_spoly_eval(unsigned long deg) {
+    // x^deg + 1, evaluated term by term
+    unsigned int exps[2] = {0, (unsigned int) deg};
+    double coeffs[2] = {1.0, 1.0};
+    alex_spoly *p = alex_make_spoly(2, exps, coeffs);
+    double acc = 0;
+    for (unsigned int i = 0; i < BENCH_SPARSE_POINTS; ++i) {
+        acc += alex_spoly_eval(p, xs[i]);
+    }
+    alex_free_spoly(p);
+    sink = acc;
+}
+
+static void bench_spoly_eval_dense(unsigned long deg) {
+    // the same polynomial as bench_spoly_eval(), with all its deg + 1 coefficients
+    alex_poly *p = alex_make_poly((unsigned int) deg, NULL);
+    p->coeffs[0] = p->coeffs[deg] = 1.0;
+    double acc = 0;
+    for (unsigned int i = 0; i < BENCH_SPARSE_POINTS; ++i) {
+        acc += alex_poly_eval(p, xs[i]);
+    }
+    alex_free_poly(p);
+    sink = acc;
+}
+
+static void bench_poly_eval_many_isa(unsigned long isa) {
+    // param is the forced instruction set (see dispatch.h), degree 8
+    alex_set_isa((unsigned int) isa);
+    alex_poly_eval_many(poly_of_deg(8), xs, ys, BENCH_POINTS);
+    alex_set_isa(ALEX_ISA_AUTO);
+    sink = ys[BENCH_POINTS - 1];
+}
+
+static void bench_integrate_trap(unsigned long n) {
+    sink = alex_integrate_trap(&gaussian_plain, range, (int) n);
+}
+
+static void bench_integrate_trap_vec(unsigned long n) {
+    alex_closure_1d f = alex_make_closure(&gaussian, NULL);
+    double res;
+    alex_integrate_trap_vec(alex_closure_vclosure(&f), range, (int) n, &res);
+    sink = res;
+}
+
+static void bench_integrate_trap_par(unsigned long n, unsigned int threads) {
+    alex_integ_ctx ctx = {threads, ALEX_SUM_NAIVE, NULL};
+    double res;
+    alex_integrate_trap_par(alex_make_closure(&gaussian, NULL), range, n, &ctx, &res);
+    sink = res;
+}
+
+static void bench_integrate_bins_sum(unsigned long summation, unsigned int threads) {
+    // param is the summation mode, over BENCH_SUM_BINS bins on one thread
+    alex_integ_ctx ctx = {threads, (unsigned int) summation, NULL};
+    double res;
+    alex_integrate_bins_par(alex_make_closure(&gaussian, NULL), range, BENCH_SUM_BINS, &ctx, &res);
+    sink = res;
+}
+
+static void bench_integrate_bins(unsigned long n) {
+    alex_set_bins(n);
+    sink = alex_integrate_bins(&gaussian_plain, range);
+}
+
+static void bench_integrate_gauss(unsigned long n) {
+    sink = alex_integrate_gauss(&gaussian_plain, range, (unsigned int) n);
+}
+
+static void bench_integrate_adaptive(unsigned long digits) {
+    sink = alex_integrate_adaptive(&gaussian_plain, range, pow(10, -(double) digits), 0, NULL);
+}
+
+static void bench_integrate_romberg(unsigned long digits) {
+    sink = alex_integrate_romberg(&gaussian_plain, range, pow(10, -(double) digits), 0, NULL);
+}
+
+static void bench_integrate_stream(unsigned long chunk) {
+    // param is the number of samples per call of alex_integ_stream_feed_r()
+    alex_integ_stream stream;
+    alex_integ_stream_init_r(&stream, ALEX_STREAM_SIMPSON);
+    for (unsigned long k = 0; k < BENCH_POINTS; k += chunk) {
+        unsigned long n = BENCH_POINTS - k < chunk ? BENCH_POINTS - k : chunk;
+        alex_integ_stream_feed_r(&stream, samples + 2 * k, samples + 2 * k + 1, n, 2);
+    }
+    double area;
+    alex_integ_stream_result_r(&stream, &area);
+    sink = area;
+}
+
+static void bench_diff(unsigned long n) {
+    double acc = 0;
+    for (unsigned long i = 0; i < n; ++i) {
+        acc += alex_diff(&gaussian_plain, xs[i]);
+    }
+    sink = acc;
+}
+
+static void bench_diff_central(unsigned long n) {
+    double acc = 0;
+    for (unsigned long i = 0; i < n; ++i) {
+        acc += alex_diff_central(&gaussian_plain, xs[i]);
+    }
+    sink = acc;
+}
+
+static void bench_diff_richardson(unsigned long n) {
+    double acc = 0;
+    for (unsigned long i = 0; i < n; ++i) {
+        acc += alex_diff_richardson(&gaussian_plain, xs[i]);
+    }
+    sink = acc;
+}
+
+static void bench_diff_many(unsigned long n) {
+    alex_closure_1d f = alex_make_closure(&gaussian, NULL);
+    alex_diff_many(alex_closure_vclosure(&f), -1, 2. / n, n, ys);
+    sink = ys[n - 1];
+}
+
+static double cube_root_2(double x) {
+    return x * x * x - 2;
+}
+
+static void bench_secant(unsigned long iterations) {
+    alex_range *bracket = alex_make_range(0, 2);
+    sink = alex_secant_method(&cube_root_2, bracket, (unsigned) iterations);
+    free(bracket);
+}
+
+static void bench_root_brent(unsigned long digits) {
+    alex_range *bracket = alex_make_range(0, 2);
+    sink = alex_root_brent(&cube_root_2, bracket, pow(10, -(double) digits), NULL);
+    free(bracket);
+}
+
+static void bench_poly_snprintf(unsigned long deg) {
+    static char buf[256 * ALEX_POLY_PRINT_BUFSIZE + 1];
+    sink = (double) alex_poly_snprintf(poly_of_deg(deg), buf, sizeof(buf), "%.17g");
+}
+
+static void bench_poly_serialize(unsigned long deg) {
+    static double buf[258];
+    alex_poly view;
+    alex_poly_serialize(poly_of_deg(deg), buf, sizeof(buf));
+    sink = alex_poly_view(buf, sizeof(buf), &view, NULL)->coeffs[deg];
+}
+
+static void bench_poly_mul(unsigned long len) {
+    alex_poly *p = alex_make_poly((unsigned int) len - 1, xs), *q = alex_make_poly((unsigned int) len - 1, xs + len);
+    alex_poly *r = alex_poly_mul(p, q);
+    sink = r->coeffs[len];
+    alex_free_poly(r);
+    alex_free_poly(q);
+    alex_free_poly(p);
+}
+
+static void bench_poly_roots(unsigned long deg) {
+    static double re[256], im[256];
+    alex_poly_roots_r(poly_of_deg(deg), re, im, ALEX_DEFAULT_ROOT_MAXITER, NULL);
+    sink = re[0];
+}
+
+static void bench_poly_roots_many(unsigned long count, unsigned int threads) {
+    // count cubics, with coefficients taken from the shared random points
+    alex_integ_ctx ctx = {threads, ALEX_SUM_NAIVE, NULL};
+    alex_poly_roots_many(3, xs, count, ys, ys + 3 * count, ALEX_DEFAULT_ROOT_MAXITER, &ctx, NULL);
+    sink = ys[0];
+}
+
+static void bench_poly_each_eval(unsigned long count) {
+    // baseline for bench_poly_batch_eval(): the same polynomials, one alex_poly each
+    for (unsigned long i = 0; i < count; ++i) {
+        ys[i] = alex_poly_eval(batch_polys[i], xs[i]);
+    }
+    sink = ys[0];
+}
+
+static void bench_poly_batch_eval(unsigned long count) {
+    (void) count;
+    alex_poly_batch_eval(batch, xs, ys);
+    sink = ys[0];
+}
+
+static void bench_poly_batch_integ_range(unsigned long count) {
+    (void) count;
+    alex_poly_batch_integ_range(batch, range, ys);
+    sink = ys[0];
+}
+
+static void bench_cubature_gauss(unsigned long n, unsigned int threads) {
+    // 4 dimensions, n^4 points
+    alex_range *box[4] = {range, range, range, range};
+    alex_integ_ctx ctx = {threads, ALEX_SUM_NAIVE, NULL};
+    double res;
+    alex_integrate_gauss_nd_r(alex_make_vclosure_nd(&gaussian_nd, NULL), 4, box, (unsigned int) n, &ctx, &res);
+    sink = res;
+}
+
+static void bench_cubature_qmc(unsigned long npoints, unsigned int threads) {
+    alex_range *box[8] = {range, range, range, range, range, range, range, range};
+    alex_integ_ctx ctx = {threads, ALEX_SUM_NAIVE, NULL};
+    double res;
+    alex_integrate_qmc_r(alex_make_vclosure_nd(&gaussian_nd, NULL), 8, box, ALEX_QMC_SOBOL, npoints, 1, &ctx,
+            NULL, &res);
+    sink = res;
+}
+
+static void bench_cubature_mc(unsigned long npoints, unsigned int threads) {
+    alex_range *box[8] = {range, range, range, range, range, range, range, range};
+    alex_integ_ctx ctx = {threads, ALEX_SUM_NAIVE, NULL};
+    double res;
+    alex_integrate_mc_r(alex_make_vclosure_nd(&gaussian_nd, NULL), 8, box, npoints, 1, &ctx, NULL, &res);
+    sink = res;
+}
+
+static void bench_approx_build(unsigned long digits) {
+    alex_approx *approx;
+    alex_make_approx_r(alex_make_closure(&gaussian, NULL), range, pow(10, -(double) digits),
+            ALEX_DEFAULT_APPROX_DEG, ALEX_DEFAULT_APPROX_PIECES, &approx);
+    sink = approx->breaks[1];
+    free(approx);
+}
+
+static void bench_approx_eval(unsigned long digits) {
+    // the points are scaled to the range, unsorted
+    static alex_approx *approx;
+    static unsigned long built;
+    if (approx == NULL || built != digits) {
+        free(approx);
+        alex_make_approx_r(alex_make_closure(&gaussian, NULL), range, pow(10, -(double) digits),
+                ALEX_DEFAULT_APPROX_DEG, ALEX_DEFAULT_APPROX_PIECES, &approx);
+        built = digits;
+    }
+    double acc = 0;
+    for (unsigned int i = 0; i < BENCH_POINTS; ++i) {
+        double y;
+        alex_approx_eval_r(approx, 5 * xs[i], &y);
+        acc += y;
+    }
+    sink = acc;
+}
+
+static void bench_trap_refine(unsigned long memoize) {
+    // trapezoidal rule refined from 1 to 4096 subintervals, every refinement revisits the previous grid
+    alex_memo *memo = memoize ? alex_make_memo(alex_make_closure(&gaussian, NULL), 1u << 14, 0) : NULL;
+    alex_closure_1d f = memoize ? alex_memo_closure(memo) : alex_make_closure(&gaussian, NULL);
+    double acc = 0;
+    for (unsigned long n = 1; n <= 4096; n *= 2) {
+        double res;
+        alex_integrate_trap_r(f, range, n, &res);
+        acc += res;
+    }
+    if (memoize)
+        alex_free_memo(memo);
+    sink = acc;
+}
+
+static void pool_body(size_t i, void *ctx) {
+    ((double *) ctx)[i] = (double) i;
+}
+
+static void bench_pool_for(unsigned long count, unsigned int threads) {
+    // dispatch latency of a loop of trivial iterations on a pool of 8 threads, created once
+    static alex_pool *pool;
+    if (pool == NULL) {
+        pool = alex_make_pool(8);
+    }
+    alex_pool_for(pool, threads, count, &pool_body, ys);
+    sink = ys[count - 1];
+}
+
+static void bench_gcd(unsigned long n) {
+    unsigned long acc = 0;
+    for (unsigned long i = 0; i < n; ++i) {
+        acc += alex_gcd(gcd_a[i], gcd_b[i]);
+    }
+    sink = acc;
+}
+
+static void bench_gcd_many(unsigned long n) {
+    alex_gcd_many(gcdl_a, gcdl_b, gcdl_out, n);
+    sink = gcdl_out[n - 1];
+}
+
+static void bench_fact(unsigned long x) {
+    unsigned long acc = 0;
+    for (unsigned long i = 0; i <= x; ++i) {
+        acc += alex_factl(i);
+    }
+    sink = acc;
+}
+
+static void bench_mclear(unsigned long size) {
+    alex_mclear(mem, size);
+    sink = mem[size - 1];
+}
+
+static void bench_mclear_nt(unsigned long size) {
+    alex_mclear_nt(mem, size);
+    sink = mem[size - 1];
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [--csv | --json] [--min-time SECONDS] [--filter SUBSTRING]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--json") == 0) {
+            json = 1;
+        }
+        else if (strcmp(argv[i], "--csv") == 0) {
+            json = 0;
+        }
+        else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            min_time = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        }
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    srand(42);
+    for (unsigned int i = 0; i < BENCH_POINTS; ++i) {
+        xs[i] = 2. * rand() / RAND_MAX - 1;
+    }
+    for (unsigned int i = 0; i < BENCH_POINTS; ++i) {
+        samples[2 * i] = i + 0.5 * rand() / RAND_MAX;
+        samples[2 * i + 1] = gaussian_plain(samples[2 * i] / BENCH_POINTS);
+    }
+    for (unsigned int i = 0; i < BENCH_PAIRS; ++i) {
+        gcd_a[i] = (unsigned int) rand();
+        gcd_b[i] = (unsigned int) rand();
+        gcdl_a[i] = (unsigned long) rand() << 31 | (unsigned long) rand();
+        gcdl_b[i] = (unsigned long) rand() << 31 | (unsigned long) rand();
+    }
+
+    static const unsigned long degrees[4] = {4, 16, 64, 256};
+    for (int i = 0; i < 4; ++i) {
+        polys[i] = alex_make_poly((unsigned int) degrees[i], NULL);
+        for (unsigned int k = 0; k <= degrees[i]; ++k) {
+            polys[i]->coeffs[k] = 1. / (k + 1);
+        }
+    }
+    range = alex_make_range(-5, 5);
+
+    batch = alex_make_poly_batch(BENCH_BATCH, BENCH_BATCH_DEG, 0);
+    batch_polys = malloc(BENCH_BATCH * sizeof(alex_poly *));
+    for (unsigned int i = 0; i < BENCH_BATCH; ++i) {
+        batch_polys[i] = alex_make_poly(BENCH_BATCH_DEG, xs + i % (BENCH_POINTS - BENCH_BATCH_DEG));
+        alex_poly_batch_set(batch, i, batch_polys[i]);
+    }
+
+    static const unsigned long subintervals[3] = {1000, 100000, 10000000};
+    static const unsigned int threads[4] = {1, 2, 4, 8};
+
+    if (!json) {
+        printf("name,param,threads,iterations,ns_per_op,items_per_sec\n");
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        run("poly_eval", &bench_poly_eval, degrees[i], BENCH_POINTS);
+        run("poly_eval_many", &bench_poly_eval_many, degrees[i], BENCH_POINTS);
+        run("poly_coeff", &bench_poly_coeff, degrees[i], BENCH_POINTS);
+        run("poly_snprintf", &bench_poly_snprintf, degrees[i], degrees[i] + 1);
+        run("poly_serialize", &bench_poly_serialize, degrees[i], degrees[i] + 1);
+    }
+    for (int i = 0; i < 3; ++i) {
+        run("integrate_trap", &bench_integrate_trap, subintervals[i], subintervals[i]);
+        run("integrate_trap_vec", &bench_integrate_trap_vec, subintervals[i], subintervals[i]);
+        run("integrate_bins", &bench_integrate_bins, subintervals[i], subintervals[i]);
+        for (int t = 0; t < 4; ++t) {
+            run_par("integrate_trap_par", &bench_integrate_trap_par, subintervals[i], threads[t], subintervals[i]);
+        }
+    }
+    for (unsigned long summation = ALEX_SUM_NAIVE; summation <= ALEX_SUM_KAHAN; ++summation) {
+        run_par("integrate_bins_sum", &bench_integrate_bins_sum, summation, 1, BENCH_SUM_BINS);
+    }
+    for (unsigned long n = 8; n <= 128; n *= 4) {
+        run("integrate_gauss", &bench_integrate_gauss, n, n);
+    }
+    for (unsigned long digits = 6; digits <= 12; digits += 3) {
+        run("integrate_adaptive", &bench_integrate_adaptive, digits, 1);
+        run("integrate_romberg", &bench_integrate_romberg, digits, 1);
+    }
+    static const unsigned long chunks[3] = {64, 4096, BENCH_POINTS};
+    for (int i = 0; i < 3; ++i) {
+        run("integrate_stream", &bench_integrate_stream, chunks[i], BENCH_POINTS);
+    }
+    for (int t = 0; t < 4; ++t) {
+        run_par("cubature_gauss", &bench_cubature_gauss, 16, threads[t], 65536);
+        run_par("cubature_qmc", &bench_cubature_qmc, 1ul << 18, threads[t], 1ul << 18);
+        run_par("cubature_mc", &bench_cubature_mc, 1ul << 18, threads[t], 1ul << 18);
+    }
+    run("diff", &bench_diff, BENCH_POINTS, BENCH_POINTS);
+    run("diff_central", &bench_diff_central, BENCH_POINTS, BENCH_POINTS);
+    run("diff_richardson", &bench_diff_richardson, BENCH_POINTS, BENCH_POINTS);
+    run("diff_many", &bench_diff_many, BENCH_POINTS, BENCH_POINTS);
+    run("secant", &bench_secant, 100, 1);
+    for (unsigned long digits = 6; digits <= 12; digits += 3) {
+        run("root_brent", &bench_root_brent, digits, 1);
+    }
+    for (unsigned long len = 16; len <= 4096; len *= 4) {
+        run("poly_mul", &bench_poly_mul, len, len);
+    }
+    for (int i = 0; i < 3; ++i) {
+        run("poly_roots", &bench_poly_roots, degrees[i], degrees[i]);
+    }
+    for (int t = 0; t < 4; ++t) {
+        run_par("poly_roots_many", &bench_poly_roots_many, BENCH_POINTS / 8, threads[t], BENCH_POINTS / 8);
+    }
+    for (unsigned long isa = 0; isa < ALEX_ISA_COUNT; ++isa) {
+        if (alex_isa_supported((unsigned int) isa))
+            run("poly_eval_many_isa", &bench_poly_eval_many_isa, isa, BENCH_POINTS);
+    }
+    run("spoly_eval", &bench_spoly_eval, 100000, BENCH_SPARSE_POINTS);
+    run("spoly_eval_dense", &bench_spoly_eval_dense, 100000, BENCH_SPARSE_POINTS);
+    run("poly_each_eval", &bench_poly_each_eval, BENCH_BATCH, BENCH_BATCH);
+    run("poly_batch_eval", &bench_poly_batch_eval, BENCH_BATCH, BENCH_BATCH);
+    run("poly_batch_integ_range", &bench_poly_batch_integ_range, BENCH_BATCH, BENCH_BATCH);
+    for (unsigned long digits = 6; digits <= 12; digits += 3) {
+        run("approx_build", &bench_approx_build, digits, 1);
+        run("approx_eval", &bench_approx_eval, digits, BENCH_POINTS);
+    }
+    for (int t = 0; t < 4; ++t) {
+        run_par("pool_for", &bench_pool_for, 64, threads[t], 64);
+    }
+    run("trap_refine", &bench_trap_refine, 0, 8192);
+    run("trap_refine_memo", &bench_trap_refine, 1, 8192);
+    run("gcd", &bench_gcd, BENCH_PAIRS, BENCH_PAIRS);
+    run("gcd_many", &bench_gcd_many, BENCH_PAIRS, BENCH_PAIRS);
+    run("fact", &bench_fact, 20, 21);
+
+    static const unsigned long mem_sizes[3] = {1UL << 12, 1UL << 20, 1UL << 26};
+    mem = malloc(mem_sizes[2]);
+    if (mem != NULL) {
+        for (int i = 0; i < 3; ++i) {
+            run("mclear", &bench_mclear, mem_sizes[i], mem_sizes[i]);
+            run("mclear_nt", &bench_mclear_nt, mem_sizes[i], mem_sizes[i]);
+        }
+        free(mem);
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        alex_free_poly(polys[i]);
+    }
+    for (unsigned int i = 0; i < BENCH_BATCH; ++i) {
+        alex_free_poly(batch_polys[i]);
+    }
+    free(batch_polys);
+    alex_free_poly_batch(batch);
+    free(range);
+    return 0;
+}
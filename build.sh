@@ -1 +1,80 @@
-gcc test/main.c src/*.c -o atest
\ No newline at end of file
+#!/bin/sh
+#
+# Builds ALEX. Usage:
+#
+#     ./build.sh [test | lib | shared | bench | clean]
+#
+#     test    builds the test program test/main.c into ./atest (default)
+#     lib     builds the static library $BUILD_DIR/libalex.a
+#     shared  builds the shared library $BUILD_DIR/libalex.so
+#     bench   builds the library and the benchmarks into $BUILD_DIR/alex_bench
+#     clean   removes $BUILD_DIR
+#
+# The compiler and flags are taken from the environment, ie.
+#
+#     CC=clang CFLAGS="-O3 -march=native" ./build.sh bench && build/alex_bench --json
+#
+# LTO=1 compiles and links with link-time optimization, such that calls from the benchmarks (or
+# any program linked with -flto against libalex.a) into the library can be inlined. The archive
+# is then built with gcc-ar, set AR=llvm-ar when building with clang. Programs which only need
+# the trivial accessors and single point polynomial evaluation inlined can define ALEX_INLINE
+# instead (see flags.h), which works with any build of the library:
+#
+#     LTO=1 ./build.sh bench
+#     CFLAGS="-O2 -DALEX_INLINE" ./build.sh bench
+
+set -e
+
+CC=${CC:-gcc}
+CFLAGS=${CFLAGS:--O2}
+BUILD_DIR=${BUILD_DIR:-build}
+LIBS="-lm -pthread"
+
+if [ -n "$LTO" ]; then
+    CFLAGS="$CFLAGS -flto"
+    AR=${AR:-gcc-ar}
+else
+    AR=${AR:-ar}
+fi
+
+# compiles src/*.c into $BUILD_DIR/$1 with the extra flags $2
+build_objs() {
+    mkdir -p "$BUILD_DIR/$1"
+    for src in src/*.c; do
+        $CC $CFLAGS $2 -pthread -c "$src" -o "$BUILD_DIR/$1/$(basename "$src" .c).o"
+    done
+}
+
+build_lib() {
+    build_objs obj ""
+    rm -f "$BUILD_DIR/libalex.a"
+    $AR rcs "$BUILD_DIR/libalex.a" "$BUILD_DIR"/obj/*.o
+}
+
+build_shared() {
+    build_objs pic -fPIC
+    $CC $CFLAGS -shared "$BUILD_DIR"/pic/*.o -o "$BUILD_DIR/libalex.so" $LIBS
+}
+
+case "${1:-test}" in
+    test)
+        $CC $CFLAGS test/main.c src/*.c -o atest $LIBS
+        ;;
+    lib)
+        build_lib
+        ;;
+    shared)
+        build_shared
+        ;;
+    bench)
+        build_lib
+        $CC $CFLAGS bench/bench.c "$BUILD_DIR/libalex.a" -o "$BUILD_DIR/alex_bench" $LIBS
+        ;;
+    clean)
+        rm -rf "$BUILD_DIR"
+        ;;
+    *)
+        echo "usage: $0 [test | lib | shared | bench | clean]" >&2
+        exit 1
+        ;;
+esac
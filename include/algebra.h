@@ -31,6 +31,8 @@
  */
 #define _ALEX_ALGEBRA_H
 
+#include <stddef.h>
+
 /**
  * @brief Computes the greatest common divisor (GCD) for two given integers.
  *
@@ -45,30 +47,154 @@
  * since the GCD of two zeros is undefined. As such, the flag @ref ALEX_ALG_INV_OP_FLAG is
  * set to indicate that this is an invalid operation.
  *
+ * **Notes**
+ * - The binary (Stein) algorithm is used: common factors of two are removed with a single
+ *   count-trailing-zeros instruction, after which only subtractions and shifts are needed,
+ *   no divisions.
+ *
  * @param m an integer
  * @param n an integer
  * @return their GCD
  *
- * @see alex_lcm()
+ * @see alex_lcm(), alex_gcdl()
  */
 unsigned int alex_gcd(unsigned int m, unsigned int n);
 
+/**
+ * @brief Reentrant variant of @ref alex_gcd()
+ *
+ * Computes the same value as @ref alex_gcd(), but stores it in `*res` and returns the
+ * flag instead of setting it. This function never accesses the flag.
+ *
+ * @param m an integer
+ * @param n an integer
+ * @param res where the GCD is stored (`0` for the pair \f$(0,0)\f$)
+ * @return @ref ALEX_OK_FLAG or @ref ALEX_ALG_INV_OP_FLAG
+ *
+ * @see alex_gcd()
+ */
+int alex_gcd_r(unsigned int m, unsigned int n, unsigned int *res);
+
 /**
  * @brief Computes the least common multiple (LCM) for two given integers.
  *
  * The integers are required to be unsigned for practicality reasons.
  * Apart from that, all integer pairs are acceptable input, including combinations
- * where either or both integers are `0`.
+ * where either or both integers are `0` (for which the LCM is `0`).
  *
- * As such, the flag @ref ALEX_OK_FLAG is
- * set to indicate that this is an invalid operation.
+ * The LCM is computed as \f$\frac m{\mathrm{gcd}(m,n)}\cdot n\f$, so no intermediate value
+ * exceeds the result. If the result does not fit into an `unsigned int`, `0` is returned and
+ * the flag @ref ALEX_ALG_OVERFLOW_FLAG is set.
  *
  * @param m an integer
  * @param n an integer
  * @return their LCM
  *
- * @see alex_gcd()
+ * @see alex_gcd(), alex_lcml()
  */
 unsigned int alex_lcm(unsigned int m, unsigned int n);
 
+/**
+ * @brief Reentrant variant of @ref alex_lcm()
+ *
+ * Computes the same value as @ref alex_lcm(), but stores it in `*res` and returns the
+ * flag instead of setting it. This function never accesses the flag.
+ *
+ * @param m an integer
+ * @param n an integer
+ * @param res where the LCM is stored
+ * @return @ref ALEX_OK_FLAG or @ref ALEX_ALG_OVERFLOW_FLAG
+ *
+ * @see alex_lcm()
+ */
+int alex_lcm_r(unsigned int m, unsigned int n, unsigned int *res);
+
+/**
+ * @brief Computes the GCD for two given `unsigned long` integers.
+ *
+ * This is the equivalent of @ref alex_gcd() for `unsigned long` types, ie. 64-bit integers
+ * on most platforms.
+ *
+ * @param m an integer
+ * @param n an integer
+ * @return their GCD
+ *
+ * @see alex_gcd()
+ */
+unsigned long alex_gcdl(unsigned long m, unsigned long n);
+
+/**
+ * @brief Reentrant variant of @ref alex_gcdl()
+ *
+ * @param m an integer
+ * @param n an integer
+ * @param res where the GCD is stored (`0` for the pair \f$(0,0)\f$)
+ * @return @ref ALEX_OK_FLAG or @ref ALEX_ALG_INV_OP_FLAG
+ *
+ * @see alex_gcdl()
+ */
+int alex_gcdl_r(unsigned long m, unsigned long n, unsigned long *res);
+
+/**
+ * @brief Computes the LCM for two given `unsigned long` integers.
+ *
+ * This is the equivalent of @ref alex_lcm() for `unsigned long` types.
+ *
+ * @param m an integer
+ * @param n an integer
+ * @return their LCM
+ *
+ * @see alex_lcm()
+ */
+unsigned long alex_lcml(unsigned long m, unsigned long n);
+
+/**
+ * @brief Reentrant variant of @ref alex_lcml()
+ *
+ * @param m an integer
+ * @param n an integer
+ * @param res where the LCM is stored
+ * @return @ref ALEX_OK_FLAG or @ref ALEX_ALG_OVERFLOW_FLAG
+ *
+ * @see alex_lcml()
+ */
+int alex_lcml_r(unsigned long m, unsigned long n, unsigned long *res);
+
+/**
+ * @brief Computes the element-wise GCD of two arrays
+ *
+ * Stores \f$\mathrm{gcd}(a_i, b_i)\f$ in `out[i]` for each of the `n` pairs, eg. to reduce a
+ * buffer of fractions. `out` may be the same array as `a` or `b`.
+ *
+ * Pairs \f$(0,0)\f$ yield `0` as for @ref alex_gcd(). This function never accesses the flag,
+ * nor does it check anything per element: if any of the pairs was \f$(0,0)\f$, this is
+ * reported through the return value only once all of them have been computed.
+ *
+ * @param a the first operands
+ * @param b the second operands
+ * @param out where the `n` GCDs are stored
+ * @param n the number of pairs
+ * @return @ref ALEX_OK_FLAG or @ref ALEX_ALG_INV_OP_FLAG
+ *
+ * @see alex_gcdl()
+ */
+int alex_gcd_many(const unsigned long *a, const unsigned long *b, unsigned long *out, size_t n);
+
+/**
+ * @brief Computes the LCM of all the elements of an array
+ *
+ * Stores \f$\mathrm{lcm}(a_0, a_1, ..., a_{n-1})\f$ in `*res`, which is `1` for an empty
+ * array and `0` if any of the elements is `0`. If the result does not fit into an
+ * `unsigned long`, `*res` is set to `0` and @ref ALEX_ALG_OVERFLOW_FLAG is returned.
+ * This function never accesses the flag.
+ *
+ * @param a the array
+ * @param n the number of elements
+ * @param res where the LCM is stored
+ * @return @ref ALEX_OK_FLAG or @ref ALEX_ALG_OVERFLOW_FLAG
+ *
+ * @see alex_lcml()
+ */
+int alex_lcm_reduce(const unsigned long *a, size_t n, unsigned long *res);
+
 #endif
@@ -0,0 +1,322 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/**
+ * @file approx.h
+ * @author Lorenzo Calza
+ * @date 14 Oct 2026
+ * @brief Header file containing the declarations for piecewise polynomial approximation
+ *
+ * An @ref alex_approx is a cheap surrogate for an expensive real function on a given range:
+ * the function is sampled once, on each of a set of subintervals, at the Chebyshev points, and
+ * replaced by its interpolating polynomial. Subintervals whose Chebyshev series does not decay
+ * below the requested tolerance are bisected. The surrogate is then evaluated, integrated and
+ * differentiated through the regular @ref alex_poly routines, without any further call to the
+ * original function.
+ *
+ * **Example**
+ *
+ *     alex_approx *a = alex_make_approx(&expensive, range, 1e-10);
+ *     double y = alex_approx_eval(a, 0.5);
+ *     double area = alex_approx_integ_range(a, range);
+ *     double root;
+ *     alex_root_brent_r(alex_approx_closure(a), range, 1e-12, ALEX_DEFAULT_ROOT_MAXITER, NULL, &root);
+ *     alex_free_approx(a);
+ *
+ * **Notes**
+ * - The error is estimated from the size of the trailing Chebyshev coefficients, which is reliable
+ *   for smooth functions. Functions with kinks or jumps are resolved by bisecting down to the
+ *   discontinuity, which may exhaust the maximum number of pieces.
+ */
+
+#ifndef _ALEX_APPROX_H
+/**
+ * @brief Include guard for this file
+ */
+#define _ALEX_APPROX_H
+
+#include <stddef.h>
+
+#include "func.h"
+#include "poly.h"
+
+/**
+ * @brief Default degree of the Chebyshev interpolants of the pieces
+ *
+ * @see alex_make_approx()
+ */
+#define ALEX_DEFAULT_APPROX_DEG 12u
+
+/**
+ * @brief Maximum degree of the interpolants of the pieces
+ *
+ * The pieces are stored in the monomial basis of their local variable \f$t\in[-1,1]\f$, whose
+ * coefficients grow like \f$2^{deg}\f$ times the Chebyshev coefficients. Higher degrees would lose
+ * too many digits to cancellation.
+ */
+#define ALEX_APPROX_MAX_DEG 24u
+
+/**
+ * @brief Default maximum number of pieces
+ *
+ * @see alex_make_approx()
+ */
+#define ALEX_DEFAULT_APPROX_PIECES 1024u
+
+/**
+ * @brief Represents a piecewise polynomial approximation of a real function
+ *
+ * The range \f$[a,b]\f$ is split at `breaks[0] = a < breaks[1] < ... < breaks[npieces] = b`. On the `k`-th
+ * piece, the function is approximated by `pieces[k]` in the local variable
+ * \f$t=(x-c_k)/h_k\in[-1,1]\f$, where \f$c_k\f$ and \f$h_k\f$ are the center and the half width of the
+ * piece. The struct, the breaks and the pieces live in a single memory block.
+ *
+ * **Notes**
+ * - The pieces must neither be modified nor passed to @ref alex_free_poly(). Use @ref alex_free_approx().
+ *
+ * @see alex_make_approx(), alex_free_approx(), alex_approx_eval()
+ */
+typedef struct {
+    /**
+     * @brief The number of pieces
+     */
+    unsigned int npieces;
+    /**
+     * @brief The number of evaluations of the original function spent on the construction
+     */
+    unsigned long nevals;
+    /**
+     * @brief The `npieces + 1` boundaries of the pieces, in increasing order
+     */
+    double *breaks;
+    /**
+     * @brief The `npieces` polynomials, each in the local variable of its piece
+     */
+    alex_poly *pieces;
+} alex_approx;
+
+/**
+ * @brief Approximates a real function on a range up to a given tolerance
+ *
+ * Builds the approximation with pieces of degree @ref ALEX_DEFAULT_APPROX_DEG and at most
+ * @ref ALEX_DEFAULT_APPROX_PIECES pieces, see @ref alex_make_approx_r().
+ *
+ * The flag is set to @ref ALEX_OK_FLAG, to @ref ALEX_APPROX_TOL_FLAG if the tolerance was not met (the
+ * approximation is returned nonetheless) or to @ref ALEX_INV_PARAM_FLAG or @ref ALEX_BAD_ALLOC_FLAG, in
+ * which case `NULL` is returned.
+ *
+ * @param f the function to approximate
+ * @param range the range, of non-zero length
+ * @param tol the absolute tolerance
+ * @return the approximation, to be freed with @ref alex_free_approx()
+ *
+ * @see alex_make_approx_r(), alex_free_approx()
+ */
+alex_approx *alex_make_approx(alex_func_1d f, alex_range *range, double tol);
+
+/**
+ * @brief Reentrant variant of @ref alex_make_approx()
+ *
+ * Starting from the whole range, the function is sampled on each subinterval at the `deg + 1`
+ * Chebyshev points \f$\cos(\pi j/deg)\f$ (mapped to the subinterval) and its Chebyshev coefficients
+ * \f$c_0,...,c_{deg}\f$ are computed. If \f$|c_{deg-1}|+|c_{deg}|\leq tol/2\f$, the subinterval becomes a
+ * piece, with the trailing coefficients whose sum stays below \f$tol/2\f$ removed; otherwise it is
+ * bisected. When `maxpieces` pieces are reached, the remaining subintervals are kept as they are.
+ *
+ * This function never accesses the flag.
+ *
+ * @param f the @ref alex_closure_1d representing the function to approximate
+ * @param range the range, of non-zero length
+ * @param tol the absolute tolerance (positive)
+ * @param deg the degree of the interpolants, from `1` to @ref ALEX_APPROX_MAX_DEG
+ * @param maxpieces the maximum number of pieces (positive)
+ * @param res where the approximation is stored (`NULL` on failure)
+ *
+ * @returns @ref ALEX_OK_FLAG, @ref ALEX_APPROX_TOL_FLAG, @ref ALEX_INV_PARAM_FLAG or @ref ALEX_BAD_ALLOC_FLAG
+ * @see alex_make_approx()
+ */
+int alex_make_approx_r(alex_closure_1d f, alex_range *range, double tol, unsigned int deg,
+        unsigned int maxpieces, alex_approx **res);
+
+/**
+ * @brief Frees an approximation
+ *
+ * The flag is set to @ref ALEX_INV_PARAM_FLAG if `approx` is `NULL` and to @ref ALEX_OK_FLAG otherwise.
+ *
+ * @param approx the approximation
+ *
+ * @see alex_make_approx()
+ */
+void alex_free_approx(alex_approx *approx);
+
+/**
+ * @brief Evaluates an approximation at a given point
+ *
+ * The piece containing `x` is looked up by bisection and evaluated with @ref alex_poly_eval_r().
+ * Outside of the range, the first or last piece is extrapolated and the flag @ref ALEX_INV_PARAM_FLAG
+ * is set.
+ *
+ * @param approx the approximation
+ * @param x the argument
+ * @return the approximated function value
+ *
+ * @see alex_approx_eval_r(), alex_approx_eval_many()
+ */
+double alex_approx_eval(alex_approx *approx, double x);
+
+/**
+ * @brief Reentrant variant of @ref alex_approx_eval()
+ *
+ * This function never accesses the flag.
+ *
+ * @param approx the approximation
+ * @param x the argument
+ * @param res where the approximated function value is stored (`0` if `approx` is `NULL`)
+ * @returns @ref ALEX_OK_FLAG, or @ref ALEX_INV_PARAM_FLAG if `approx` is `NULL` or `x` out of range
+ *
+ * @see alex_approx_eval()
+ */
+int alex_approx_eval_r(alex_approx *approx, double x, double *res);
+
+/**
+ * @brief Evaluates an approximation at many points
+ *
+ * Computes the same values as @ref alex_approx_eval(). The piece of the previous point is tried
+ * first, as such sorted points are looked up in constant time. The flag is set like by
+ * @ref alex_approx_eval(), for any of the points.
+ *
+ * @param approx the approximation
+ * @param xs the `n` arguments
+ * @param out where the `n` function values are stored (may be `xs`)
+ * @param n the number of points
+ *
+ * @see alex_approx_eval_many_r(), alex_approx_vclosure()
+ */
+void alex_approx_eval_many(alex_approx *approx, const double *xs, double *out, size_t n);
+
+/**
+ * @brief Reentrant variant of @ref alex_approx_eval_many()
+ *
+ * This function never accesses the flag.
+ *
+ * @param approx the approximation
+ * @param xs the `n` arguments
+ * @param out where the `n` function values are stored (may be `xs`)
+ * @param n the number of points
+ * @returns @ref ALEX_OK_FLAG, or @ref ALEX_INV_PARAM_FLAG if an argument is `NULL` or a point out of range
+ *
+ * @see alex_approx_eval_many()
+ */
+int alex_approx_eval_many_r(alex_approx *approx, const double *xs, double *out, size_t n);
+
+/**
+ * @brief Wraps an approximation into a closure
+ *
+ * The closure may be passed to the integration and root-finding routines in lieu of the original
+ * function. `approx` must outlive any use of the closure.
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @param approx the approximation
+ * @return the closure
+ *
+ * @see alex_approx_vclosure()
+ */
+alex_closure_1d alex_approx_closure(alex_approx *approx);
+
+/**
+ * @brief Wraps an approximation into a vectorized closure
+ *
+ * The closure evaluates blocks of points with @ref alex_approx_eval_many_r(). `approx` must outlive
+ * any use of the closure.
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @param approx the approximation
+ * @return the vectorized closure
+ *
+ * @see alex_approx_closure()
+ */
+alex_vclosure_1d alex_approx_vclosure(alex_approx *approx);
+
+/**
+ * @brief Integrates an approximation over a range
+ *
+ * Adds up the exact integrals of the pieces over their intersections with `range`, computed with
+ * @ref alex_poly_integ_range_r().
+ *
+ * The flag is set to @ref ALEX_INV_PARAM_FLAG if an argument is `NULL` or `range` is not contained in the
+ * range of the approximation (`0` is returned) and to @ref ALEX_OK_FLAG otherwise.
+ *
+ * @param approx the approximation
+ * @param range the integration range
+ * @return the integral
+ *
+ * @see alex_approx_integ_range_r()
+ */
+double alex_approx_integ_range(alex_approx *approx, alex_range *range);
+
+/**
+ * @brief Reentrant variant of @ref alex_approx_integ_range()
+ *
+ * This function never accesses the flag.
+ *
+ * @param approx the approximation
+ * @param range the integration range
+ * @param res where the integral is stored (`0` on failure)
+ * @returns @ref ALEX_OK_FLAG or @ref ALEX_INV_PARAM_FLAG
+ *
+ * @see alex_approx_integ_range()
+ */
+int alex_approx_integ_range_r(alex_approx *approx, alex_range *range, double *res);
+
+/**
+ * @brief Differentiates an approximation
+ *
+ * Returns a new approximation with the same pieces, each replaced by its derivative with respect
+ * to \f$x\f$. Since differentiation amplifies the error, the derivative is less accurate than the
+ * approximation, by a factor growing like \f$deg^2/h_k\f$.
+ *
+ * The flag is set to @ref ALEX_INV_PARAM_FLAG if `approx` is `NULL`, to @ref ALEX_BAD_ALLOC_FLAG if the
+ * allocation failed (in both cases `NULL` is returned) and to @ref ALEX_OK_FLAG otherwise.
+ *
+ * @param approx the approximation
+ * @return the derivative, to be freed with @ref alex_free_approx()
+ *
+ * @see alex_approx_diff_r()
+ */
+alex_approx *alex_approx_diff(alex_approx *approx);
+
+/**
+ * @brief Reentrant variant of @ref alex_approx_diff()
+ *
+ * This function never accesses the flag.
+ *
+ * @param approx the approximation
+ * @param res where the derivative is stored (`NULL` on failure)
+ * @returns @ref ALEX_OK_FLAG, @ref ALEX_INV_PARAM_FLAG or @ref ALEX_BAD_ALLOC_FLAG
+ *
+ * @see alex_approx_diff()
+ */
+int alex_approx_diff_r(alex_approx *approx, alex_approx **res);
+
+#endif
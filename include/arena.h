@@ -0,0 +1,127 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/**
+ * @file arena.h
+ * @author Lorenzo Calza
+ * @date 14 Oct 2026
+ * @brief Header file containing the declarations for the arena allocator
+ *
+ * An arena hands out memory from large chunks by advancing a cursor, and releases everything
+ * it has handed out in a single operation. This is much cheaper than a `malloc()`/`free()`
+ * pair per object whenever many short-lived objects (such as intermediate polynomials, see
+ * @ref alex_make_poly_arena()) die at the same time.
+ *
+ * **Example**
+ *
+ *     alex_arena *arena = alex_make_arena(0);
+ *     for (int i = 0; i < N; ++i) {
+ *         alex_poly *p = alex_make_poly_arena(deg, coeffs[i], arena);
+ *         alex_poly *dp = alex_poly_diff_arena(p, arena);
+ *         // ...
+ *         alex_arena_reset(arena); // p and dp are gone, the memory is kept for the next iteration
+ *     }
+ *     alex_free_arena(arena);
+ *
+ * **Notes**
+ * - Memory handed out by an arena must **not** be passed to `free()`, nor to @ref alex_free_poly().
+ * - An arena is not thread-safe. Use one arena per thread.
+ */
+
+#include <stddef.h>
+
+#ifndef _ALEX_ARENA_H
+/**
+ * @brief Include guard for this file
+ */
+#define _ALEX_ARENA_H
+
+/**
+ * @brief Default size in bytes of the chunks allocated by an arena
+ *
+ * @see alex_make_arena()
+ */
+#define ALEX_DEFAULT_ARENA_CHUNK 65536ul
+
+/**
+ * @brief Alignment in bytes of every block handed out by @ref alex_arena_alloc()
+ */
+#define ALEX_ARENA_ALIGN 16ul
+
+/**
+ * @brief Opaque type representing an arena allocator
+ *
+ * @see alex_make_arena(), alex_free_arena(), alex_arena_alloc(), alex_arena_reset()
+ */
+typedef struct alex_arena alex_arena;
+
+/**
+ * @brief Constructs an arena and returns a pointer to it
+ *
+ * The arena allocates its memory in chunks of (at least) `chunk_size` bytes. Requests larger than
+ * that get a chunk of their own. No memory is allocated until the first call to @ref alex_arena_alloc().
+ *
+ * If the allocation fails, `NULL` is returned and the flag @ref ALEX_BAD_ALLOC_FLAG is set.
+ *
+ * @param chunk_size the chunk size in bytes, or `0` for @ref ALEX_DEFAULT_ARENA_CHUNK
+ * @return the arena
+ *
+ * @see alex_free_arena(), alex_arena_alloc()
+ */
+alex_arena *alex_make_arena(size_t chunk_size);
+
+/**
+ * @brief Frees the arena and all memory handed out by it
+ *
+ * @param arena the arena
+ *
+ * @see alex_make_arena(), alex_arena_reset()
+ */
+void alex_free_arena(alex_arena *arena);
+
+/**
+ * @brief Allocates a block of memory from the arena
+ *
+ * The block is aligned to @ref ALEX_ARENA_ALIGN bytes and its contents are not initialized.
+ * It stays valid until the next call to @ref alex_arena_reset() or @ref alex_free_arena().
+ *
+ * If there is not enough memory left, `NULL` is returned and the flag @ref ALEX_BAD_ALLOC_FLAG
+ * is set.
+ *
+ * @param arena the arena
+ * @param size the size of the block in bytes
+ * @return the block
+ *
+ * @see alex_make_arena(), alex_arena_reset()
+ */
+void *alex_arena_alloc(alex_arena *arena, size_t size);
+
+/**
+ * @brief Releases all blocks handed out by the arena at once
+ *
+ * The chunks are kept and recycled by subsequent calls to @ref alex_arena_alloc(), as such
+ * an arena which is reset periodically reaches a steady state in which it no longer
+ * allocates any memory.
+ *
+ * @param arena the arena
+ *
+ * @see alex_arena_alloc(), alex_free_arena()
+ */
+void alex_arena_reset(alex_arena *arena);
+
+#endif
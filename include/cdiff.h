@@ -0,0 +1,105 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * @file cdiff.h
+ * @author Lorenzo Calza
+ * @date 14 Oct 2026
+ * @brief Header file containing the declarations for complex-step differentiation
+ *
+ * The complex-step method (see @ref alex_diff_complex()) differentiates functions given by their
+ * complex extension. It lives in a header of its own, such that only the programs which use it include
+ * `<complex.h>`, which defines the macros `I` and `complex` (and is not valid C++).
+ */
+
+#ifndef _ALEX_CDIFF_H
+/**
+ * @brief Include guard for this file
+ */
+#define _ALEX_CDIFF_H
+
+#include <complex.h>
+
+/**
+ * @brief Relative imaginary step used by @ref alex_diff_complex()
+ *
+ * Since the complex step involves no subtraction, it can be arbitrarily small.
+ */
+#define ALEX_COMPLEX_STEP 1e-20
+
+/**
+ * @brief Function \f$f:\mathbb{C}\rightarrow\mathbb{C}\f$ for complex-step differentiation
+ *
+ * @see alex_diff_complex()
+ */
+typedef double complex (*alex_cfunc_1d)(double complex z);
+
+/**
+ * @brief Function \f$f:\mathbb{C}\rightarrow\mathbb{C}\f$ with a context pointer
+ *
+ * This is the equivalent of @ref alex_ctxfunc_1d for complex functions.
+ *
+ * @see alex_diff_complex_r()
+ */
+typedef double complex (*alex_ctxcfunc_1d)(double complex z, void *ctx);
+
+/**
+ * @brief Computes the slope of a function with the complex-step method
+ *
+ * If \f$f\f$ is real for real arguments and analytic (ie. composed of arithmetic and the
+ * complex versions of the elementary functions, such as `cexp()`), then
+ *
+ * \f$f'(x)\approx\frac{\mathrm{Im}\,f(x+ih)}h\f$
+ *
+ * with an error of \f$O(h^2)\f$. Since no difference is involved, there is no cancellation and
+ * \f$h\f$ can be chosen as small as @ref ALEX_COMPLEX_STEP, so the result is accurate to full
+ * double precision at the cost of a single (complex) function call.
+ *
+ * **Notes**
+ * - Functions that use `fabs()`, comparisons, or conjugation of their argument are not analytic
+ *   and yield wrong results.
+ *
+ * Sets the flag @ref ALEX_OK_FLAG.
+ *
+ * @param f the complex extension of the function to differentiate
+ * @param x where to differentiate
+ * @return the slope at x
+ *
+ * @see alex_diff_complex_r()
+ */
+double alex_diff_complex(alex_cfunc_1d f, double x);
+
+/**
+ * @brief Reentrant variant of @ref alex_diff_complex()
+ *
+ * Computes the same value as @ref alex_diff_complex(), but takes a function with a context
+ * pointer, stores the slope in `*res` and returns the flag instead of setting it. This function
+ * never accesses the flag.
+ *
+ * @param f the complex extension of the function to differentiate
+ * @param ctx the context pointer passed to `f`
+ * @param x where to differentiate
+ * @param res where the slope at x is stored
+ * @return @ref ALEX_OK_FLAG
+ *
+ * @see alex_diff_complex()
+ */
+int alex_diff_complex_r(alex_ctxcfunc_1d f, void *ctx, double x, double *res);
+
+#endif
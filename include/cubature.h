@@ -0,0 +1,316 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/**
+ * @file cubature.h
+ * @author Lorenzo Calza
+ * @date 14 Oct 2026
+ * @brief Header file containing the declarations for multi-dimensional integration
+ *
+ * The routines declared in this header file approximate the integral of a real function
+ * \f$f:\mathbb{R}^d\rightarrow\mathbb{R}\f$ over a box \f$[a_0,b_0]\times...\times[a_{d-1},b_{d-1}]\f$,
+ * given as an array of `d` pointers to @ref alex_range.
+ *
+ * - The tensor-product Gauss-Legendre rule (@ref alex_integrate_gauss_nd_r()) takes \f$n^d\f$
+ *   points and is by far the most accurate choice for smooth integrands in low dimensions.
+ * - Quasi-Monte Carlo (@ref alex_integrate_qmc_r()) samples a low-discrepancy sequence, whose
+ *   error decreases almost like \f$1/N\f$ for \f$N\f$ points irrespective of \f$d\f$.
+ * - Plain Monte Carlo (@ref alex_integrate_mc_r()) makes no assumption on the integrand, its
+ *   error decreases like \f$1/\sqrt N\f$.
+ *
+ * All of them evaluate the integrand through an @ref alex_vclosure_nd, on blocks of up to
+ * @ref ALEX_VEC_BLOCK points, and distribute the blocks over several threads (see
+ * @ref alex_integ_ctx). As with @ref alex_integrate_trap_par(), the points are partitioned into
+ * chunks which only depend on their number, as such the results do not depend on the number of
+ * threads.
+ *
+ * **Example**
+ *
+ *     void gaussian(unsigned int dim, const double *x, double *y, size_t n, void *ctx) {
+ *         for (size_t i = 0; i < n; ++i, x += dim) {
+ *             double r2 = 0;
+ *             for (unsigned int j = 0; j < dim; ++j)
+ *                 r2 += x[j] * x[j];
+ *             y[i] = exp(-r2);
+ *         }
+ *     }
+ *     // ...
+ *     alex_range *unit = alex_make_range(0, 1), *box[6] = {unit, unit, unit, unit, unit, unit};
+ *     alex_cubature_info info;
+ *     double res;
+ *     alex_integrate_qmc_r(alex_make_vclosure_nd(&gaussian, NULL), 6, box, ALEX_QMC_SOBOL,
+ *             1ul << 20, 42, NULL, &info, &res);
+ */
+
+#ifndef _ALEX_CUBATURE_H
+/**
+ * @brief Include guard for this file
+ */
+#define _ALEX_CUBATURE_H
+
+#include <stddef.h>
+
+#include "func.h"
+#include "integrate.h"
+
+/**
+ * @brief Number of independently randomized copies of the point set used by the quasi-Monte Carlo routines
+ *
+ * Each copy is shifted by its own random vector, the spread of the estimates of the copies yields
+ * the error estimate of @ref alex_integrate_qmc_r().
+ */
+#define ALEX_QMC_REPLICAS 8u
+
+/**
+ * @brief Seed of the classic quasi-Monte Carlo and Monte Carlo routines
+ *
+ * @see alex_integrate_qmc(), alex_integrate_mc()
+ */
+#define ALEX_DEFAULT_CUBATURE_SEED 0x2545f4914f6cdd1dul
+
+/**
+ * @brief Low-discrepancy sequences of the quasi-Monte Carlo routines
+ *
+ * @see alex_qmc_points(), alex_integrate_qmc_r()
+ */
+typedef enum {
+    /**
+     * @brief The Sobol sequence, with the direction numbers of Joe and Kuo (recommended)
+     */
+    ALEX_QMC_SOBOL,
+    /**
+     * @brief The Halton sequence, based on the first @ref ALEX_MAX_DIM primes
+     *
+     * Its quality degrades faster with the dimension than that of the Sobol sequence.
+     */
+    ALEX_QMC_HALTON
+} alex_qmc_seq;
+
+/**
+ * @brief Information on the outcome of a sampling integration
+ *
+ * @see alex_integrate_qmc_r(), alex_integrate_mc_r()
+ */
+typedef struct {
+    /**
+     * @brief The estimated standard error of the returned integral
+     */
+    double abserr;
+    /**
+     * @brief The number of evaluations of the integrand
+     */
+    unsigned long nevals;
+} alex_cubature_info;
+
+/**
+ * @brief Integrates a vectorized function over a box with the tensor-product Gauss-Legendre rule
+ *
+ * Every axis is sampled at the `n` nodes of the Gauss-Legendre rule of order `n` (see
+ * @ref alex_gauss_legendre()), the integrand is evaluated at all \f$n^d\f$ combinations and
+ * the function values are weighted with the products of the weights. The rule is exact for
+ * polynomials of degree up to \f$2n-1\f$ in each variable.
+ *
+ * **Notes**
+ * - `f` is called concurrently from several threads, as such it must be thread-safe.
+ * - This function never accesses the flag.
+ *
+ * @param f the @ref alex_vclosure_nd representing the integrand
+ * @param dim the dimension \f$d\f$, from `1` to @ref ALEX_MAX_DIM
+ * @param box the `dim` integration intervals
+ * @param n the order of the rule on each axis, from `1` to @ref ALEX_GAUSS_MAX_ORDER
+ * @param ctx the settings of this call (`NULL` for the defaults, ie. one thread per processor)
+ * @param res where the approximated integral is stored (`0` on failure)
+ *
+ * @returns @ref ALEX_OK_FLAG, @ref ALEX_INV_PARAM_FLAG if an argument is out of range or if
+ * \f$n^d\f$ exceeds the range of `unsigned long`, or @ref ALEX_BAD_ALLOC_FLAG
+ * @see alex_integrate_gauss_2d(), alex_integrate_gauss_3d(), alex_integrate_gauss_nd()
+ */
+int alex_integrate_gauss_nd_r(alex_vclosure_nd f, unsigned int dim, alex_range *box[], unsigned int n,
+        const alex_integ_ctx *ctx, double *res);
+
+/**
+ * @brief Integrates a function of two variables with the tensor-product Gauss-Legendre rule
+ *
+ * Computes the same approximation as @ref alex_integrate_gauss_nd_r() on a single thread,
+ * setting the flag accordingly.
+ *
+ * @param f the integrand
+ * @param rangeX the integration interval of the first variable
+ * @param rangeY the integration interval of the second variable
+ * @param n the order of the rule on each axis
+ * @return the approximated integral
+ *
+ * @see alex_integrate_gauss_nd_r(), alex_integrate_gauss()
+ */
+double alex_integrate_gauss_2d(alex_func_2d f, alex_range *rangeX, alex_range *rangeY, unsigned int n);
+
+/**
+ * @brief Integrates a function of three variables with the tensor-product Gauss-Legendre rule
+ *
+ * Computes the same approximation as @ref alex_integrate_gauss_nd_r() on a single thread,
+ * setting the flag accordingly.
+ *
+ * @param f the integrand
+ * @param rangeX the integration interval of the first variable
+ * @param rangeY the integration interval of the second variable
+ * @param rangeZ the integration interval of the third variable
+ * @param n the order of the rule on each axis
+ * @return the approximated integral
+ *
+ * @see alex_integrate_gauss_nd_r(), alex_integrate_gauss()
+ */
+double alex_integrate_gauss_3d(alex_func_3d f, alex_range *rangeX, alex_range *rangeY, alex_range *rangeZ,
+        unsigned int n);
+
+/**
+ * @brief Integrates a function of `dim` variables with the tensor-product Gauss-Legendre rule
+ *
+ * Computes the same approximation as @ref alex_integrate_gauss_nd_r() on a single thread,
+ * setting the flag accordingly.
+ *
+ * @param f the integrand
+ * @param dim the dimension, from `1` to @ref ALEX_MAX_DIM
+ * @param box the `dim` integration intervals
+ * @param n the order of the rule on each axis
+ * @return the approximated integral
+ *
+ * @see alex_integrate_gauss_nd_r(), alex_func_nd_vclosure()
+ */
+double alex_integrate_gauss_nd(alex_func_nd f, int dim, alex_range *box[], unsigned int n);
+
+/**
+ * @brief Generates the points of a low-discrepancy sequence
+ *
+ * Stores the points `first, ..., first + n - 1` of the sequence `seq` in the unit cube
+ * \f$[0,1)^d\f$ in `x`, point after point (ie. `x[i * dim + j]` is the `j`-th coordinate of the
+ * `i`-th point). The Sobol points are generated in Gray code order, the Halton sequence starts
+ * at its first non-zero point. Any point only depends on its index, such that a sequence may be
+ * generated in pieces.
+ *
+ * **Notes**
+ * - This function never accesses the flag.
+ *
+ * @param seq the sequence
+ * @param dim the dimension \f$d\f$, from `1` to @ref ALEX_MAX_DIM
+ * @param first the index of the first point (the Sobol sequence has \f$2^{32}\f$ points)
+ * @param n the number of points
+ * @param x the buffer receiving the `n * dim` coordinates
+ *
+ * @returns @ref ALEX_OK_FLAG, or @ref ALEX_INV_PARAM_FLAG if an argument is out of range
+ * @see alex_integrate_qmc_r()
+ */
+int alex_qmc_points(alex_qmc_seq seq, unsigned int dim, unsigned long first, size_t n, double *x);
+
+/**
+ * @brief Integrates a vectorized function over a box with randomized quasi-Monte Carlo
+ *
+ * The `npoints` evaluations are split among @ref ALEX_QMC_REPLICAS copies of the first
+ * `npoints / ALEX_QMC_REPLICAS` points of the sequence `seq`, each shifted by a random vector:
+ * the Sobol points undergo a digital shift (their binary digits are XORed with those of the
+ * vector), which preserves their stratification, the Halton points are shifted modulo 1
+ * (Cranley-Patterson rotation). The integral is the mean of the estimates of the copies,
+ * whose standard error is reported in `info->abserr`. The random shifts only depend on `seed`.
+ *
+ * **Notes**
+ * - For the Sobol sequence, powers of two for `npoints / ALEX_QMC_REPLICAS` work best.
+ * - `f` is called concurrently from several threads, as such it must be thread-safe.
+ * - This function never accesses the flag.
+ *
+ * @param f the @ref alex_vclosure_nd representing the integrand
+ * @param dim the dimension \f$d\f$, from `1` to @ref ALEX_MAX_DIM
+ * @param box the `dim` integration intervals
+ * @param seq the low-discrepancy sequence
+ * @param npoints the number of evaluations of `f`, at least @ref ALEX_QMC_REPLICAS
+ * @param seed the seed of the random shifts
+ * @param ctx the settings of this call (`NULL` for the defaults, ie. one thread per processor)
+ * @param info where the error estimate and the number of evaluations are stored (may be `NULL`)
+ * @param res where the approximated integral is stored (`0` on failure)
+ *
+ * @returns @ref ALEX_OK_FLAG, @ref ALEX_INV_PARAM_FLAG if an argument is out of range or
+ * @ref ALEX_BAD_ALLOC_FLAG
+ * @see alex_integrate_qmc(), alex_qmc_points(), alex_integrate_mc_r()
+ */
+int alex_integrate_qmc_r(alex_vclosure_nd f, unsigned int dim, alex_range *box[], alex_qmc_seq seq,
+        unsigned long npoints, unsigned long seed, const alex_integ_ctx *ctx, alex_cubature_info *info,
+        double *res);
+
+/**
+ * @brief Integrates a function of `dim` variables with randomized quasi-Monte Carlo
+ *
+ * Computes the same approximation as @ref alex_integrate_qmc_r() with the Sobol sequence and the
+ * seed @ref ALEX_DEFAULT_CUBATURE_SEED on a single thread, setting the flag accordingly.
+ *
+ * @param f the integrand
+ * @param dim the dimension, from `1` to @ref ALEX_MAX_DIM
+ * @param box the `dim` integration intervals
+ * @param npoints the number of evaluations of `f`
+ * @param info where the error estimate and the number of evaluations are stored (may be `NULL`)
+ * @return the approximated integral
+ *
+ * @see alex_integrate_qmc_r()
+ */
+double alex_integrate_qmc(alex_func_nd f, int dim, alex_range *box[], unsigned long npoints,
+        alex_cubature_info *info);
+
+/**
+ * @brief Integrates a vectorized function over a box with plain Monte Carlo
+ *
+ * The integrand is evaluated at `npoints` uniformly distributed random points, the integral is
+ * their mean times the volume of the box and `info->abserr` its standard error. Every chunk of
+ * points draws from its own stream of the xoshiro256** generator, seeded from `seed` and the
+ * index of the chunk, as such the result only depends on `seed` and `npoints`.
+ *
+ * **Notes**
+ * - `f` is called concurrently from several threads, as such it must be thread-safe.
+ * - This function never accesses the flag.
+ *
+ * @param f the @ref alex_vclosure_nd representing the integrand
+ * @param dim the dimension \f$d\f$, from `1` to @ref ALEX_MAX_DIM
+ * @param box the `dim` integration intervals
+ * @param npoints the number of evaluations of `f`, at least `2`
+ * @param seed the seed of the random streams
+ * @param ctx the settings of this call (`NULL` for the defaults, ie. one thread per processor)
+ * @param info where the error estimate and the number of evaluations are stored (may be `NULL`)
+ * @param res where the approximated integral is stored (`0` on failure)
+ *
+ * @returns @ref ALEX_OK_FLAG, @ref ALEX_INV_PARAM_FLAG if an argument is out of range or
+ * @ref ALEX_BAD_ALLOC_FLAG
+ * @see alex_integrate_mc(), alex_integrate_qmc_r()
+ */
+int alex_integrate_mc_r(alex_vclosure_nd f, unsigned int dim, alex_range *box[], unsigned long npoints,
+        unsigned long seed, const alex_integ_ctx *ctx, alex_cubature_info *info, double *res);
+
+/**
+ * @brief Integrates a function of `dim` variables with plain Monte Carlo
+ *
+ * Computes the same approximation as @ref alex_integrate_mc_r() with the seed
+ * @ref ALEX_DEFAULT_CUBATURE_SEED on a single thread, setting the flag accordingly.
+ *
+ * @param f the integrand
+ * @param dim the dimension, from `1` to @ref ALEX_MAX_DIM
+ * @param box the `dim` integration intervals
+ * @param npoints the number of evaluations of `f`
+ * @param info where the error estimate and the number of evaluations are stored (may be `NULL`)
+ * @return the approximated integral
+ *
+ * @see alex_integrate_mc_r()
+ */
+double alex_integrate_mc(alex_func_nd f, int dim, alex_range *box[], unsigned long npoints,
+        alex_cubature_info *info);
+
+#endif
@@ -31,6 +31,8 @@
  *   and differentiate through each iteration.
  */
 
+#include <stddef.h>
+
 #include "func.h"
 
 #ifndef _ALEX_DIFF_H
@@ -47,6 +49,22 @@
  */
 #define ALEX_DEFAULT_DX 1e-8
 
+/**
+ * @brief Relative step used by @ref alex_diff_central()
+ *
+ * The truncation error of the central difference is \f$O(h^2)\f$ and its rounding error
+ * \f$O(\varepsilon/h)\f$, which balance out at \f$h\approx\varepsilon^{1/3}\f$.
+ */
+#define ALEX_DEFAULT_CENTRAL_DX 6e-6
+
+/**
+ * @brief Relative step used by @ref alex_diff_richardson()
+ *
+ * The truncation error of the extrapolated difference is \f$O(h^4)\f$, which balances out
+ * with the rounding error at \f$h\approx\varepsilon^{1/5}\f$.
+ */
+#define ALEX_DEFAULT_RICHARDSON_DX 1e-3
+
 /**
  * @brief Uses the secant method to determine a root of the function
  *
@@ -81,6 +99,10 @@
  * hundreds, we could get even preciser results at almost no cost, considering a regular computer's
  * computational power.
  *
+ * Each iteration costs a single evaluation of \f$f\f$. The iteration stops early if it hits the root
+ * exactly or if the secant becomes horizontal (\f$f(x_{k})=f(x_{k-1})\f$), as any further step would
+ * divide by zero. See @ref alex_root_brent() for a routine which stops on a tolerance instead.
+ *
  * **Notes**
  *
  * Results will vary from system to system. The above test was conducted on a Windows 10 machine, x86_64, 16GB RAM.
@@ -94,6 +116,23 @@
  */
 double alex_secant_method(alex_func_1d f, alex_range *range, unsigned iterations);
 
+/**
+ * @brief Reentrant variant of @ref alex_secant_method()
+ *
+ * Computes the same value as @ref alex_secant_method(), but takes the function as an
+ * @ref alex_closure_1d, stores the root in `*res` and returns the flag instead of setting it.
+ * This function never accesses the flag.
+ *
+ * @param f the @ref alex_closure_1d representing \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param range the interval which we must search
+ * @param iterations number of iterations
+ * @param res where the approximated root is stored (`0` on failure)
+ * @return @ref ALEX_OK_FLAG, or @ref ALEX_INV_PARAM_FLAG if `iterations` is `0`
+ *
+ * @see alex_secant_method()
+ */
+int alex_secant_method_r(alex_closure_1d f, alex_range *range, unsigned iterations, double *res);
+
 /**
  * @brief Computes slope of a function at a given point
  *
@@ -105,14 +144,134 @@ double alex_secant_method(alex_func_1d f, alex_range *range, unsigned iterations
  * and the routine which called it will have to deal with the consequences. As such, it is
  * up to the user to make sure their @ref alex_func_1d is well-defined.
  *
+ * The forward difference \f$\frac{f(x+h)-f(x)}h\f$ is used, with the step
+ * \f$h=\mathrm dx\cdot\max(|x|,1)\f$. Its error is \f$O(h)\f$, so for the same number of
+ * function calls @ref alex_diff_central() is considerably more accurate.
+ *
  * @param f the function to differentiate
  * @param x where to differentiate
  * @return the slope at x
  *
- * @see alex_set_dx(), alex_get_dx()
+ * @see alex_set_dx(), alex_get_dx(), alex_diff_central(), alex_diff_richardson()
  */
 double alex_diff(alex_func_1d f, double x);
 
+/**
+ * @brief Reentrant variant of @ref alex_diff()
+ *
+ * Computes the same value as @ref alex_diff(), but takes the function as an
+ * @ref alex_closure_1d, stores the slope in `*res` and returns the flag.
+ * Neither this function nor @ref alex_diff() access the flag.
+ *
+ * @param f the @ref alex_closure_1d representing the function to differentiate
+ * @param x where to differentiate
+ * @param res where the slope at x is stored
+ * @return @ref ALEX_OK_FLAG
+ *
+ * @see alex_diff(), alex_set_dx(), alex_get_dx()
+ */
+int alex_diff_r(alex_closure_1d f, double x, double *res);
+
+/**
+ * @brief Computes the slope of a function with a central difference
+ *
+ * Returns \f$\frac{f(x+h)-f(x-h)}{2h}\f$ with \f$h=\mathrm dx\cdot\max(|x|,1)\f$, where
+ * \f$\mathrm dx\f$ is @ref ALEX_DEFAULT_CENTRAL_DX. The error is \f$O(h^2)\f$, which typically
+ * amounts to 10 to 11 correct digits at the cost of two function calls.
+ *
+ * Sets the flag @ref ALEX_OK_FLAG.
+ *
+ * @param f the function to differentiate
+ * @param x where to differentiate
+ * @return the slope at x
+ *
+ * @see alex_diff_central_r(), alex_diff_richardson()
+ */
+double alex_diff_central(alex_func_1d f, double x);
+
+/**
+ * @brief Reentrant variant of @ref alex_diff_central()
+ *
+ * Computes the same value as @ref alex_diff_central() with the relative step `dx` instead of
+ * @ref ALEX_DEFAULT_CENTRAL_DX, stores it in `*res` and returns the flag instead of setting it.
+ * This function never accesses the flag.
+ *
+ * @param f the @ref alex_closure_1d representing the function to differentiate
+ * @param x where to differentiate
+ * @param dx the relative step, must be positive
+ * @param res where the slope at x is stored (`0` on failure)
+ * @return @ref ALEX_OK_FLAG or @ref ALEX_INV_PARAM_FLAG
+ *
+ * @see alex_diff_central()
+ */
+int alex_diff_central_r(alex_closure_1d f, double x, double dx, double *res);
+
+/**
+ * @brief Computes the slope of a function with a Richardson-extrapolated central difference
+ *
+ * With \f$D(h)\f$ the central difference (see @ref alex_diff_central()), this returns
+ * \f$\frac{4D(h/2)-D(h)}3\f$, ie. the five point stencil whose error is \f$O(h^4)\f$. The relative
+ * step is @ref ALEX_DEFAULT_RICHARDSON_DX. For smooth functions, this is accurate to 12 to 13
+ * digits at the cost of four function calls.
+ *
+ * Sets the flag @ref ALEX_OK_FLAG.
+ *
+ * @param f the function to differentiate
+ * @param x where to differentiate
+ * @return the slope at x
+ *
+ * @see alex_diff_richardson_r(), alex_diff_central()
+ */
+double alex_diff_richardson(alex_func_1d f, double x);
+
+/**
+ * @brief Reentrant variant of @ref alex_diff_richardson()
+ *
+ * Computes the same value as @ref alex_diff_richardson() with the relative step `dx` instead
+ * of @ref ALEX_DEFAULT_RICHARDSON_DX, stores it in `*res` and returns the flag instead of
+ * setting it. This function never accesses the flag.
+ *
+ * @param f the @ref alex_closure_1d representing the function to differentiate
+ * @param x where to differentiate
+ * @param dx the relative step, must be positive
+ * @param res where the slope at x is stored (`0` on failure)
+ * @return @ref ALEX_OK_FLAG or @ref ALEX_INV_PARAM_FLAG
+ *
+ * @see alex_diff_richardson()
+ */
+int alex_diff_richardson_r(alex_closure_1d f, double x, double dx, double *res);
+
+/**
+ * @brief Computes the slopes of a function on an evenly spaced grid
+ *
+ * Stores the derivative at \f$x_i = \mathrm{min} + i\cdot\mathrm{spacing}\f$ in `out[i]`,
+ * for \f$i = 0, ..., n - 1\f$, using the fourth order central stencil
+ *
+ * \f$f'(x_i)\approx\frac{f(x_{i-2}) - 8f(x_{i-1}) + 8f(x_{i+1}) - f(x_{i+2})}{12\cdot\mathrm{spacing}}\f$.
+ *
+ * The stencils of neighbouring points overlap, and each value of \f$f\f$ is computed only once:
+ * all \f$n\f$ derivatives take \f$n+4\f$ function evaluations, instead of the \f$4n\f$ of
+ * @ref alex_diff_richardson(). The function is evaluated in blocks of up to
+ * @ref ALEX_VEC_BLOCK points through its @ref alex_vclosure_1d, no memory is allocated.
+ *
+ * **Notes**
+ * - `spacing` is the step of the stencil, so it should be small compared to the scale on which
+ *   \f$f\f$ changes (on the order of @ref ALEX_DEFAULT_RICHARDSON_DX for full accuracy).
+ * - \f$f\f$ is also evaluated at the two grid points beyond either end.
+ *
+ * This function never accesses the flag.
+ *
+ * @param f the @ref alex_vclosure_1d representing the function to differentiate
+ * @param min the first point of the grid
+ * @param spacing the distance between the points, must be positive
+ * @param n the number of points
+ * @param out where the `n` slopes are stored
+ * @return @ref ALEX_OK_FLAG or @ref ALEX_INV_PARAM_FLAG
+ *
+ * @see alex_diff_richardson()
+ */
+int alex_diff_many(alex_vclosure_1d f, double min, double spacing, size_t n, double *out);
+
 /**
  * @brief Sets the `dx`-step for numeric differentiation of functions
  *
@@ -0,0 +1,167 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/**
+ * @file dispatch.h
+ * @author Lorenzo Calza
+ * @date 14 Oct 2026
+ * @brief Header file containing the declarations for the runtime selection of the SIMD kernels
+ *
+ * The hot loops of ALEX (see the list below) are compiled for several instruction sets into the
+ * same library, as such one binary runs the widest kernels available on every machine. The CPU
+ * features are detected once, on the first call to a dispatched routine or to this interface, and
+ * the widest instruction set supported by both the CPU and the build is selected. The selection
+ * can then be queried and forced (eg. to compare kernels or to work around a faulty CPU), either
+ * with @ref alex_set_isa() or by setting the environment variable `ALEX_ISA` to one of the names
+ * returned by @ref alex_isa_name() before the detection.
+ *
+ * The dispatched routines are
+ * - @ref alex_poly_eval_many() and @ref alex_poly_vclosure() (SSE2, AVX2, AVX-512, NEON)
+ * - the @ref alex_poly_batch evaluation, derivation and integration (SSE2, AVX2, AVX-512, NEON)
+ *
+ * All kernels perform the same operations in the same order (without fused multiply-add), as such
+ * the selected instruction set does not change the results. poly.c and polybatch.c disable the
+ * contraction into fused multiply-adds themselves, such that this also holds when the library is
+ * built for an FMA-capable target (eg. with `-march=native`). Only the inline @ref alex_poly_eval()
+ * of `ALEX_INLINE` (see flags.h) is compiled with the caller's flags, and may then differ in the
+ * last bits unless the caller is built with `-ffp-contract=off`.
+ *
+ * **Example**
+ *
+ *     printf("running %s kernels\n", alex_isa_name(alex_get_isa()));
+ *     alex_set_isa(ALEX_ISA_SSE2);
+ *     alex_poly_eval_many(poly, xs, ys, n);  // with the SSE2 kernel
+ *     alex_set_isa(ALEX_ISA_AUTO);
+ */
+
+#ifndef _ALEX_DISPATCH_H
+/**
+ * @brief Include guard for this file
+ */
+#define _ALEX_DISPATCH_H
+
+/**
+ * @brief Portable C kernels, available everywhere
+ */
+#define ALEX_ISA_SCALAR 0u
+
+/**
+ * @brief 128-bit x86 kernels, available on every x86_64 CPU
+ */
+#define ALEX_ISA_SSE2 1u
+
+/**
+ * @brief 256-bit x86 kernels
+ */
+#define ALEX_ISA_AVX2 2u
+
+/**
+ * @brief 512-bit x86 kernels (AVX-512 Foundation)
+ */
+#define ALEX_ISA_AVX512 3u
+
+/**
+ * @brief 128-bit ARM kernels, available on every AArch64 CPU
+ */
+#define ALEX_ISA_NEON 4u
+
+/**
+ * @brief The number of instruction sets, ie. the size of a kernel table indexed by them
+ */
+#define ALEX_ISA_COUNT 5u
+
+/**
+ * @brief Argument of @ref alex_set_isa() restoring the detected instruction set
+ */
+#define ALEX_ISA_AUTO ALEX_ISA_COUNT
+
+/**
+ * @brief Returns the widest instruction set supported by both the CPU and the library build
+ *
+ * The `ALEX_ISA` environment variable is not taken into account.
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @return one of the `ALEX_ISA_*` values
+ *
+ * @see alex_get_isa(), alex_isa_supported()
+ */
+unsigned int alex_isa_detected(void);
+
+/**
+ * @brief Whether the kernels of an instruction set can run on this CPU
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @param isa one of the `ALEX_ISA_*` values
+ * @return `1` if `isa` is compiled into the library and supported by the CPU, `0` otherwise
+ *
+ * @see alex_isa_detected(), alex_set_isa()
+ */
+int alex_isa_supported(unsigned int isa);
+
+/**
+ * @brief Returns the instruction set whose kernels are currently used
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @return one of the `ALEX_ISA_*` values
+ *
+ * @see alex_set_isa(), alex_isa_name()
+ */
+unsigned int alex_get_isa(void);
+
+/**
+ * @brief Forces the instruction set of the dispatched kernels
+ *
+ * The selection is global and takes effect for the calls started afterwards, calls running
+ * concurrently on other threads finish with the kernels they started with.
+ *
+ * If `isa` is not supported (see @ref alex_isa_supported()), the selection is left unchanged and
+ * the flag is set to @ref ALEX_INV_PARAM_FLAG, to @ref ALEX_OK_FLAG otherwise.
+ *
+ * @param isa one of the `ALEX_ISA_*` values, or @ref ALEX_ISA_AUTO for @ref alex_isa_detected()
+ *
+ * @see alex_get_isa(), alex_isa_supported()
+ */
+void alex_set_isa(unsigned int isa);
+
+/**
+ * @brief Returns the name of an instruction set
+ *
+ * The names are `"scalar"`, `"sse2"`, `"avx2"`, `"avx512"` and `"neon"`, as accepted by the
+ * `ALEX_ISA` environment variable.
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @param isa one of the `ALEX_ISA_*` values
+ * @return the name, or `"unknown"` if `isa` is invalid
+ *
+ * @see alex_get_isa()
+ */
+const char *alex_isa_name(unsigned int isa);
+
+#endif
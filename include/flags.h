@@ -32,9 +32,19 @@
  *   the ALEX library is called. As such, if you intend to check the flag set by a routine,
  *   make sure you either store it away in a second variable or check its value immediately before
  *   proceeding to further ALEX function calls.
+ * - The flag is stored in thread-local storage: every thread has its own flag, which is only
+ *   updated by the ALEX routines called from that very thread.
+ * - Most computational routines have a reentrant variant carrying the suffix `_r` (such as
+ *   @ref alex_gcd_r() for @ref alex_gcd()). These variants return the flag directly as an `int`,
+ *   pass the actual result through a pointer argument and never read or write the flag.
  * - The functions which do not set any flags are those that perform no computations and do not
  *   modify the internal state of the framework. Usually their documentation contains a note about
  *   them not setting any flags
+ * - Defining `ALEX_INLINE` before including any ALEX header (ie. with `-DALEX_INLINE`) turns calls to
+ *   the flag accessors, @ref alex_range_abs() and the polynomial accessors and single point evaluation
+ *   of @ref poly.h into calls to `static inline` equivalents, which the compiler can inline into the
+ *   caller's loops. Their behaviour, flags included, is identical, and the out-of-line functions remain
+ *   available (ie. `&alex_get_flag` still yields the library's function).
  *
  * **Flag index**
  *
@@ -60,6 +70,19 @@
  */
 #define _ALEX_FLAGS_H
 
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+/**
+ * @brief Storage class specifier for thread-local variables
+ *
+ * Expands to `_Thread_local` on C11 compilers and to the equivalent compiler extension otherwise.
+ */
+#define ALEX_THREAD_LOCAL _Thread_local
+#elif defined(_MSC_VER)
+#define ALEX_THREAD_LOCAL __declspec(thread)
+#else
+#define ALEX_THREAD_LOCAL __thread
+#endif
+
 /**
  * @brief Info flag indicating that all is well (status: OK) */
 #define ALEX_OK_FLAG 0
@@ -71,23 +94,70 @@
  * @brief Info flag indicating that a function was called with wrong args
  */
 #define ALEX_INV_PARAM_FLAG 102
+/**
+ * @brief Info flag indicating that a caller-supplied buffer is too small for the output of a function
+ * (the required size is reported nonetheless)
+ */
+#define ALEX_BUF_SIZE_FLAG 103
 /**
  * @brief Info flag indicating that an algebraic operation was attempted on an illegal argument set (ie. 0 division)
  */
 #define ALEX_ALG_INV_OP_FLAG 201
+/**
+ * @brief Info flag indicating that the result of an algebraic operation does not fit into its type
+ */
+#define ALEX_ALG_OVERFLOW_FLAG 202
+/**
+ * @brief Info flag indicating that the interval passed to a root-finding routine does not bracket a root,
+ * ie. the function has the same sign at both ends
+ */
+#define ALEX_ROOT_BRACKET_FLAG 301
+/**
+ * @brief Info flag indicating that a root-finding routine did not reach the requested tolerance within
+ * its maximum number of iterations (the best available approximation is returned nonetheless)
+ */
+#define ALEX_ROOT_MAXITER_FLAG 302
+/**
+ * @brief Info flag indicating that Newton's method hit a point where the derivative vanishes
+ */
+#define ALEX_ROOT_DERIV_FLAG 303
 /**
  * @brief Info flag indicating that an operation was attempted with the coefficient's `index` argument greater
  * than the degree of the polynomial
  */
 #define ALEX_POLY_INDEX_GT_DEG_FLAG 401
+/**
+ * @brief Info flag indicating that the destination polynomial of an operation cannot hold
+ * the coefficients of the result (see @ref alex_poly.cap)
+ */
+#define ALEX_POLY_CAP_FLAG 402
+/**
+ * @brief Info flag indicating that the bytes passed to a deserialization routine are not a serialized
+ * polynomial (wrong signature or byte order, truncated or misaligned data)
+ */
+#define ALEX_POLY_FORMAT_FLAG 403
 /**
  * @brief Infor flag indicating an overflow of the factorial value
  */
 #define ALEX_FACT_OVERFLOW_FLAG 501
+/**
+ * @brief Info flag indicating an overflow of the binomial coefficient value
+ */
+#define ALEX_BINOM_OVERFLOW_FLAG 502
 /**
  * @brief Info flag indicating that the creation of a range struct failed because of the args supplied
  */
 #define ALEX_INV_RANGE_FLAG 506
+/**
+ * @brief Info flag indicating that an integrator could not reach the requested tolerance within
+ * its limits (the best available approximation is returned nonetheless)
+ */
+#define ALEX_INTEG_TOL_FLAG 507
+/**
+ * @brief Info flag indicating that a function approximation could not reach the requested tolerance
+ * within its limits (the best available approximation is returned nonetheless)
+ */
+#define ALEX_APPROX_TOL_FLAG 508
 /**
  * @brief Info flag indicating a call to @ref alex_set_dx() with a negative argument
  */
@@ -96,6 +166,9 @@
 /**
  * @brief Returns the value of the flag which is currently set
  *
+ * The flag is thread-local, as such this returns the flag set by the last ALEX
+ * routine called from the current thread.
+ *
  * @return the current flag
  *
  * @see alex_set_flag()
@@ -116,4 +189,22 @@ int alex_get_flag(void);
  */
 void alex_set_flag(int flag);
 
+#if defined(ALEX_INLINE)
+/*
+ * Header mode, see the notes of this file. The flag itself is defined in flags.c.
+ */
+extern ALEX_THREAD_LOCAL int _alex_flag;
+
+static inline int _alex_get_flag(void) {
+    return _alex_flag;
+}
+
+static inline void _alex_set_flag(int flag) {
+    _alex_flag = flag;
+}
+
+#define alex_get_flag() _alex_get_flag()
+#define alex_set_flag(flag) _alex_set_flag(flag)
+#endif
+
 #endif
\ No newline at end of file
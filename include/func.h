@@ -35,6 +35,8 @@
  * `#include` it.
  */
 
+#include <stddef.h>
+
 #ifndef _ALEX_FUNC_H
 /**
  * @brief Include guard for this file
@@ -130,6 +132,15 @@ alex_range *alex_make_range(double min, double max);
  */
 double alex_range_abs(alex_range *range);
 
+#if defined(ALEX_INLINE)
+// header mode, see the notes of flags.h
+static inline double _alex_range_abs(alex_range *range) {
+    return range->max - range->min;
+}
+
+#define alex_range_abs(range) _alex_range_abs(range)
+#endif
+
 /**
  * @brief Typedef for a function taking a double and returning a double
  *
@@ -174,6 +185,247 @@ typedef double (*alex_func_3d)(double, double, double);
  */
 typedef double (*alex_func_nd)(int n, double v[]);
 
+/**
+ * @brief Typedef for a function taking a double and a context pointer and returning a double
+ *
+ * Represents a real function \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$ whose definition
+ * depends on some user-defined data `ctx` (such as the coefficients of a polynomial). It is
+ * meant to be bundled together with said data within an @ref alex_closure_1d.
+ *
+ * @param x the argument
+ * @param ctx the context pointer stored in the @ref alex_closure_1d
+ *
+ * @see alex_closure_1d, alex_func_1d()
+ */
+typedef double (*alex_ctxfunc_1d)(double x, void *ctx);
+
+/**
+ * @brief Represents a real function together with the data it depends on
+ *
+ * Since there are no lambdas in C, a function which is determined at runtime (ie. the function
+ * of a given @ref alex_poly) cannot be represented as a plain @ref alex_func_1d without resorting
+ * to global variables. This struct pairs a function pointer with a context pointer, that is passed
+ * to the function upon every call. As such, any number of closures may exist and be used from
+ * multiple threads at the same time.
+ *
+ * The reentrant (`_r`) variants of the integration, differentiation and root-finding routines
+ * take their integrand as an @ref alex_closure_1d.
+ *
+ * **Example**
+ *
+ *     double scaled_sin(double x, void *ctx) {
+ *         return *(double *) ctx * sin(x);
+ *     }
+ *     // ...
+ *     double a = 2.;
+ *     alex_closure_1d f = alex_make_closure(&scaled_sin, &a);
+ *     double y = alex_closure_eval(f, 1.); // 2 * sin(1)
+ *
+ * **Notes**
+ * - The closure does not own `ctx`: the data it points to must outlive any use of the closure.
+ *
+ * @see alex_make_closure(), alex_func_closure(), alex_closure_eval(), alex_ctxfunc_1d()
+ */
+typedef struct {
+    /**
+     * @brief The function
+     */
+    alex_ctxfunc_1d func;
+    /**
+     * @brief The context pointer passed to `func`
+     */
+    void *ctx;
+} alex_closure_1d;
+
+/**
+ * @brief Macro evaluating an @ref alex_closure_1d at a given point
+ *
+ * This is equivalent to `f.func(x, f.ctx)`.
+ *
+ * @param f the closure (not a pointer to it)
+ * @param x the argument
+ * @return the function value
+ */
+#define alex_closure_eval(f,x) ((f).func((x), (f).ctx))
+
+/**
+ * @brief Constructs a closure
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @param func the function
+ * @param ctx the context pointer passed to `func`
+ * @return the closure
+ *
+ * @see alex_closure_1d, alex_func_closure()
+ */
+alex_closure_1d alex_make_closure(alex_ctxfunc_1d func, void *ctx);
+
+/**
+ * @brief Wraps a plain @ref alex_func_1d into a closure
+ *
+ * The closure stores the address `f` of the function pointer, not the function pointer
+ * itself, as such the variable `*f` must outlive any use of the closure.
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @param f pointer to the function
+ * @return the closure
+ *
+ * @see alex_closure_1d, alex_make_closure()
+ */
+alex_closure_1d alex_func_closure(alex_func_1d *f);
+
+/**
+ * @brief Typedef for a function evaluating a real function on a block of points
+ *
+ * Represents a real function \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$ which is evaluated on
+ * `n` points at once, ie. `y[i] = f(x[i])` for `i` in `0, ..., n - 1`. Since the function receives
+ * whole arrays, it can process them with vector instructions and amortize the cost of the call.
+ * It is meant to be bundled together with its data within an @ref alex_vclosure_1d.
+ *
+ * @param x the `n` arguments
+ * @param y the buffer receiving the `n` function values (never overlapping `x`)
+ * @param n the number of points
+ * @param ctx the context pointer stored in the @ref alex_vclosure_1d
+ *
+ * @see alex_vclosure_1d, alex_ctxfunc_1d()
+ */
+typedef void (*alex_vfunc_1d)(const double *x, double *y, size_t n, void *ctx);
+
+/**
+ * @brief Represents a vectorized real function together with the data it depends on
+ *
+ * This is the block-wise counterpart of @ref alex_closure_1d. The integration routines carrying
+ * the suffix `_vec` (such as @ref alex_integrate_trap_vec()) generate their abscissae in blocks
+ * and evaluate the integrand through this type.
+ *
+ * @see alex_make_vclosure(), alex_closure_vclosure(), alex_vfunc_1d(), alex_closure_1d
+ */
+typedef struct {
+    /**
+     * @brief The vectorized function
+     */
+    alex_vfunc_1d func;
+    /**
+     * @brief The context pointer passed to `func`
+     */
+    void *ctx;
+} alex_vclosure_1d;
+
+/**
+ * @brief Constructs a vectorized closure
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @param func the vectorized function
+ * @param ctx the context pointer passed to `func`
+ * @return the closure
+ *
+ * @see alex_vclosure_1d, alex_closure_vclosure()
+ */
+alex_vclosure_1d alex_make_vclosure(alex_vfunc_1d func, void *ctx);
+
+/**
+ * @brief Wraps a scalar closure into a vectorized one
+ *
+ * The returned closure evaluates `*f` point by point. This allows for any @ref alex_closure_1d
+ * to be passed to the `_vec` routines, albeit without the benefits of vectorization.
+ * The closure stores the address `f`, as such `*f` must outlive any use of the closure.
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @param f pointer to the scalar closure
+ * @return the vectorized closure
+ *
+ * @see alex_vclosure_1d, alex_make_vclosure()
+ */
+alex_vclosure_1d alex_closure_vclosure(alex_closure_1d *f);
+
+/**
+ * @brief Maximum dimension of the domain of an @ref alex_vclosure_nd
+ *
+ * @see alex_func_nd_vclosure(), cubature.h
+ */
+#define ALEX_MAX_DIM 16u
+
+/**
+ * @brief Typedef for a function evaluating a multivariate real function on a block of points
+ *
+ * Represents a real function \f$f:\mathbb{R}^d\rightarrow\mathbb{R}\f$ which is evaluated on
+ * `n` points at once. The coordinates are stored point after point, ie. `x[i * dim + j]` is the
+ * `j`-th coordinate of the `i`-th point, and `y[i]` receives its function value.
+ * It is meant to be bundled together with its data within an @ref alex_vclosure_nd.
+ *
+ * @param dim the dimension \f$d\f$ of the domain (at most @ref ALEX_MAX_DIM)
+ * @param x the `n * dim` coordinates
+ * @param y the buffer receiving the `n` function values (never overlapping `x`)
+ * @param n the number of points
+ * @param ctx the context pointer stored in the @ref alex_vclosure_nd
+ *
+ * @see alex_vclosure_nd, alex_vfunc_1d(), alex_func_nd()
+ */
+typedef void (*alex_vfunc_nd)(unsigned int dim, const double *x, double *y, size_t n, void *ctx);
+
+/**
+ * @brief Represents a vectorized multivariate real function together with the data it depends on
+ *
+ * This is the multivariate counterpart of @ref alex_vclosure_1d, taken by the cubature routines
+ * (see @ref cubature.h).
+ *
+ * @see alex_make_vclosure_nd(), alex_func_nd_vclosure(), alex_vfunc_nd()
+ */
+typedef struct {
+    /**
+     * @brief The vectorized function
+     */
+    alex_vfunc_nd func;
+    /**
+     * @brief The context pointer passed to `func`
+     */
+    void *ctx;
+} alex_vclosure_nd;
+
+/**
+ * @brief Constructs a vectorized multivariate closure
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @param func the vectorized function
+ * @param ctx the context pointer passed to `func`
+ * @return the closure
+ *
+ * @see alex_vclosure_nd, alex_func_nd_vclosure()
+ */
+alex_vclosure_nd alex_make_vclosure_nd(alex_vfunc_nd func, void *ctx);
+
+/**
+ * @brief Wraps a plain @ref alex_func_nd into a vectorized closure
+ *
+ * The returned closure evaluates `*f` point by point, on a copy of the coordinates of each point.
+ * The closure stores the address `f`, as such `*f` must outlive any use of the closure.
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @param f pointer to the function
+ * @return the vectorized closure
+ *
+ * @see alex_vclosure_nd, alex_make_vclosure_nd()
+ */
+alex_vclosure_nd alex_func_nd_vclosure(alex_func_nd *f);
+
 /**
  * @brief Compute factorial
  *
@@ -181,8 +433,9 @@ typedef double (*alex_func_nd)(int n, double v[]);
  * There is also an equivalent for `unsigned long` types.
  *
  * **Notes**
- * - The factorial \f$x!=x\cdot(x-1)\cdot(x-2)\cdot...\cdot 1\f$ is computed iteratively instead
- *   of recursively, primarily for performance reasons.
+ * - The factorial \f$x!=x\cdot(x-1)\cdot(x-2)\cdot...\cdot 1\f$ is looked up in a precomputed
+ *   table holding all factorials which fit into the return type (up to \f$12!\f$), as such
+ *   this function runs in constant time.
  * - Since \f$0!=1\f$, `alex_fact(0)` returns `1`.
  * - Should the factorial overflow, `0` will be returned (the factorial is never \f$0\f$),
  *   and the flag @ref ALEX_FACT_OVERFLOW_FLAG is set.
@@ -194,6 +447,20 @@ typedef double (*alex_func_nd)(int n, double v[]);
  */
 unsigned int alex_fact(unsigned int x);
 
+/**
+ * @brief Reentrant variant of @ref alex_fact()
+ *
+ * Computes the same value as @ref alex_fact(), but stores it in `*res` and returns the
+ * flag instead of setting it. This function never accesses the flag.
+ *
+ * @param x the argument
+ * @param res where \f$x!\f$ is stored (`0` on overflow)
+ * @return @ref ALEX_OK_FLAG or @ref ALEX_FACT_OVERFLOW_FLAG
+ *
+ * @see alex_fact()
+ */
+int alex_fact_r(unsigned int x, unsigned int *res);
+
 /**
  * @brief Compute factorial
  *
@@ -201,8 +468,10 @@ unsigned int alex_fact(unsigned int x);
  * There is also an equivalent for `unsigned int` types.
  *
  * **Notes**
- * - The factorial \f$x!=x\cdot(x-1)\cdot(x-2)\cdot...\cdot 1\f$ is computed iteratively instead
- *   of recursively, primarily for performance reasons.
+ * - The factorial \f$x!=x\cdot(x-1)\cdot(x-2)\cdot...\cdot 1\f$ is looked up in a precomputed
+ *   table holding all factorials which fit into the return type (up to \f$20!\f$ for 64-bit
+ *   `unsigned long`), as such this function runs in constant time.
+ * - For larger arguments, see @ref alex_log_fact().
  * - Since \f$0!=1\f$, `alex_factl(0L)` returns `1`.
  * - Should the factorial overflow, `0L` will be returned (the factorial is never \f$0\f$),
  *   and the flag @ref ALEX_FACT_OVERFLOW_FLAG is set.
@@ -214,6 +483,20 @@ unsigned int alex_fact(unsigned int x);
  */
 unsigned long alex_factl(unsigned long x);
 
+/**
+ * @brief Reentrant variant of @ref alex_factl()
+ *
+ * Computes the same value as @ref alex_factl(), but stores it in `*res` and returns the
+ * flag instead of setting it. This function never accesses the flag.
+ *
+ * @param x the argument
+ * @param res where \f$x!\f$ is stored (`0` on overflow)
+ * @return @ref ALEX_OK_FLAG or @ref ALEX_FACT_OVERFLOW_FLAG
+ *
+ * @see alex_factl()
+ */
+int alex_factl_r(unsigned long x, unsigned long *res);
+
 /**
  * @brief Computes the binomial coefficient
  *
@@ -229,16 +512,39 @@ n\\
  * This requires that \f$m\geq n\f$. If ´m<n`, this returns `0` and the flag @ref ALEX_INV_PARAM_FLAG
  * is set.
  *
+ * The factorials are never formed. Instead, the coefficient is computed as the product
+ *
+ * \f$\prod_{i=1}^k \frac{m - k + i}i\f$, where \f$k = \min(n, m - n)\f$,
+ *
+ * in \f$k\f$ steps, each of which yields an integer. As such this function only fails if the
+ * result itself does not fit into an `unsigned int`, in which case `0` is returned and the flag
+ * @ref ALEX_BINOM_OVERFLOW_FLAG is set.
+ *
  * There is also an equivalent for `unsigned long` types.
  *
  * @param m an unsigned integer
  * @param n an unsigned integer
  * @return their binomial coefficient
  *
- * @see alex_binom_coeffl()
+ * @see alex_binom_coeffl(), alex_log_binom_coeff()
  */
 unsigned int alex_binom_coeff(unsigned int m, unsigned int n);
 
+/**
+ * @brief Reentrant variant of @ref alex_binom_coeff()
+ *
+ * Computes the same value as @ref alex_binom_coeff(), but stores it in `*res` and returns the
+ * flag instead of setting it. This function never accesses the flag.
+ *
+ * @param m an unsigned integer
+ * @param n an unsigned integer
+ * @param res where the binomial coefficient is stored (`0` on failure)
+ * @return @ref ALEX_OK_FLAG, @ref ALEX_INV_PARAM_FLAG or @ref ALEX_BINOM_OVERFLOW_FLAG
+ *
+ * @see alex_binom_coeff()
+ */
+int alex_binom_coeff_r(unsigned int m, unsigned int n, unsigned int *res);
+
 /**
  * @brief Computes the binomial coefficient
  *
@@ -254,14 +560,74 @@ n\\
  * This requires that \f$m\geq n\f$. If ´m<n`, this returns `0` and the flag @ref ALEX_INV_PARAM_FLAG
  * is set.
  *
+ * The factorials are never formed. Instead, the coefficient is computed as the product
+ *
+ * \f$\prod_{i=1}^k \frac{m - k + i}i\f$, where \f$k = \min(n, m - n)\f$,
+ *
+ * in \f$k\f$ steps, each of which yields an integer. As such this function only fails if the
+ * result itself does not fit into an `unsigned long`, in which case `0` is returned and the flag
+ * @ref ALEX_BINOM_OVERFLOW_FLAG is set.
+ *
  * There is also an equivalent for `unsigned int` types.
  *
  * @param m an unsigned integer
  * @param n an unsigned integer
  * @return their binomial coefficient
  *
- * @see alex_binom_coeff()
+ * @see alex_binom_coeff(), alex_log_binom_coeff()
  */
 unsigned long alex_binom_coeffl(unsigned long m, unsigned long n);
 
+/**
+ * @brief Reentrant variant of @ref alex_binom_coeffl()
+ *
+ * Computes the same value as @ref alex_binom_coeffl(), but stores it in `*res` and returns the
+ * flag instead of setting it. This function never accesses the flag.
+ *
+ * @param m an unsigned integer
+ * @param n an unsigned integer
+ * @param res where the binomial coefficient is stored (`0` on failure)
+ * @return @ref ALEX_OK_FLAG, @ref ALEX_INV_PARAM_FLAG or @ref ALEX_BINOM_OVERFLOW_FLAG
+ *
+ * @see alex_binom_coeffl()
+ */
+int alex_binom_coeffl_r(unsigned long m, unsigned long n, unsigned long *res);
+
+/**
+ * @brief Computes the natural logarithm of the factorial
+ *
+ * This function returns \f$\ln x!\f$ for arguments of any size. Up to \f$20!\f$ the logarithm
+ * of the exact factorial is returned, beyond that Stirling's series
+ *
+ * \f$\ln x! \approx x\ln x - x + \frac12\ln(2\pi x) + \frac1{12x} - \frac1{360x^3} + ...\f$
+ *
+ * is evaluated, which is accurate to double precision in this range.
+ *
+ * @param x the argument
+ * @return \f$\ln x!\f$
+ *
+ * @see alex_factl(), alex_log_binom_coeff()
+ */
+double alex_log_fact(unsigned long x);
+
+/**
+ * @brief Computes the natural logarithm of the binomial coefficient
+ *
+ * This function returns \f$\ln\binom mn\f$ for arguments of any size, ie. where the binomial
+ * coefficient itself overflows any integer type (see @ref alex_binom_coeffl()). For
+ * \f$k = \min(n, m - n) \leq 64\f$ the logarithms of the factors \f$\frac{m-k+i}i\f$ are summed up,
+ * otherwise Stirling's series is used, with the leading terms combined such that they do not
+ * cancel out.
+ *
+ * This requires that \f$m\geq n\f$. If ´m<n`, this returns `0` and the flag @ref ALEX_INV_PARAM_FLAG
+ * is set.
+ *
+ * @param m an unsigned integer
+ * @param n an unsigned integer
+ * @return the logarithm of their binomial coefficient
+ *
+ * @see alex_binom_coeffl(), alex_log_fact()
+ */
+double alex_log_binom_coeff(unsigned long m, unsigned long n);
+
 #endif
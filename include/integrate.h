@@ -18,6 +18,7 @@
  */
 
 #include "func.h"
+#include "pool.h"
 
 /**
  * @file integrate.h
@@ -31,6 +32,7 @@
  * **Notes**
  * - See the article Wikipedia article [Numerical integration](https://en.wikipedia.org/wiki/Numerical_integration)
  *   for information on the mathematical algorithms and rules imüplemented in this library.
+ * - The multi-dimensional integrators are declared in @ref cubature.h.
  */
 
 #ifndef _ALEX_INTEGRATE_H
@@ -50,6 +52,261 @@
  */
 #define ALEX_DEFAULT_NBINS 1000ul
 
+/**
+ * @brief Minimum number of abscissae per work chunk of the parallel integrators
+ *
+ * The parallel integrators split the abscissae into chunks of consecutive points, whose partial sums
+ * are computed independently and then added up in order. The partition only depends on the number of
+ * points, never on the number of threads, such that results are reproducible bit by bit.
+ *
+ * @see alex_integrate_trap_par(), alex_integrate_bins_par()
+ */
+#define ALEX_PAR_CHUNK 4096ul
+
+/**
+ * @brief Maximum number of work chunks of the parallel integrators
+ *
+ * @see ALEX_PAR_CHUNK
+ */
+#define ALEX_PAR_MAX_CHUNKS 1024ul
+
+/**
+ * @brief Number of abscissae per block passed to vectorized integrands
+ *
+ * @see alex_integrate_trap_vec(), alex_vclosure_1d
+ */
+#define ALEX_VEC_BLOCK 256u
+
+/**
+ * @brief Maximum order of the Gauss-Legendre rules
+ *
+ * @see alex_gauss_legendre(), alex_integrate_gauss()
+ */
+#define ALEX_GAUSS_MAX_ORDER 256u
+
+/**
+ * @brief Default maximum number of subintervals of the adaptive integrator
+ *
+ * @see alex_integrate_adaptive()
+ */
+#define ALEX_DEFAULT_QUAD_LIMIT 1000u
+
+/**
+ * @brief Default maximum number of trapezoid refinements of the Romberg integrator
+ *
+ * The finest level evaluates the integrand at \f$2^{20}+1\f$ abscissae.
+ *
+ * @see alex_integrate_romberg(), ALEX_ROMBERG_MAX_LEVELS
+ */
+#define ALEX_DEFAULT_ROMBERG_LEVELS 20u
+
+/**
+ * @brief Largest number of trapezoid refinements accepted by the Romberg integrator
+ *
+ * @see alex_integrate_romberg_r()
+ */
+#define ALEX_ROMBERG_MAX_LEVELS 30u
+
+/**
+ * @brief Summation mode of the parallel integrators adding the values in order, the default
+ *
+ * The rounding error may grow linearly with the number of values.
+ *
+ * @see alex_integ_ctx
+ */
+#define ALEX_SUM_NAIVE 0u
+
+/**
+ * @brief Summation mode of the parallel integrators adding the values pairwise
+ *
+ * The values are summed in blocks of @ref ALEX_VEC_BLOCK, whose sums are combined as the leaves of
+ * a binary tree, as such the rounding error only grows logarithmically with the number of values,
+ * for almost the cost of @ref ALEX_SUM_NAIVE.
+ *
+ * @see alex_integ_ctx, ALEX_SUM_KAHAN
+ */
+#define ALEX_SUM_PAIRWISE 1u
+
+/**
+ * @brief Summation mode of the parallel integrators compensating the rounding error of every addition
+ *
+ * Uses the Kahan–Babuška (Neumaier) algorithm on four interleaved accumulators
+ * (see [Wikipedia](https://en.wikipedia.org/wiki/Kahan_summation_algorithm)), as such the error
+ * does not grow with the number of values, at about four times the cost of an addition.
+ *
+ * @see alex_integ_ctx, ALEX_SUM_PAIRWISE
+ */
+#define ALEX_SUM_KAHAN 2u
+
+/**
+ * @brief Rule of an @ref alex_integ_stream joining consecutive samples by straight lines
+ *
+ * @see alex_integ_stream_init_r(), ALEX_STREAM_SIMPSON
+ */
+#define ALEX_STREAM_TRAP 0u
+
+/**
+ * @brief Rule of an @ref alex_integ_stream fitting a parabola through each pair of consecutive intervals
+ *
+ * The intervals need not be of equal width. An unpaired last interval is integrated over the
+ * parabola through the last three samples, as such the rule is exact for quadratic data with any
+ * number of samples from three on.
+ *
+ * @see alex_integ_stream_init_r(), ALEX_STREAM_TRAP
+ */
+#define ALEX_STREAM_SIMPSON 1u
+
+/**
+ * @brief Per-call settings of the parallel integration routines
+ *
+ * Instead of a global setting (the way `nbins` works), every call to a parallel integrator
+ * receives its own context, as such differently configured integrations may run at the same time.
+ * The fields omitted from an initializer are `0`, ie. the defaults.
+ *
+ * **Example**
+ *
+ *     alex_integ_ctx ctx = {8};  // 8 threads
+ *     double area;
+ *     alex_integrate_trap_par(f, range, 10000000ul, &ctx, &area);
+ *
+ *     alex_integ_ctx exact = {8, ALEX_SUM_KAHAN};  // compensated summation
+ *     alex_integrate_bins_par(f, range, 10000000ul, &exact, &area);
+ *
+ * @see alex_integrate_trap_par(), alex_integrate_bins_par()
+ */
+typedef struct {
+    /**
+     * @brief The maximum number of threads (including the calling thread), `0` for all the threads
+     * of the pool
+     */
+    unsigned int threads;
+    /**
+     * @brief How the function values are summed by the one-dimensional integrators, one of
+     * @ref ALEX_SUM_NAIVE, @ref ALEX_SUM_PAIRWISE or @ref ALEX_SUM_KAHAN
+     */
+    unsigned int summation;
+    /**
+     * @brief The pool providing the threads, `NULL` for the default pool (see @ref alex_default_pool())
+     */
+    alex_pool *pool;
+} alex_integ_ctx;
+
+/**
+ * @brief Information on the outcome of an error-controlled integration
+ *
+ * @see alex_integrate_adaptive()
+ */
+typedef struct {
+    /**
+     * @brief The estimated absolute error of the returned integral
+     */
+    double abserr;
+    /**
+     * @brief The number of evaluations of the integrand
+     */
+    unsigned long nevals;
+    /**
+     * @brief The number of subintervals the integration range was split into
+     */
+    unsigned int nintervals;
+} alex_quad_info;
+
+/**
+ * @brief State of an incrementally refined composite trapezoidal rule
+ *
+ * Each call to @ref alex_trap_refine_r() halves the subintervals, and as the abscissae of the
+ * previous level are a subset of the new ones, only the new midpoints are evaluated. Refining up
+ * to \f$n\f$ subintervals thus costs \f$n+1\f$ evaluations in total, rather than the
+ * \f$2n\f$ spent by calling @ref alex_integrate_trap_r() with \f$1, 2, \dots, n\f$ subintervals.
+ *
+ * **Example**
+ *
+ *     alex_trap_state state;
+ *     double area, prev;
+ *     alex_trap_init_r(f, range, &state, &area);
+ *     do {
+ *         prev = area;
+ *         alex_trap_refine_r(f, &state, &area);
+ *     } while (fabs(area - prev) > 1e-10);
+ *
+ * @see alex_trap_init_r(), alex_trap_refine_r(), alex_integrate_romberg()
+ */
+typedef struct {
+    /**
+     * @brief The lower end of the integration interval
+     */
+    double min;
+    /**
+     * @brief The width of the integration interval
+     */
+    double width;
+    /**
+     * @brief The sum of the weighted function values of the current level, such that the
+     * trapezoidal approximation is `width * sum / subintervals`
+     */
+    double sum;
+    /**
+     * @brief The number of subintervals of the current level
+     */
+    unsigned long subintervals;
+    /**
+     * @brief The number of evaluations of the integrand so far
+     */
+    unsigned long nevals;
+} alex_trap_state;
+
+/**
+ * @brief State of the integration of a stream of samples \f$(x_k, y_k)\f$
+ *
+ * The samples are fed in chunks of any size by @ref alex_integ_stream_feed_r(), whose abscissae
+ * must be strictly increasing across all chunks, yet need not be equally spaced. The state has a
+ * fixed size, such that arbitrarily long streams are integrated without buffering them, and the
+ * integral of the samples so far can be queried at any time with @ref alex_integ_stream_result_r().
+ * The area is summed with compensation (as with @ref ALEX_SUM_KAHAN), as such the rounding error
+ * does not grow with the length of the stream.
+ *
+ * **Example**
+ *
+ *     // interleaved records x0, y0, x1, y1, ... for instance of a memory-mapped file
+ *     const double *rec = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+ *     size_t n = size / (2 * sizeof(double));
+ *
+ *     alex_integ_stream stream;
+ *     double area;
+ *     alex_integ_stream_init_r(&stream, ALEX_STREAM_SIMPSON);
+ *     for (size_t k = 0; k < n; k += 1u << 20)
+ *         alex_integ_stream_feed_r(&stream, rec + 2 * k, rec + 2 * k + 1, n - k < 1u << 20 ? n - k : 1u << 20, 2);
+ *     alex_integ_stream_result_r(&stream, &area);
+ *
+ * @see alex_integ_stream_init_r(), alex_integ_stream_feed_r(), alex_integ_stream_result_r()
+ */
+typedef struct {
+    /**
+     * @brief The area of the completed intervals (or pairs thereof, see @ref ALEX_STREAM_SIMPSON)
+     */
+    double sum;
+    /**
+     * @brief The compensation of the rounding error of `sum`
+     */
+    double comp;
+    /**
+     * @brief The abscissae of the last three samples, the latest one last
+     */
+    double x[3];
+    /**
+     * @brief The values of the last three samples, the latest one last
+     */
+    double y[3];
+    /**
+     * @brief The number of samples so far
+     */
+    unsigned long nsamples;
+    /**
+     * @brief The rule, @ref ALEX_STREAM_TRAP or @ref ALEX_STREAM_SIMPSON
+     */
+    unsigned int rule;
+} alex_integ_stream;
+
 /**
  * @brief Sets the number of bins to be used in calls to bin integration functions
  *
@@ -95,6 +352,11 @@ unsigned long alex_get_bins(void);
  * standard distribution function (gaussian with \f$\sigma = 1\f$ and \f$\mu = 0\f$) if `nbins`
  * is set to a value of the order of \f$10000000\f$ (10 millions).
  *
+ * The abscissae are computed from their index, \f$x_i = a + i\delta\f$ for
+ * \f$i = 0, \dots, m - 1\f$, as such exactly \f$m\f$ evaluations are performed whatever the
+ * rounding of \f$\delta\f$. To also bound the rounding error of the summation, use
+ * @ref alex_integrate_bins_par() with @ref ALEX_SUM_PAIRWISE or @ref ALEX_SUM_KAHAN.
+ *
  * @param f the @ref alex_func_1d() representing the integrand \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
  * @param range the integration interval
  *
@@ -102,9 +364,24 @@ unsigned long alex_get_bins(void);
  * @see alex_func_1d(), alex_get_bins(), alex_set_bins(), alex_make_range(), alex_range
  */
 double alex_integrate_bins(alex_func_1d f, alex_range *range);
-//double alex_integrate_bins2D(alex_func2d f, alex_range *rangeX, alex_func1d callback, *rangeY);
-/*double alex_integrate_bins3D(alex_func1d f, alex_range *range);
-double alex_integrate_bins(alex_func1d f, alex_range *range);*/
+
+/**
+ * @brief Reentrant variant of @ref alex_integrate_bins()
+ *
+ * Computes the same value as @ref alex_integrate_bins(), but takes the integrand as an
+ * @ref alex_closure_1d and the number of bins as an argument instead of reading `nbins`,
+ * stores the integral in `*res` and returns the flag instead of setting it.
+ * This function never accesses the flag.
+ *
+ * @param f the @ref alex_closure_1d representing the integrand \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param range the integration interval
+ * @param nbins the number of bins
+ * @param res where the bins integral is stored (`0` on failure)
+ *
+ * @returns @ref ALEX_OK_FLAG, or @ref ALEX_INV_PARAM_FLAG if `nbins` is `0`
+ * @see alex_integrate_bins()
+ */
+int alex_integrate_bins_r(alex_closure_1d f, alex_range *range, unsigned long nbins, double *res);
 
 /**
  * @deprecated Yields sub-optimal results (see @ref alex_integrate_trap() for a better approximation)
@@ -112,13 +389,14 @@ double alex_integrate_bins(alex_func1d f, alex_range *range);*/
  * This function performs an approximation of the one-dimensional integral of a given function \f$f\f$
  * in the given range, ie. if `a = range->min` and `b = range->max`.
  *
- * This approximation uses the rectangle rule (interpolation method), ie.
+ * This approximation uses the rectangle rule (midpoint rule), ie.
  *
  * \f$ I_f(a,b)=\int_a^b f(x)\mathrm dx \approx (b-a)\cdot f\left(\frac{a+b}{2}\right) \f$
  *
  * without extension, and
  *
- * \f$ I_f(a,b)=\int_a^b f(x)\mathrm dx \approx (b-a)\cdot f\left(\frac{a}{2} + \sum_{k=1}^{n-1} \left(a+k\frac{b-a}{n} \right) + \frac{b}{2} \right) \f$
+ * \f$ I_f(a,b)=\int_a^b f(x)\mathrm dx \approx \delta\sum_{k=0}^{n-1} f\left(a+\left(k+\frac12\right)\delta\right) \f$,
+ * where \f$\delta = \frac{b-a}n\f$,
  *
  * with the composite rule.
  *
@@ -133,6 +411,23 @@ double alex_integrate_bins(alex_func1d f, alex_range *range);*/
  */
 double alex_integrate_rect(alex_func_1d f, alex_range *range, int subintervals);
 
+/**
+ * @brief Reentrant variant of @ref alex_integrate_rect()
+ *
+ * Computes the same value as @ref alex_integrate_rect(), but takes the integrand as an
+ * @ref alex_closure_1d, stores the integral in `*res` and returns the flag instead of setting it.
+ * This function never accesses the flag.
+ *
+ * @param f the @ref alex_closure_1d representing the integrand \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param range the integration interval
+ * @param subintervals the number of subintervals for the compound rule
+ * @param res where the approximated integral is stored (`0` on failure)
+ *
+ * @returns @ref ALEX_OK_FLAG, or @ref ALEX_INV_PARAM_FLAG if `subintervals` is negative
+ * @see alex_integrate_rect()
+ */
+int alex_integrate_rect_r(alex_closure_1d f, alex_range *range, int subintervals, double *res);
+
 /**
  * @brief Performs approximation of one-dimensional integration of a given real function
  *
@@ -160,4 +455,447 @@ double alex_integrate_rect(alex_func_1d f, alex_range *range, int subintervals);
  */
 double alex_integrate_trap(alex_func_1d f, alex_range *range, int subintervals);
 
-#endif
\ No newline at end of file
+/**
+ * @brief Reentrant variant of @ref alex_integrate_trap()
+ *
+ * Computes the same value as @ref alex_integrate_trap(), but takes the integrand as an
+ * @ref alex_closure_1d, stores the integral in `*res` and returns the flag instead of setting it.
+ * This function never accesses the flag.
+ *
+ * @param f the @ref alex_closure_1d representing the integrand \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param range the integration interval
+ * @param subintervals the number of subintervals for the compound rule
+ * @param res where the approximated integral is stored (`0` on failure)
+ *
+ * @returns @ref ALEX_OK_FLAG, or @ref ALEX_INV_PARAM_FLAG if `subintervals` is negative
+ * @see alex_integrate_trap()
+ */
+int alex_integrate_trap_r(alex_closure_1d f, alex_range *range, int subintervals, double *res);
+
+/**
+ * @brief Vectorized variant of @ref alex_integrate_bins_r()
+ *
+ * Computes the left Riemann sum
+ *
+ * \f$ J_f(a,b) = \delta\sum_{i=0}^{m-1} f(a + i\delta)\f$, where \f$\delta = \frac{b-a}m\f$,
+ *
+ * evaluating `f` on blocks of up to @ref ALEX_VEC_BLOCK abscissae at a time. The abscissae are
+ * computed from their index rather than by accumulating the step. This yields the same sum as
+ * @ref alex_integrate_bins_par(), up to the rounding of the summation order.
+ *
+ * This function never accesses the flag.
+ *
+ * @param f the @ref alex_vclosure_1d representing the integrand \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param range the integration interval
+ * @param nbins the number of bins \f$m\f$
+ * @param res where the bins integral is stored (`0` on failure)
+ *
+ * @returns @ref ALEX_OK_FLAG, or @ref ALEX_INV_PARAM_FLAG if `nbins` is `0`
+ * @see alex_integrate_bins_r(), alex_integrate_trap_vec(), alex_vclosure_1d
+ */
+int alex_integrate_bins_vec(alex_vclosure_1d f, alex_range *range, unsigned long nbins, double *res);
+
+/**
+ * @brief Vectorized variant of @ref alex_integrate_rect_r()
+ *
+ * Computes the same value as @ref alex_integrate_rect_r() (up to rounding, as the values are summed
+ * in a different order), evaluating the integrand at the midpoints in blocks of @ref ALEX_VEC_BLOCK
+ * through an @ref alex_vclosure_1d. This function never accesses the flag.
+ *
+ * @param f the @ref alex_vclosure_1d representing the integrand \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param range the integration interval
+ * @param subintervals the number of subintervals for the compound rule
+ * @param res where the approximated integral is stored (`0` on failure)
+ *
+ * @returns @ref ALEX_OK_FLAG, or @ref ALEX_INV_PARAM_FLAG if `subintervals` is negative
+ * @see alex_integrate_rect_r(), alex_vclosure_1d
+ */
+int alex_integrate_rect_vec(alex_vclosure_1d f, alex_range *range, int subintervals, double *res);
+
+/**
+ * @brief Vectorized variant of @ref alex_integrate_trap_r()
+ *
+ * Computes the same compound trapezoidal rule as @ref alex_integrate_trap_r(), evaluating `f` on
+ * blocks of up to @ref ALEX_VEC_BLOCK abscissae at a time and summing the function values with
+ * several independent accumulators. This function never accesses the flag.
+ *
+ * **Example**
+ *
+ *     double area;
+ *     alex_integrate_trap_vec(alex_poly_vclosure(poly), range, 1000000, &area);
+ *
+ * @param f the @ref alex_vclosure_1d representing the integrand \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param range the integration interval
+ * @param subintervals the number of subintervals for the compound rule
+ * @param res where the approximated integral is stored (`0` on failure)
+ *
+ * @returns @ref ALEX_OK_FLAG, or @ref ALEX_INV_PARAM_FLAG if `subintervals` is negative
+ * @see alex_integrate_trap_r(), alex_integrate_bins_vec(), alex_vclosure_1d
+ */
+int alex_integrate_trap_vec(alex_vclosure_1d f, alex_range *range, int subintervals, double *res);
+
+/**
+ * @brief Multi-threaded variant of @ref alex_integrate_bins_r()
+ *
+ * Computes the left Riemann sum
+ *
+ * \f$ J_f(a,b) = \delta\sum_{i=0}^{m-1} f(a + i\delta)\f$, where \f$\delta = \frac{b-a}m\f$,
+ *
+ * distributing the evaluations of `f` over several threads (see @ref alex_integ_ctx).
+ * The abscissae are computed from their index rather than by accumulating the step.
+ * The result does not depend on the number of threads nor on their scheduling (see @ref ALEX_PAR_CHUNK).
+ *
+ * **Notes**
+ * - `f` is called concurrently from several threads, as such it must be thread-safe.
+ * - This function never accesses the flag.
+ *
+ * @param f the @ref alex_closure_1d representing the integrand \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param range the integration interval
+ * @param nbins the number of bins \f$m\f$
+ * @param ctx the settings of this call (`NULL` for the defaults, ie. all the threads of the default pool)
+ * @param res where the bins integral is stored (`0` on failure)
+ *
+ * @returns @ref ALEX_OK_FLAG, @ref ALEX_INV_PARAM_FLAG if `nbins` is `0` or the summation mode is
+ * invalid, or @ref ALEX_BAD_ALLOC_FLAG
+ * @see alex_integrate_bins_r(), alex_integrate_trap_par(), alex_integ_ctx
+ */
+int alex_integrate_bins_par(alex_closure_1d f, alex_range *range, unsigned long nbins,
+        const alex_integ_ctx *ctx, double *res);
+
+/**
+ * @brief Multi-threaded variant of @ref alex_integrate_trap_r()
+ *
+ * Computes the same compound trapezoidal rule as @ref alex_integrate_trap_r(), distributing
+ * the evaluations of `f` over several threads (see @ref alex_integ_ctx). The result does not
+ * depend on the number of threads nor on their scheduling (see @ref ALEX_PAR_CHUNK).
+ *
+ * **Notes**
+ * - `f` is called concurrently from several threads, as such it must be thread-safe.
+ * - This function never accesses the flag.
+ *
+ * @param f the @ref alex_closure_1d representing the integrand \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param range the integration interval
+ * @param subintervals the number of subintervals for the compound rule (`0` for none)
+ * @param ctx the settings of this call (`NULL` for the defaults, ie. all the threads of the default pool)
+ * @param res where the approximated integral is stored (`0` on failure)
+ *
+ * @returns @ref ALEX_OK_FLAG, @ref ALEX_INV_PARAM_FLAG if the summation mode is invalid, or
+ * @ref ALEX_BAD_ALLOC_FLAG
+ * @see alex_integrate_trap_r(), alex_integrate_bins_par(), alex_integ_ctx
+ */
+int alex_integrate_trap_par(alex_closure_1d f, alex_range *range, unsigned long subintervals,
+        const alex_integ_ctx *ctx, double *res);
+
+/**
+ * @brief Performs adaptive integration of a given real function up to a given tolerance
+ *
+ * This function approximates the integral of \f$f\f$ over the given range with the 15-point
+ * Gauss-Kronrod rule, whose difference with the embedded 7-point Gauss rule provides an
+ * error estimate (see [Wikipedia](https://en.wikipedia.org/wiki/Gauss%E2%80%93Kronrod_quadrature_formula)).
+ * As long as the total estimated error \f$E\f$ exceeds the tolerance, the subinterval with the
+ * largest error is bisected and both halves are integrated anew. As such, the evaluations of
+ * \f$f\f$ are spent where it is hard to integrate, while smooth regions are covered by few
+ * large subintervals. The integration stops as soon as
+ *
+ * \f$ E \leq \max(\epsilon_{abs}, \epsilon_{rel}\cdot|I|)\f$,
+ *
+ * where \f$I\f$ is the current approximation.
+ *
+ * If the tolerance cannot be met with @ref ALEX_DEFAULT_QUAD_LIMIT subintervals, the best
+ * approximation found is returned and the flag @ref ALEX_INTEG_TOL_FLAG is set. If both
+ * tolerances are not positive, `0` is returned and the flag @ref ALEX_INV_PARAM_FLAG is set.
+ *
+ * **Example**
+ *
+ *     alex_quad_info info;
+ *     double area = alex_integrate_adaptive(&gaussian, range, 1e-12, 0, &info);
+ *     printf("%.15f +- %g (%lu evaluations)\n", area, info.abserr, info.nevals);
+ *
+ * @param f the @ref alex_func_1d() representing the integrand \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param range the integration interval
+ * @param epsabs the absolute tolerance \f$\epsilon_{abs}\f$
+ * @param epsrel the relative tolerance \f$\epsilon_{rel}\f$
+ * @param info where the error estimate and evaluation count are stored (may be `NULL`)
+ *
+ * @returns the approximated integral
+ * @see alex_integrate_adaptive_r(), alex_quad_info, alex_integrate_trap()
+ */
+double alex_integrate_adaptive(alex_func_1d f, alex_range *range, double epsabs, double epsrel,
+        alex_quad_info *info);
+
+/**
+ * @brief Reentrant variant of @ref alex_integrate_adaptive()
+ *
+ * Computes the same value as @ref alex_integrate_adaptive(), but takes the integrand as an
+ * @ref alex_closure_1d and the maximum number of subintervals as an argument, stores the integral
+ * in `*res` and returns the flag instead of setting it. This function never accesses the flag.
+ *
+ * @param f the @ref alex_closure_1d representing the integrand \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param range the integration interval
+ * @param epsabs the absolute tolerance \f$\epsilon_{abs}\f$
+ * @param epsrel the relative tolerance \f$\epsilon_{rel}\f$
+ * @param limit the maximum number of subintervals (`0` for @ref ALEX_DEFAULT_QUAD_LIMIT)
+ * @param info where the error estimate and evaluation count are stored (may be `NULL`)
+ * @param res where the approximated integral is stored
+ *
+ * @returns @ref ALEX_OK_FLAG, @ref ALEX_INTEG_TOL_FLAG, @ref ALEX_INV_PARAM_FLAG or @ref ALEX_BAD_ALLOC_FLAG
+ * @see alex_integrate_adaptive(), alex_quad_info
+ */
+int alex_integrate_adaptive_r(alex_closure_1d f, alex_range *range, double epsabs, double epsrel,
+        unsigned int limit, alex_quad_info *info, double *res);
+
+/**
+ * @brief Initializes an incremental trapezoidal rule with a single subinterval
+ *
+ * Evaluates the integrand at both ends of the range and stores the trapezoidal approximation
+ * \f$(b-a)\frac{f(a)+f(b)}2\f$ in `*res`. This function never accesses the flag.
+ *
+ * @param f the @ref alex_closure_1d representing the integrand \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param range the integration interval
+ * @param state the state to initialize
+ * @param res where the approximated integral is stored (may be `NULL`)
+ *
+ * @returns @ref ALEX_OK_FLAG
+ * @see alex_trap_state, alex_trap_refine_r()
+ */
+int alex_trap_init_r(alex_closure_1d f, alex_range *range, alex_trap_state *state, double *res);
+
+/**
+ * @brief Doubles the subintervals of an incremental trapezoidal rule
+ *
+ * Evaluates the integrand only at the midpoints of the current subintervals, and stores the
+ * trapezoidal approximation with twice as many subintervals in `*res`, which agrees with
+ * @ref alex_integrate_trap_r() up to rounding. `f` must be the closure `state` was initialized with.
+ * This function never accesses the flag.
+ *
+ * @param f the @ref alex_closure_1d representing the integrand \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param state the state, as initialized by @ref alex_trap_init_r()
+ * @param res where the approximated integral is stored (may be `NULL`)
+ *
+ * @returns @ref ALEX_OK_FLAG, or @ref ALEX_ALG_OVERFLOW_FLAG (leaving `state` untouched) if the
+ * number of subintervals cannot be doubled
+ * @see alex_trap_state, alex_trap_init_r()
+ */
+int alex_trap_refine_r(alex_closure_1d f, alex_trap_state *state, double *res);
+
+/**
+ * @brief Performs Romberg integration of a given real function up to a given tolerance
+ *
+ * This function refines the trapezoidal rule by halving its subintervals (see @ref alex_trap_state)
+ * and applies Richardson extrapolation to the sequence of approximations
+ * (see [Wikipedia](https://en.wikipedia.org/wiki/Romberg%27s_method)): with \f$R_{k,0}\f$ the
+ * trapezoidal rule with \f$2^k\f$ subintervals,
+ *
+ * \f$ R_{k,j} = R_{k,j-1} + \frac{R_{k,j-1} - R_{k-1,j-1}}{4^j - 1}\f$.
+ *
+ * The error of \f$R_{k,k}\f$ is estimated by \f$E = |R_{k,k} - R_{k-1,k-1}|\f$, and the
+ * integration stops as soon as \f$ E \leq \max(\epsilon_{abs}, \epsilon_{rel}\cdot|R_{k,k}|)\f$,
+ * after at least 4 refinements, such that the regular sampling of a coarse level cannot fake
+ * convergence. Every level only evaluates the new midpoints, as such reaching \f$2^k\f$
+ * subintervals takes \f$2^k+1\f$ evaluations of \f$f\f$. Romberg integration converges very
+ * fast for smooth integrands, prefer @ref alex_integrate_adaptive() for integrands with kinks or
+ * singularities.
+ *
+ * If the tolerance cannot be met with @ref ALEX_DEFAULT_ROMBERG_LEVELS refinements, the last
+ * approximation is returned and the flag @ref ALEX_INTEG_TOL_FLAG is set. If both tolerances are
+ * not positive, `0` is returned and the flag @ref ALEX_INV_PARAM_FLAG is set.
+ *
+ * **Example**
+ *
+ *     alex_quad_info info;
+ *     double area = alex_integrate_romberg(&gaussian, range, 1e-12, 0, &info);
+ *     printf("%.15f +- %g (%lu evaluations)\n", area, info.abserr, info.nevals);
+ *
+ * @param f the @ref alex_func_1d() representing the integrand \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param range the integration interval
+ * @param epsabs the absolute tolerance \f$\epsilon_{abs}\f$
+ * @param epsrel the relative tolerance \f$\epsilon_{rel}\f$
+ * @param info where the error estimate, evaluation count and final number of subintervals are
+ * stored (may be `NULL`)
+ *
+ * @returns the approximated integral
+ * @see alex_integrate_romberg_r(), alex_quad_info, alex_integrate_adaptive()
+ */
+double alex_integrate_romberg(alex_func_1d f, alex_range *range, double epsabs, double epsrel,
+        alex_quad_info *info);
+
+/**
+ * @brief Reentrant variant of @ref alex_integrate_romberg()
+ *
+ * Computes the same value as @ref alex_integrate_romberg(), but takes the integrand as an
+ * @ref alex_closure_1d and the maximum number of refinements as an argument, stores the integral
+ * in `*res` and returns the flag instead of setting it. This function never accesses the flag.
+ *
+ * @param f the @ref alex_closure_1d representing the integrand \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param range the integration interval
+ * @param epsabs the absolute tolerance \f$\epsilon_{abs}\f$
+ * @param epsrel the relative tolerance \f$\epsilon_{rel}\f$
+ * @param levels the maximum number of refinements (`0` for @ref ALEX_DEFAULT_ROMBERG_LEVELS), at
+ * most @ref ALEX_ROMBERG_MAX_LEVELS
+ * @param info where the error estimate, evaluation count and final number of subintervals are
+ * stored (may be `NULL`)
+ * @param res where the approximated integral is stored
+ *
+ * @returns @ref ALEX_OK_FLAG, @ref ALEX_INTEG_TOL_FLAG or @ref ALEX_INV_PARAM_FLAG
+ * @see alex_integrate_romberg(), alex_trap_state
+ */
+int alex_integrate_romberg_r(alex_closure_1d f, alex_range *range, double epsabs, double epsrel,
+        unsigned int levels, alex_quad_info *info, double *res);
+
+/**
+ * @brief Returns the nodes and weights of the Gauss-Legendre rule of a given order
+ *
+ * The `n`-point Gauss-Legendre rule approximates
+ *
+ * \f$ \int_{-1}^1 f(x)\mathrm dx \approx \sum_{i=0}^{n-1} w_i f(x_i)\f$,
+ *
+ * where the nodes \f$x_i\f$ are the roots of the Legendre polynomial \f$P_n\f$, and is exact
+ * for polynomials up to degree \f$2n - 1\f$ (see [Wikipedia](https://en.wikipedia.org/wiki/Gaussian_quadrature)).
+ *
+ * The nodes and weights of each order are computed upon the first request for that order and
+ * cached for the lifetime of the program. The cache is thread-safe: the tables are never modified
+ * once published, as such they can be read from any number of threads without locking.
+ *
+ * If `n` is `0` or greater than @ref ALEX_GAUSS_MAX_ORDER, the flag @ref ALEX_INV_PARAM_FLAG is
+ * returned and the pointers are set to `NULL`.
+ *
+ * **Notes**
+ * - The nodes are sorted in ascending order.
+ * - This function never accesses the flag.
+ *
+ * @param n the number of nodes
+ * @param nodes where the pointer to the `n` nodes is stored
+ * @param weights where the pointer to the `n` weights is stored
+ *
+ * @returns @ref ALEX_OK_FLAG, @ref ALEX_INV_PARAM_FLAG or @ref ALEX_BAD_ALLOC_FLAG
+ * @see alex_integrate_gauss(), ALEX_GAUSS_MAX_ORDER
+ */
+int alex_gauss_legendre(unsigned int n, const double **nodes, const double **weights);
+
+/**
+ * @brief Performs Gauss-Legendre integration of a given real function
+ *
+ * This function maps the cached `n`-point Gauss-Legendre rule (see @ref alex_gauss_legendre())
+ * onto the given range with the affine transformation \f$x \mapsto \frac{b-a}2 x + \frac{a+b}2\f$.
+ * As such, it calls `f` exactly `n` times and requires no setup once the rule of order `n` is cached.
+ *
+ * If `n` is `0` or greater than @ref ALEX_GAUSS_MAX_ORDER, `0` is returned and the flag
+ * @ref ALEX_INV_PARAM_FLAG is set.
+ *
+ * @param f the @ref alex_func_1d() representing the integrand \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param range the integration interval
+ * @param n the number of nodes
+ *
+ * @returns the approximated integral
+ * @see alex_integrate_gauss_r(), alex_integrate_gauss_vec(), alex_gauss_legendre()
+ */
+double alex_integrate_gauss(alex_func_1d f, alex_range *range, unsigned int n);
+
+/**
+ * @brief Reentrant variant of @ref alex_integrate_gauss()
+ *
+ * Computes the same value as @ref alex_integrate_gauss(), but takes the integrand as an
+ * @ref alex_closure_1d, stores the integral in `*res` and returns the flag instead of setting it.
+ * This function never accesses the flag.
+ *
+ * @param f the @ref alex_closure_1d representing the integrand \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param range the integration interval
+ * @param n the number of nodes
+ * @param res where the approximated integral is stored (`0` on failure)
+ *
+ * @returns @ref ALEX_OK_FLAG, @ref ALEX_INV_PARAM_FLAG or @ref ALEX_BAD_ALLOC_FLAG
+ * @see alex_integrate_gauss()
+ */
+int alex_integrate_gauss_r(alex_closure_1d f, alex_range *range, unsigned int n, double *res);
+
+/**
+ * @brief Vectorized variant of @ref alex_integrate_gauss_r()
+ *
+ * Computes the same value as @ref alex_integrate_gauss_r(), evaluating `f` on all `n` mapped
+ * nodes with a single call. This function never accesses the flag.
+ *
+ * @param f the @ref alex_vclosure_1d representing the integrand \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param range the integration interval
+ * @param n the number of nodes
+ * @param res where the approximated integral is stored (`0` on failure)
+ *
+ * @returns @ref ALEX_OK_FLAG, @ref ALEX_INV_PARAM_FLAG or @ref ALEX_BAD_ALLOC_FLAG
+ * @see alex_integrate_gauss_r(), alex_vclosure_1d
+ */
+int alex_integrate_gauss_vec(alex_vclosure_1d f, alex_range *range, unsigned int n, double *res);
+
+/**
+ * @brief Initializes the integration of a stream of samples
+ *
+ * This function never accesses the flag.
+ *
+ * @param stream the state to initialize
+ * @param rule @ref ALEX_STREAM_TRAP or @ref ALEX_STREAM_SIMPSON
+ *
+ * @returns @ref ALEX_OK_FLAG, or @ref ALEX_INV_PARAM_FLAG if `rule` is unknown
+ * @see alex_integ_stream, alex_integ_stream_feed_r()
+ */
+int alex_integ_stream_init_r(alex_integ_stream *stream, unsigned int rule);
+
+/**
+ * @brief Feeds a chunk of samples to the integration of a stream
+ *
+ * The `k`-th sample of the chunk is `(xs[k * stride], ys[k * stride])`, as such both separate arrays
+ * (`stride` of `1`) and interleaved records of `stride` doubles (with `ys` pointing into the first
+ * record) are read in place, without copying. The samples are only read, never stored beyond the
+ * last three. This function never accesses the flag.
+ *
+ * **Notes**
+ *
+ * If an abscissa is not greater than its predecessor (or is not a number), the samples before it
+ * are kept and the rest of the chunk is ignored, such that the stream can be resumed after the
+ * offending sample.
+ *
+ * @param stream the state, as initialized by @ref alex_integ_stream_init_r()
+ * @param xs the abscissae of the chunk
+ * @param ys the values of the chunk
+ * @param n the number of samples of the chunk (may be `0`)
+ * @param stride the distance in doubles between consecutive samples of `xs` and `ys`
+ *
+ * @returns @ref ALEX_OK_FLAG, or @ref ALEX_INV_PARAM_FLAG if `stride` is `0`, `xs` or `ys` is `NULL`
+ * while `n` is not, or the abscissae are not strictly increasing
+ * @see alex_integ_stream, alex_integ_stream_result_r()
+ */
+int alex_integ_stream_feed_r(alex_integ_stream *stream, const double *xs, const double *ys,
+        size_t n, size_t stride);
+
+/**
+ * @brief Stores the integral of the samples of a stream so far in `*res`
+ *
+ * The integral is taken from the first to the latest sample, it is `0` for fewer than two samples.
+ * The state is not modified, as such the stream can be fed further afterwards. This function never
+ * accesses the flag.
+ *
+ * @param stream the state
+ * @param res where the integral is stored
+ *
+ * @returns @ref ALEX_OK_FLAG
+ * @see alex_integ_stream, alex_integ_stream_feed_r()
+ */
+int alex_integ_stream_result_r(const alex_integ_stream *stream, double *res);
+
+/**
+ * @brief Integrates an array of samples, see @ref alex_integ_stream
+ *
+ * Equivalent to feeding all samples as a single chunk to a fresh stream with the rule `rule`.
+ * This function never accesses the flag.
+ *
+ * @param xs the strictly increasing abscissae
+ * @param ys the values
+ * @param n the number of samples
+ * @param stride the distance in doubles between consecutive samples of `xs` and `ys`
+ * @param rule @ref ALEX_STREAM_TRAP or @ref ALEX_STREAM_SIMPSON
+ * @param res where the integral is stored (`0` on failure)
+ *
+ * @returns @ref ALEX_OK_FLAG or @ref ALEX_INV_PARAM_FLAG
+ * @see alex_integ_stream_feed_r()
+ */
+int alex_integrate_samples_r(const double *xs, const double *ys, size_t n, size_t stride,
+        unsigned int rule, double *res);
+
+#endif
@@ -0,0 +1,216 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/**
+ * @file memo.h
+ * @author Lorenzo Calza
+ * @date 14 Oct 2026
+ * @brief Header file containing the declarations for the memoizing evaluation cache
+ *
+ * An @ref alex_memo wraps an expensive function and remembers its most recent values, keyed on the
+ * exact bits of the argument. Its closures (see @ref alex_memo_closure()) can be passed to any routine
+ * taking an @ref alex_closure_1d or an @ref alex_vclosure_1d, which then skips the evaluations at
+ * abscissae it has already visited, such as the grid points of a trapezoidal rule refined by
+ * successive calls with twice as many subintervals.
+ *
+ * **Example**
+ *
+ *     alex_memo *memo = alex_make_memo(alex_func_closure(&expensive), 1u << 16, 0);
+ *     alex_closure_1d f = alex_memo_closure(memo);
+ *     for (int n = 1; n <= 1 << 12; n *= 2)
+ *         alex_integrate_trap_r(f, range, n, &area); // only the new midpoints are evaluated
+ *     alex_memo_stats stats = alex_memo_get_stats(memo);
+ *     alex_free_memo(memo);
+ *
+ * **Notes**
+ * - The cache is organized in buckets of @ref ALEX_MEMO_WAYS entries. Once a bucket is full, its
+ *   oldest entry is evicted, as such the memory footprint stays bounded.
+ * - Unless created with @ref ALEX_MEMO_SHARED, an @ref alex_memo must only be used by one thread at a
+ *   time. Either share one memo created with @ref ALEX_MEMO_SHARED, or use one memo per thread.
+ */
+
+#ifndef _ALEX_MEMO_H
+/**
+ * @brief Include guard for this file
+ */
+#define _ALEX_MEMO_H
+
+#include <stddef.h>
+
+#include "func.h"
+
+/**
+ * @brief Number of entries of a bucket of an @ref alex_memo
+ */
+#define ALEX_MEMO_WAYS 4u
+
+/**
+ * @brief Maximum number of locks of an @ref alex_memo created with @ref ALEX_MEMO_SHARED
+ *
+ * Each lock guards an interleaved subset of the buckets, such that threads rarely contend.
+ */
+#define ALEX_MEMO_STRIPES 64u
+
+/**
+ * @brief Option of @ref alex_make_memo() making the cache safe to use from several threads at once
+ *
+ * Lookups and insertions are then guarded by locks (see @ref ALEX_MEMO_STRIPES). The wrapped
+ * function is called outside of the locks, as such it must be thread-safe itself.
+ */
+#define ALEX_MEMO_SHARED 1u
+
+/**
+ * @brief Opaque type representing a memoizing evaluation cache
+ *
+ * @see alex_make_memo(), alex_free_memo(), alex_memo_closure()
+ */
+typedef struct alex_memo alex_memo;
+
+/**
+ * @brief Usage statistics of an @ref alex_memo
+ *
+ * @see alex_memo_get_stats()
+ */
+typedef struct {
+    /**
+     * @brief The number of evaluations answered from the cache
+     */
+    unsigned long hits;
+    /**
+     * @brief The number of evaluations of the wrapped function
+     */
+    unsigned long misses;
+    /**
+     * @brief The number of entries which were evicted to make room for new ones
+     */
+    unsigned long evictions;
+    /**
+     * @brief The maximum number of entries of the cache
+     */
+    size_t capacity;
+} alex_memo_stats;
+
+/**
+ * @brief Constructs a memoizing cache wrapped around a function
+ *
+ * The number of entries is `capacity` rounded up to a power of two, and to at least
+ * @ref ALEX_MEMO_WAYS.
+ *
+ * If `capacity` is `0` or `options` is invalid, `NULL` is returned and the flag @ref ALEX_INV_PARAM_FLAG
+ * is set, if the allocation fails the flag @ref ALEX_BAD_ALLOC_FLAG is set, to @ref ALEX_OK_FLAG otherwise.
+ *
+ * @param f the function to memoize, whose context must outlive the cache
+ * @param capacity the maximum number of entries
+ * @param options `0` or @ref ALEX_MEMO_SHARED
+ * @return the cache, to be freed with @ref alex_free_memo()
+ *
+ * @see alex_free_memo(), alex_memo_closure()
+ */
+alex_memo *alex_make_memo(alex_closure_1d f, size_t capacity, unsigned int options);
+
+/**
+ * @brief Frees a memoizing cache
+ *
+ * The flag is set to @ref ALEX_INV_PARAM_FLAG if `memo` is `NULL` and to @ref ALEX_OK_FLAG otherwise.
+ *
+ * @param memo the cache
+ *
+ * @see alex_make_memo()
+ */
+void alex_free_memo(alex_memo *memo);
+
+/**
+ * @brief Evaluates the wrapped function through the cache
+ *
+ * Returns the cached value if `x` (compared bit by bit, such that `0.` and `-0.` are distinct) is
+ * in the cache, and otherwise evaluates the wrapped function and caches its value.
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @param memo the cache
+ * @param x the argument
+ * @return the function value
+ *
+ * @see alex_memo_closure()
+ */
+double alex_memo_eval(alex_memo *memo, double x);
+
+/**
+ * @brief Wraps a memoizing cache into a closure
+ *
+ * The closure evaluates @ref alex_memo_eval(). `memo` must outlive any use of the closure.
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @param memo the cache
+ * @return the closure
+ *
+ * @see alex_memo_vclosure(), alex_memo_eval()
+ */
+alex_closure_1d alex_memo_closure(alex_memo *memo);
+
+/**
+ * @brief Wraps a memoizing cache into a vectorized closure
+ *
+ * The closure evaluates @ref alex_memo_eval() point by point, as such it allows passing the cache
+ * to the `_vec` routines. `memo` must outlive any use of the closure.
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @param memo the cache
+ * @return the vectorized closure
+ *
+ * @see alex_memo_closure()
+ */
+alex_vclosure_1d alex_memo_vclosure(alex_memo *memo);
+
+/**
+ * @brief The usage statistics of a memoizing cache
+ *
+ * The counters are read under the locks of a shared cache, each stripe at a time, as such they are
+ * consistent once no other thread uses the cache.
+ *
+ * The flag is set to @ref ALEX_INV_PARAM_FLAG if `memo` is `NULL` (all statistics are `0`) and to
+ * @ref ALEX_OK_FLAG otherwise.
+ *
+ * @param memo the cache
+ * @return the statistics since the construction or the last call to @ref alex_memo_clear()
+ *
+ * @see alex_memo_stats
+ */
+alex_memo_stats alex_memo_get_stats(alex_memo *memo);
+
+/**
+ * @brief Empties a memoizing cache and resets its statistics
+ *
+ * Must not be called while other threads use the cache. The flag is set to @ref ALEX_INV_PARAM_FLAG
+ * if `memo` is `NULL` and to @ref ALEX_OK_FLAG otherwise.
+ *
+ * @param memo the cache
+ *
+ * @see alex_memo_get_stats()
+ */
+void alex_memo_clear(alex_memo *memo);
+
+#endif
@@ -0,0 +1,348 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/**
+ * @file optimize.h
+ * @author Lorenzo Calza
+ * @date 14 Oct 2026
+ * @brief Header file containing the declarations for root-finding routines
+ *
+ * Unlike @ref alex_secant_method(), which runs for a fixed number of iterations, the routines
+ * declared in this header file stop as soon as the root is known to the requested tolerance,
+ * and report how many function evaluations this took through an @ref alex_root_info.
+ *
+ * **Notes**
+ * - Use @ref alex_root_brent() whenever an interval containing a sign change is known: it
+ *   cannot fail to converge and is usually as fast as the secant method.
+ * - Newton's method (@ref alex_root_newton()) converges quadratically from a good starting point,
+ *   but may diverge from a bad one.
+ */
+
+#ifndef _ALEX_OPTIMIZE_H
+/**
+ * @brief Include guard for this file
+ */
+#define _ALEX_OPTIMIZE_H
+
+#include <stddef.h>
+
+#include "func.h"
+#include "poly.h"
+#include "integrate.h"
+
+/**
+ * @brief Default maximum number of iterations of the root-finding routines
+ *
+ * @see alex_root_brent(), alex_root_newton()
+ */
+#define ALEX_DEFAULT_ROOT_MAXITER 100u
+
+/**
+ * @brief Maximum degree for which @ref alex_poly_roots() keeps its workspace on the stack
+ *
+ * Higher degrees allocate the workspace from the heap, once per call of @ref alex_poly_roots_r()
+ * and once per chunk of @ref alex_poly_roots_many().
+ */
+#define ALEX_ROOTS_STACK_DEG 64u
+
+/**
+ * @brief Number of polynomials per work chunk of @ref alex_poly_roots_many()
+ */
+#define ALEX_ROOTS_CHUNK 64ul
+
+/**
+ * @brief Maximum number of work chunks of @ref alex_poly_roots_many()
+ *
+ * @see ALEX_ROOTS_CHUNK
+ */
+#define ALEX_ROOTS_MAX_CHUNKS 1024ul
+
+/**
+ * @brief Information on the outcome of a root search
+ *
+ * @see alex_root_brent(), alex_root_newton()
+ */
+typedef struct {
+    /**
+     * @brief The estimated absolute error of the returned root (the width of the final bracket
+     * for @ref alex_root_brent(), the size of the last step for @ref alex_root_newton())
+     */
+    double abserr;
+    /**
+     * @brief The number of evaluations of the function, plus those of its derivative if any
+     */
+    unsigned long nevals;
+    /**
+     * @brief The number of iterations
+     */
+    unsigned int iterations;
+} alex_root_info;
+
+/**
+ * @brief Determines a root of a function within an interval with Brent's method
+ *
+ * The interval must bracket a root, ie. \f$f(\mathrm{min})\f$ and \f$f(\mathrm{max})\f$ must have
+ * opposite signs (or either be \f$0\f$). Brent's method keeps such a bracket at all times and
+ * shrinks it with inverse quadratic interpolation or secant steps, falling back to bisection
+ * whenever these do not make enough progress (see
+ * [Wikipedia](https://en.wikipedia.org/wiki/Brent%27s_method)). As such, it converges superlinearly
+ * for smooth functions, yet never needs more iterations than bisection would.
+ *
+ * The search stops once the bracket is smaller than \f$2\varepsilon|x| + \mathrm{tol}\f$, ie. `tol`
+ * is an absolute tolerance and `0` requests the root to machine precision. Every iteration
+ * costs one evaluation of \f$f\f$.
+ *
+ * **Example**
+ *
+ *     double test_brent(double x) {
+ *         return x*x - 612;
+ *     }
+ *     // ...
+ *     alex_root_info info;
+ *     alex_range *r = alex_make_range(10, 30);
+ *     double root = alex_root_brent(&test_brent, r, 1e-12, &info);
+ *     printf("Root of test func: %.12f (%lu evaluations)\n", root, info.nevals);
+ *     free(r);
+ *
+ * The flag is set to @ref ALEX_ROOT_BRACKET_FLAG if the range does not bracket a root (in which
+ * case `0` is returned), to @ref ALEX_ROOT_MAXITER_FLAG if the tolerance was not reached within
+ * @ref ALEX_DEFAULT_ROOT_MAXITER iterations (the best approximation is returned nonetheless) and
+ * to @ref ALEX_OK_FLAG otherwise.
+ *
+ * @param f the function \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param range the interval which we must search
+ * @param tol the absolute tolerance, must not be negative
+ * @param info where the error estimate and evaluation count are stored, may be `NULL`
+ * @return the approximated root
+ *
+ * @see alex_root_brent_r(), alex_root_info
+ */
+double alex_root_brent(alex_func_1d f, alex_range *range, double tol, alex_root_info *info);
+
+/**
+ * @brief Reentrant variant of @ref alex_root_brent()
+ *
+ * Computes the same value as @ref alex_root_brent(), but takes the function as an
+ * @ref alex_closure_1d and the maximum number of iterations as an argument, stores the root
+ * in `*res` and returns the flag instead of setting it. This function never accesses the flag.
+ *
+ * @param f the @ref alex_closure_1d representing \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param range the interval which we must search
+ * @param tol the absolute tolerance, must not be negative
+ * @param maxiter the maximum number of iterations
+ * @param info where the error estimate and evaluation count are stored, may be `NULL`
+ * @param res where the approximated root is stored
+ * @return @ref ALEX_OK_FLAG, @ref ALEX_INV_PARAM_FLAG, @ref ALEX_ROOT_BRACKET_FLAG or
+ * @ref ALEX_ROOT_MAXITER_FLAG
+ *
+ * @see alex_root_brent()
+ */
+int alex_root_brent_r(alex_closure_1d f, alex_range *range, double tol, unsigned int maxiter,
+        alex_root_info *info, double *res);
+
+/**
+ * @brief Determines a root of a function with Newton's method
+ *
+ * Starting from \f$x_0\f$, this iterates \f$x_{k+1} = x_k - \frac{f(x_k)}{f'(x_k)}\f$ until the step
+ * is at most \f$\mathrm{tol}\cdot\max(|x_k|, 1)\f$ or \f$f(x_k) = 0\f$. Every iteration costs one
+ * evaluation of \f$f\f$ and one of \f$f'\f$.
+ *
+ * The flag is set to @ref ALEX_ROOT_DERIV_FLAG if the derivative vanishes at an iterate (which
+ * is returned), to @ref ALEX_ROOT_MAXITER_FLAG if the tolerance was not reached within
+ * @ref ALEX_DEFAULT_ROOT_MAXITER iterations and to @ref ALEX_OK_FLAG otherwise.
+ *
+ * @param f the function \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param df its derivative
+ * @param x0 the starting point
+ * @param tol the relative tolerance, must not be negative
+ * @param info where the error estimate and evaluation count are stored, may be `NULL`
+ * @return the approximated root
+ *
+ * @see alex_root_newton_r(), alex_poly_newton()
+ */
+double alex_root_newton(alex_func_1d f, alex_func_1d df, double x0, double tol, alex_root_info *info);
+
+/**
+ * @brief Reentrant variant of @ref alex_root_newton()
+ *
+ * Computes the same value as @ref alex_root_newton(), but takes the functions as
+ * @ref alex_closure_1d objects and the maximum number of iterations as an argument, stores
+ * the root in `*res` and returns the flag instead of setting it. This function never accesses
+ * the flag.
+ *
+ * @param f the @ref alex_closure_1d representing \f$f:\mathbb{R}\rightarrow\mathbb{R}\f$
+ * @param df the @ref alex_closure_1d representing its derivative
+ * @param x0 the starting point
+ * @param tol the relative tolerance, must not be negative
+ * @param maxiter the maximum number of iterations
+ * @param info where the error estimate and evaluation count are stored, may be `NULL`
+ * @param res where the approximated root is stored
+ * @return @ref ALEX_OK_FLAG, @ref ALEX_INV_PARAM_FLAG, @ref ALEX_ROOT_DERIV_FLAG or
+ * @ref ALEX_ROOT_MAXITER_FLAG
+ *
+ * @see alex_root_newton()
+ */
+int alex_root_newton_r(alex_closure_1d f, alex_closure_1d df, double x0, double tol, unsigned int maxiter,
+        alex_root_info *info, double *res);
+
+/**
+ * @brief Determines a root of a polynomial with Newton's method
+ *
+ * This is @ref alex_root_newton() applied to the polynomial and its derivative, which is
+ * computed once with @ref alex_poly_diff() beforehand.
+ *
+ * The flags are those of @ref alex_root_newton(), plus @ref ALEX_BAD_ALLOC_FLAG if the derivative
+ * could not be allocated and @ref ALEX_INV_PARAM_FLAG if `poly` is `NULL` (in which cases `0`
+ * is returned).
+ *
+ * @param poly the polynomial
+ * @param x0 the starting point
+ * @param tol the relative tolerance, must not be negative
+ * @param info where the error estimate and evaluation count are stored, may be `NULL`
+ * @return the approximated root
+ *
+ * @see alex_poly_newton_r(), alex_root_newton()
+ */
+double alex_poly_newton(alex_poly *poly, double x0, double tol, alex_root_info *info);
+
+/**
+ * @brief Reentrant variant of @ref alex_poly_newton()
+ *
+ * Computes the same value as @ref alex_poly_newton(), stores the root in `*res` and returns
+ * the flag instead of setting it. This function never accesses the flag, nor does it allocate:
+ * the derivative `deriv` is passed by the caller (as returned by @ref alex_poly_diff()), such
+ * that it can be reused when searching for several roots of the same polynomial.
+ *
+ * @param poly the polynomial
+ * @param deriv its derivative
+ * @param x0 the starting point
+ * @param tol the relative tolerance, must not be negative
+ * @param maxiter the maximum number of iterations
+ * @param info where the error estimate and evaluation count are stored, may be `NULL`
+ * @param res where the approximated root is stored
+ * @return @ref ALEX_OK_FLAG, @ref ALEX_INV_PARAM_FLAG, @ref ALEX_ROOT_DERIV_FLAG or
+ * @ref ALEX_ROOT_MAXITER_FLAG
+ *
+ * @see alex_poly_newton()
+ */
+int alex_poly_newton_r(alex_poly *poly, alex_poly *deriv, double x0, double tol, unsigned int maxiter,
+        alex_root_info *info, double *res);
+
+/**
+ * @brief Determines all complex roots of a polynomial with the Aberth-Ehrlich method
+ *
+ * Stores the \f$n\f$ roots \f$z_k\f$ of the polynomial of degree \f$n\f$, counted with their
+ * multiplicity, as `re[k] + i * im[k]`. Both arrays must have room for `deg` values. The
+ * order of the roots is unspecified, and the roots which are real are found with an
+ * imaginary part on the order of the rounding error, rather than exactly `0`.
+ *
+ * All estimates are improved simultaneously by
+ *
+ * \f$z_k \leftarrow z_k - \frac{1}{\frac{P'(z_k)}{P(z_k)} - \sum_{j\neq k}\frac 1{z_k - z_j}}\f$,
+ *
+ * which converges cubically for simple roots (see
+ * [Wikipedia](https://en.wikipedia.org/wiki/Aberth_method)), and linearly for multiple roots. No
+ * deflation takes place, as such the accuracy of each root does not depend on the others. An
+ * estimate is left as it is once \f$|P(z_k)|\f$ is within the rounding error of its evaluation,
+ * ie. once it cannot be improved any further, and the iteration stops when all are.
+ * Each iteration costs \f$O(n^2)\f$ operations, on the estimates stored as separate real and
+ * imaginary arrays, such that the loops vectorize.
+ *
+ * The leading coefficient of the polynomial must not be `0`. The flag is set to
+ * @ref ALEX_INV_PARAM_FLAG if it is (in which case `0` is returned and no roots are stored), to
+ * @ref ALEX_ROOT_MAXITER_FLAG if not all roots converged within @ref ALEX_DEFAULT_ROOT_MAXITER
+ * iterations, to @ref ALEX_BAD_ALLOC_FLAG if the workspace could not be allocated and to
+ * @ref ALEX_OK_FLAG otherwise.
+ *
+ * **Example**
+ *
+ *     double c[] = {-2, 0, 1}; // x^2 - 2
+ *     double re[2], im[2];
+ *     alex_poly *poly = alex_make_poly(2, c);
+ *     unsigned int n = alex_poly_roots(poly, re, im, NULL);
+ *     for (unsigned int k = 0; k < n; ++k) {
+ *         printf("%f%+fi\n", re[k], im[k]);
+ *     }
+ *
+ * @param poly the polynomial
+ * @param re where the real parts of the roots are stored
+ * @param im where the imaginary parts of the roots are stored
+ * @param info where the largest correction of the last iteration, the evaluation count and the
+ * iteration count are stored, may be `NULL`
+ * @return the number of roots stored, ie. the degree of the polynomial
+ *
+ * @see alex_poly_roots_r(), alex_poly_roots_many(), alex_poly_newton()
+ */
+unsigned int alex_poly_roots(alex_poly *poly, double *re, double *im, alex_root_info *info);
+
+/**
+ * @brief Reentrant variant of @ref alex_poly_roots()
+ *
+ * Computes the same roots as @ref alex_poly_roots(), but takes the maximum number of iterations as
+ * an argument and returns the flag instead of setting it. This function never accesses the flag.
+ *
+ * @param poly the polynomial
+ * @param re where the real parts of the `deg` roots are stored
+ * @param im where the imaginary parts of the `deg` roots are stored
+ * @param maxiter the maximum number of iterations
+ * @param info where the largest correction, evaluation count and iteration count are stored,
+ * may be `NULL`
+ * @return @ref ALEX_OK_FLAG, @ref ALEX_INV_PARAM_FLAG, @ref ALEX_ROOT_MAXITER_FLAG or
+ * @ref ALEX_BAD_ALLOC_FLAG
+ *
+ * @see alex_poly_roots()
+ */
+int alex_poly_roots_r(alex_poly *poly, double *re, double *im, unsigned int maxiter, alex_root_info *info);
+
+/**
+ * @brief Determines all complex roots of many polynomials of the same degree
+ *
+ * Solves the `count` polynomials of degree `deg` whose coefficients are stored contiguously in
+ * `coeffs`, polynomial `i` having the coefficients `coeffs[i * (deg + 1) + k]` for
+ * `k = 0, ..., deg` (lowest first, as in @ref alex_poly.coeffs). Its roots are stored in
+ * `re[i * deg + k]` and `im[i * deg + k]` for `k = 0, ..., deg - 1`, and are computed exactly as by
+ * @ref alex_poly_roots_r().
+ *
+ * The polynomials are split into chunks of @ref ALEX_ROOTS_CHUNK, or more if there would be more
+ * than @ref ALEX_ROOTS_MAX_CHUNKS of them, which are distributed over the threads and the pool set in
+ * `ctx`, like the parallel integrators do (see @ref alex_integ_ctx). The `summation` of `ctx` does not
+ * apply, as nothing is summed. The workspace is set up once per chunk, no memory is allocated per
+ * polynomial. The results do not depend on the number of threads.
+ *
+ * A polynomial whose leading coefficient is `0` gets `NAN` roots, and @ref ALEX_INV_PARAM_FLAG is
+ * returned once all others have been solved. Otherwise, @ref ALEX_ROOT_MAXITER_FLAG is returned if
+ * any polynomial did not converge. This function never accesses the flag.
+ *
+ * @param deg the degree of every polynomial
+ * @param coeffs the `count * (deg + 1)` coefficients
+ * @param count the number of polynomials
+ * @param re where the `count * deg` real parts are stored
+ * @param im where the `count * deg` imaginary parts are stored
+ * @param maxiter the maximum number of iterations per polynomial
+ * @param ctx the parallel settings, `NULL` for the defaults
+ * @param info where the largest correction, the total evaluation count and the largest iteration
+ * count are stored, may be `NULL`
+ * @return @ref ALEX_OK_FLAG, @ref ALEX_INV_PARAM_FLAG, @ref ALEX_ROOT_MAXITER_FLAG or
+ * @ref ALEX_BAD_ALLOC_FLAG
+ *
+ * @see alex_poly_roots_r()
+ */
+int alex_poly_roots_many(unsigned int deg, const double *coeffs, size_t count, double *re, double *im,
+        unsigned int maxiter, const alex_integ_ctx *ctx, alex_root_info *info);
+
+#endif
@@ -0,0 +1,92 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/**
+ * @file parallel.h
+ * @author Lorenzo Calza
+ * @date 14 Oct 2026
+ * @brief Header file containing the declarations for the multi-threading utilities
+ *
+ * The parallel routines of the library (such as @ref alex_integrate_trap_par()) distribute
+ * their work through the primitives declared in this header file, on top of the thread pools of
+ * pool.h.
+ *
+ * **Notes**
+ * - These functions are intended for internal use, but they are exposed such that
+ *   user code may distribute work the same way.
+ * - Threads are provided by POSIX threads (`pthread`), as such programs using this header
+ *   must be linked with `-pthread`.
+ */
+
+#include <stddef.h>
+
+#ifndef _ALEX_PARALLEL_H
+/**
+ * @brief Include guard for this file
+ */
+#define _ALEX_PARALLEL_H
+
+/**
+ * @brief Typedef for the body of a parallel loop
+ *
+ * @param index the loop index
+ * @param ctx the context pointer passed to @ref alex_parallel_for()
+ */
+typedef void (*alex_par_body)(size_t index, void *ctx);
+
+/**
+ * @brief Returns the number of processors currently online
+ *
+ * If the number cannot be determined, `1` is returned.
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @return the number of processors
+ */
+unsigned int alex_cpu_count(void);
+
+/**
+ * @brief Runs the iterations of a loop on several threads
+ *
+ * Calls `body(i, ctx)` exactly once for every `i` in `0, 1, ..., count - 1`, using up to `threads`
+ * threads of the default pool (see @ref alex_default_pool()) including the calling one. Iterations
+ * are balanced by work stealing, as such the order in which they run and the thread running each of
+ * them are unspecified. This function returns once all iterations have completed. Loops started
+ * from within a running loop run on the calling thread alone (see pool.h).
+ *
+ * Deterministic results are obtained by having iteration `i` write to its own slot of an output
+ * array, and by combining the slots in index order afterwards.
+ *
+ * If `threads` is `0` or exceeds the size of the default pool, all the threads of the pool
+ * (one per processor) are used. If threads cannot be created, the iterations are run by the threads
+ * which could be created (ultimately by the calling thread alone).
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @param threads the maximum number of threads
+ * @param count the number of iterations
+ * @param body the loop body
+ * @param ctx the context pointer passed to `body`
+ */
+void alex_parallel_for(unsigned int threads, size_t count, alex_par_body body, void *ctx);
+
+#endif
@@ -26,7 +26,11 @@
  * `n`-dimensional polynomials as well as operations on polynomial spaces are declared in this header file.
  */
 
+#include <stddef.h>
+
+#include "arena.h"
 #include "diff.h"
+#include "flags.h"
 #include "func.h"
 
 #ifndef _ALEX_POLY_H
@@ -35,6 +39,39 @@
  */
 #define _ALEX_POLY_H
 
+/**
+ * @brief Operand length (degree + 1) from which @ref alex_poly_mul() uses Karatsuba's algorithm
+ *
+ * Products with a shorter operand use schoolbook multiplication.
+ */
+#ifndef ALEX_POLY_KARATSUBA_THRESHOLD
+#define ALEX_POLY_KARATSUBA_THRESHOLD 32u
+#endif
+
+/**
+ * @brief Operand length (degree + 1) from which @ref alex_poly_mul() uses FFT-based multiplication
+ *
+ * Applies to the shorter operand, see @ref ALEX_POLY_KARATSUBA_THRESHOLD.
+ */
+#ifndef ALEX_POLY_FFT_THRESHOLD
+#define ALEX_POLY_FFT_THRESHOLD 512u
+#endif
+
+/**
+ * @brief Number of bytes per term which suffices for the print-out of @ref alex_poly_print()
+ *
+ * A buffer of `(deg + 1) * ALEX_POLY_PRINT_BUFSIZE + 1` bytes holds the print-out of any polynomial
+ * of degree `deg` with the format `"%g"`. For arbitrary formats, see @ref alex_poly_snprintf().
+ */
+#define ALEX_POLY_PRINT_BUFSIZE 100
+
+/**
+ * @brief Size in bytes of the header of a serialized polynomial
+ *
+ * @see alex_poly_serialize()
+ */
+#define ALEX_POLY_SERIAL_HEADER 8u
+
 /**
  * @brief Represents a polynomial function of variable degree
  *
@@ -61,6 +98,12 @@
  * @ref alex_make_poly() should be **freed** by calling @ref alex_free_poly() after
  * lifespan has exceeded its usefulness.
  *
+ * The struct and its coefficients are stored in one contiguous block of memory, with `coeffs`
+ * pointing right behind the struct. The block may have room for more than `deg + 1` coefficients
+ * (see @ref alex_poly.cap), such that operations writing into an existing polynomial
+ * (ie. @ref alex_poly_integ_inplace()) can change its degree without reallocating. Polynomials which are needed only briefly can be allocated
+ * from an @ref alex_arena instead (see @ref alex_make_poly_arena()) and released in bulk.
+ *
  * @see alex_make_poly(), alex_free_poly(), alex_poly_deg(), alex_poly_coeff()
  */
 typedef struct {
@@ -68,6 +111,11 @@ typedef struct {
      * @brief The degree of the polynomial
      */
     unsigned int deg;
+    /**
+     * @brief The number of coefficients `coeffs` has room for (at least `deg + 1`), or `0` for
+     * the read-only views of @ref alex_poly_view()
+     */
+    unsigned int cap;
     /**
      * @brief The array containing the coefficients
      */
@@ -77,26 +125,64 @@ typedef struct {
 /**
  * @brief Constructs a poly struct and returns a pointer to it
  *
- * This function calls `malloc` and `calloc`, as such that the returned pointer must be freed
- * after its usefulness has passed. Do **not** use `free(alex_poly *)`, but instead
- * see @ref alex_free_poly().
+ * This function calls `malloc` once for the struct and its coefficients, as such that the returned
+ * pointer must be freed after its usefulness has passed. Do **not** use `free(alex_poly *)`,
+ * but instead see @ref alex_free_poly().
  *
  * If the size of `coeffs` is less than `deg` this function fails and causes undefined behaviour
  * due to out-of-bounds access (likely segmentation fault or use of garbage values).
  *
  * **Notes**
- *
- * The contents of the argument `coeffs` are copied over. As such, if the original version
- * does not serve any other purpose, it should be freed if it was dynamically allocated.
+ * - The contents of the argument `coeffs` are copied over. As such, if the original version
+ *   does not serve any other purpose, it should be freed if it was dynamically allocated.
+ * - If `coeffs` is `NULL`, all coefficients are initialized to `0`.
  *
  * @param deg the degree of the polynomial
  * @param coeffs the array containing the coefficients
  *
  * @returns the poly struct
- * @see alex_free_poly(), alex_poly_deg(), alex_poly_coeff(), alex_poly
+ * @see alex_free_poly(), alex_make_poly_arena(), alex_poly_deg(), alex_poly_coeff(), alex_poly
  */
 alex_poly *alex_make_poly(unsigned int deg, double coeffs[]);
 
+/**
+ * @brief Constructs a poly struct with extra capacity and returns a pointer to it
+ *
+ * This function works like @ref alex_make_poly(), except that room for `cap` coefficients is
+ * reserved (see @ref alex_poly.cap). The coefficients beyond the degree are initialized to `0`.
+ * This allows for the polynomial to be used as the destination of operations raising its degree,
+ * such as @ref alex_poly_integ_inplace(), without any further allocation.
+ *
+ * If `cap < deg + 1`, `NULL` is returned and the flag @ref ALEX_INV_PARAM_FLAG is set.
+ *
+ * @param deg the degree of the polynomial
+ * @param coeffs the array containing the coefficients (`NULL` for all zeros)
+ * @param cap the number of coefficients to reserve room for
+ *
+ * @returns the poly struct
+ * @see alex_make_poly(), alex_free_poly(), alex_poly_diff_into(), alex_poly_integ_into(), alex_poly
+ */
+alex_poly *alex_make_poly_cap(unsigned int deg, double coeffs[], unsigned int cap);
+
+/**
+ * @brief Constructs a poly struct within an arena and returns a pointer to it
+ *
+ * This function works like @ref alex_make_poly(), except that the memory is taken from
+ * `arena`. The returned polynomial is released together with all other blocks of the arena
+ * by @ref alex_arena_reset() or @ref alex_free_arena(), and must **not** be passed to
+ * @ref alex_free_poly().
+ *
+ * If `arena` is `NULL`, `NULL` is returned and the flag @ref ALEX_INV_PARAM_FLAG is set.
+ *
+ * @param deg the degree of the polynomial
+ * @param coeffs the array containing the coefficients (`NULL` for all zeros)
+ * @param arena the arena to allocate from
+ *
+ * @returns the poly struct
+ * @see alex_make_poly(), alex_poly_diff_arena(), alex_poly_integ_arena(), alex_poly_cpy_arena(), alex_arena
+ */
+alex_poly *alex_make_poly_arena(unsigned int deg, double coeffs[], alex_arena *arena);
+
 /**
  * @brief Frees the memory occupied by this struct
  *
@@ -107,10 +193,11 @@ alex_poly *alex_make_poly(unsigned int deg, double coeffs[]);
  * its useful time in order to avoid unnecessary memory leaks.
  *
  * **Notes**
- * - Please do not call `free(alex_poly*)` yourself as a part of the struct's fields must
- *   be freed as well.
+ * - Please do not call `free(alex_poly*)` yourself, the memory layout of @ref alex_poly is
+ *   an implementation detail.
  * - This function is intended to manage the calls to `free()` for @ref alex_poly
- *   objects constructed with @ref alex_make_poly().
+ *   objects constructed with @ref alex_make_poly(). Polynomials allocated within an
+ *   @ref alex_arena must not be passed to this function.
  * - This function will call `free()` blindly without checking whether `poly` is `NULL`
  *   or not eligible to calls to `free()`.
  *
@@ -130,15 +217,15 @@ void alex_free_poly(alex_poly *poly);
  * **Notes**
  * - The printed string is appended at the end of the `dest` argument
  *   (concatenated, see `strcat()`). As such, you must make sure that the
- *   `dest` buffer is large enough. If it is not, buffer overflow will occur,
- *   probably causing internal "damage".
+ *   `dest` buffer is large enough (see @ref ALEX_POLY_PRINT_BUFSIZE). If it is not,
+ *   buffer overflow will occur, probably causing internal "damage".
  * - See @ref alex_poly_printf() for an example and more information.
  *
  * @param poly the polynomial to print
  * @param dest the buffer
  * @return the polynomial printed into a `char *`
  *
- * @see alex_poly_printf(), alex_poly
+ * @see alex_poly_printf(), alex_poly_snprintf(), alex_poly
  */
 char *alex_poly_print(alex_poly *poly, char *dest);
 
@@ -164,17 +251,154 @@ char *alex_poly_print(alex_poly *poly, char *dest);
  * - The printed string is appended at the end of the `dest` argument
  *   (concatenated, see `strcat()`). As such, you must make sure that the
  *   `dest` buffer is large enough. If it is not, buffer overflow will occur,
- *   probably causing internal "damage".
+ *   probably causing internal "damage". Prefer @ref alex_poly_snprintf(), which is bounded.
+ * - The end of `dest` is looked up once, as such the running time is linear in the degree.
  *
  * @param poly the polynomial to print
  * @param dest destination buffer
  * @param format the format specifier for the coefficients
  * @return the polynomial printed into a `char *`
  *
- * @see alex_poly_print(), alex_poly
+ * @see alex_poly_print(), alex_poly_snprintf(), alex_poly
  */
 char *alex_poly_printf(alex_poly *poly, char *dest, const char *format);
 
+/**
+ * @brief Bounded pretty print function for polynomials
+ *
+ * Prints the polynomial the same way as @ref alex_poly_printf(), but into the first `size` bytes
+ * of `dest` (overwriting, not appending), with the same semantics as `snprintf()`: the output is
+ * truncated to `size - 1` characters and always terminated by `'\0'` if `size` is not `0`.
+ * The return value is the length of the complete string, as such a buffer of the right size
+ * can be obtained by calling this function twice:
+ *
+ *     size_t len = alex_poly_snprintf(poly, NULL, 0, "%.17g");
+ *     char *buf = malloc(len + 1);
+ *     alex_poly_snprintf(poly, buf, len + 1, "%.17g");
+ *
+ * The flag is set to @ref ALEX_INV_PARAM_FLAG if `poly` or `format` is `NULL` (or `format` is rejected
+ * by `snprintf()`), in which case `0` is returned, to @ref ALEX_BUF_SIZE_FLAG if the output was
+ * truncated and to @ref ALEX_OK_FLAG otherwise.
+ *
+ * @param poly the polynomial to print
+ * @param dest destination buffer (may be `NULL` if `size` is `0`)
+ * @param size the size of `dest` in bytes
+ * @param format the format specifier for the coefficients
+ * @return the length of the complete print-out, without the terminating `'\0'`
+ *
+ * @see alex_poly_printf(), alex_poly
+ */
+size_t alex_poly_snprintf(alex_poly *poly, char *dest, size_t size, const char *format);
+
+/**
+ * @brief The size in bytes of the serialized form of a polynomial
+ *
+ * A serialized polynomial of degree `deg` takes `ALEX_POLY_SERIAL_HEADER + (deg + 1) * sizeof(double)`
+ * bytes. A multiple of `sizeof(double)`, such that serialized polynomials stored one after the other
+ * all remain aligned.
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @param poly the polynomial (`0` is returned if it is `NULL`)
+ * @return the number of bytes written by @ref alex_poly_serialize()
+ *
+ * @see alex_poly_serialize()
+ */
+size_t alex_poly_serial_size(alex_poly *poly);
+
+/**
+ * @brief Serializes a polynomial into a compact binary record
+ *
+ * The record consists of the 4 signature bytes `"ALXP"`, the degree as a 32-bit unsigned integer
+ * and the `deg + 1` coefficients as `double`s, all in the byte order of the host. Nothing is
+ * parsed upon reading, as such records can be memory-mapped and used in place through
+ * @ref alex_poly_view().
+ *
+ * If `size` is less than @ref alex_poly_serial_size() nothing is written and the flag
+ * @ref ALEX_BUF_SIZE_FLAG is set, the record size being returned nonetheless.
+ * If `poly` is `NULL`, `0` is returned and the flag @ref ALEX_INV_PARAM_FLAG is set.
+ *
+ * @param poly the polynomial
+ * @param dest the destination buffer
+ * @param size the size of `dest` in bytes
+ * @return the size of the record
+ *
+ * @see alex_poly_deserialize(), alex_poly_view(), alex_poly_serial_size()
+ */
+size_t alex_poly_serialize(alex_poly *poly, void *dest, size_t size);
+
+/**
+ * @brief Reads a polynomial from its serialized form
+ *
+ * Allocates a new polynomial (see @ref alex_make_poly()) holding a copy of the record at the start
+ * of `src`. The size of the record is stored in `*used`, which allows reading a sequence of records.
+ *
+ * If the first `size` bytes of `src` do not start with a complete record written by
+ * @ref alex_poly_serialize() on a host of the same byte order, `NULL` is returned and the flag
+ * @ref ALEX_POLY_FORMAT_FLAG is set.
+ *
+ * @param src the serialized data (no alignment required)
+ * @param size the number of bytes available at `src`
+ * @param used where the size of the record is stored (may be `NULL`)
+ * @return the polynomial, or `NULL` on failure
+ *
+ * @see alex_poly_serialize(), alex_poly_deserialize_arena(), alex_poly_view()
+ */
+alex_poly *alex_poly_deserialize(const void *src, size_t size, size_t *used);
+
+/**
+ * @brief Reads a polynomial from its serialized form, allocating it from an arena
+ *
+ * Behaves like @ref alex_poly_deserialize(), except that the polynomial is allocated
+ * from `arena` (see @ref alex_make_poly_arena()).
+ *
+ * @param src the serialized data (no alignment required)
+ * @param size the number of bytes available at `src`
+ * @param used where the size of the record is stored (may be `NULL`)
+ * @param arena the arena
+ * @return the polynomial, or `NULL` on failure
+ *
+ * @see alex_poly_deserialize(), alex_make_poly_arena()
+ */
+alex_poly *alex_poly_deserialize_arena(const void *src, size_t size, size_t *used, alex_arena *arena);
+
+/**
+ * @brief Views a serialized polynomial in place, without copying it
+ *
+ * Fills `*view` such that its coefficients point into `src`. The view may be passed to any routine
+ * which only reads its argument (evaluation, integration, printing...), at no cost other than the
+ * validation of the header.
+ *
+ * **Example**
+ *
+ *     // data: a memory-mapped file of serialized polynomials
+ *     alex_poly view;
+ *     size_t used;
+ *     for (size_t off = 0; alex_poly_view(data + off, len - off, &view, &used) != NULL; off += used) {
+ *         sum += alex_poly_eval(&view, x);
+ *     }
+ *
+ * **Notes**
+ * - `src` must be aligned to `double` (as are records stored one after the other from an
+ *   aligned address, see @ref alex_poly_serial_size()) and outlive the view.
+ * - The view must neither be modified nor passed to @ref alex_free_poly(). Its @ref alex_poly.cap is
+ *   `0`, as such the routines writing into a polynomial (ie. @ref alex_poly_diff_inplace() or
+ *   @ref alex_poly_cpy_into()) reject it with @ref ALEX_POLY_CAP_FLAG rather than writing into `src`.
+ * - If the record is invalid or misaligned, `NULL` is returned and the flag @ref ALEX_POLY_FORMAT_FLAG
+ *   is set (@ref ALEX_INV_PARAM_FLAG if `view` is `NULL`).
+ *
+ * @param src the serialized data
+ * @param size the number of bytes available at `src`
+ * @param view the polynomial struct to fill
+ * @param used where the size of the record is stored (may be `NULL`)
+ * @return `view`, or `NULL` on failure
+ *
+ * @see alex_poly_serialize(), alex_poly_deserialize()
+ */
+alex_poly *alex_poly_view(const void *src, size_t size, alex_poly *view, size_t *used);
+
 /**
  * @brief The degree of the polynomial
  *
@@ -246,14 +470,158 @@ double alex_poly_coeff(alex_poly *poly, unsigned int index);
  *
  * This evaluates the polynomial function value at the location `x`.
  *
+ * The value is computed with Horner's scheme
+ *
+ * \f$P_n(x) = c_0 + x(c_1 + x(c_2 + ... + x(c_{n-1} + x c_n)))\f$,
+ *
+ * which takes \f$n\f$ multiplications and \f$n\f$ additions and no calls to `pow()`.
+ *
  * @param poly the polynomial
  * @param x the location at which the function should be evalued
  * @return the function value
  *
- * @see alex_poly_coeff(), alex_poly
+ * @see alex_poly_eval_many(), alex_poly_coeff(), alex_poly
  */
 double alex_poly_eval(alex_poly *poly, double x);
 
+/**
+ * @brief Reentrant variant of @ref alex_poly_eval()
+ *
+ * Computes the same value as @ref alex_poly_eval(), but stores it in `*res` and returns
+ * the flag instead of setting it. This function never accesses the flag.
+ *
+ * @param poly the polynomial
+ * @param x the location at which the function should be evalued
+ * @param res where the function value is stored (`0` on failure)
+ * @return @ref ALEX_OK_FLAG, or @ref ALEX_INV_PARAM_FLAG if `poly` is `NULL`
+ *
+ * @see alex_poly_eval()
+ */
+int alex_poly_eval_r(alex_poly *poly, double x, double *res);
+
+#if defined(ALEX_INLINE)
+/*
+ * Header mode, see the notes of flags.h. The Horner loop performs the very operations of the
+ * one in poly.c, such that inlined and library evaluations yield identical results, as long as
+ * the caller's flags do not contract them into fused multiply-adds (see alex_poly_eval_many()).
+ */
+static inline unsigned int _alex_poly_deg(alex_poly *poly) {
+    if (poly == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return 0;
+    }
+
+    alex_set_flag(ALEX_OK_FLAG);
+    return poly->deg;
+}
+
+static inline double _alex_poly_lead(alex_poly *poly) {
+    if (poly == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return 0.;
+    }
+
+    alex_set_flag(ALEX_OK_FLAG);
+    return poly->coeffs[poly->deg];
+}
+
+static inline double _alex_poly_trail(alex_poly *poly) {
+    if (poly == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return 0.;
+    }
+
+    alex_set_flag(ALEX_OK_FLAG);
+    return poly->coeffs[0];
+}
+
+static inline double _alex_poly_coeff(alex_poly *poly, unsigned int index) {
+    if (index > poly->deg) {
+        alex_set_flag(ALEX_POLY_INDEX_GT_DEG_FLAG);
+        return _alex_poly_lead(poly);
+    }
+
+    alex_set_flag(ALEX_OK_FLAG);
+    return poly->coeffs[index];
+}
+
+static inline int _alex_poly_eval_r(alex_poly *poly, double x, double *res) {
+    if (poly == NULL) {
+        *res = 0.;
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    double acc = poly->coeffs[poly->deg];
+    for (unsigned int i = poly->deg; i-- > 0;) {
+        acc = acc * x + poly->coeffs[i];
+    }
+    *res = acc;
+    return ALEX_OK_FLAG;
+}
+
+static inline double _alex_poly_eval(alex_poly *poly, double x) {
+    double res;
+    alex_set_flag(_alex_poly_eval_r(poly, x, &res));
+    return res;
+}
+
+#define alex_poly_deg(poly) _alex_poly_deg(poly)
+#define alex_poly_lead(poly) _alex_poly_lead(poly)
+#define alex_poly_trail(poly) _alex_poly_trail(poly)
+#define alex_poly_coeff(poly, index) _alex_poly_coeff(poly, index)
+#define alex_poly_eval(poly, x) _alex_poly_eval(poly, x)
+#define alex_poly_eval_r(poly, x, res) _alex_poly_eval_r(poly, x, res)
+#endif
+
+/**
+ * @brief Evaluates the polynomial function at several points at once
+ *
+ * This function is equivalent to
+ *
+ *     for (size_t j = 0; j < n; ++j)
+ *         out[j] = alex_poly_eval(poly, xs[j]);
+ *
+ * but evaluates Horner's scheme on several points simultaneously using the vector
+ * instructions available on the machine (SSE2 or AVX2 on x86, NEON on AArch64).
+ * The kernel is chosen at runtime, so the same binary makes use of AVX2 wherever it is
+ * supported. Every point undergoes the very same sequence of floating point operations as in
+ * @ref alex_poly_eval(), as such the results are identical to those of the single point version.
+ *
+ * **Notes**
+ * - The library is compiled without the contraction of multiplications and additions into fused
+ *   multiply-adds, whatever the compiler flags, as such the results are identical on every target and
+ *   instruction set. With `ALEX_INLINE` (see flags.h) however, @ref alex_poly_eval() is compiled with
+ *   the caller's flags, which may contract it (eg. GCC with `-march=native`, unless `-ffp-contract=off`).
+ * - `xs` and `out` must contain at least `n` doubles each. They may be the same array
+ *   (evaluation in-place), but must not overlap otherwise.
+ * - If `poly` is `NULL`, or `xs` or `out` are `NULL` while `n > 0`, nothing is evaluated
+ *   and the flag @ref ALEX_INV_PARAM_FLAG is set.
+ *
+ * @param poly the polynomial
+ * @param xs the locations at which the function should be evaluated
+ * @param out the buffer receiving the function values
+ * @param n the number of points
+ *
+ * @see alex_poly_eval(), alex_poly
+ */
+void alex_poly_eval_many(alex_poly *poly, const double *xs, double *out, size_t n);
+
+/**
+ * @brief Reentrant variant of @ref alex_poly_eval_many()
+ *
+ * Behaves like @ref alex_poly_eval_many(), but returns the flag instead of setting it.
+ * This function never accesses the flag.
+ *
+ * @param poly the polynomial
+ * @param xs the locations at which the function should be evaluated
+ * @param out the buffer receiving the function values
+ * @param n the number of points
+ * @return @ref ALEX_OK_FLAG or @ref ALEX_INV_PARAM_FLAG
+ *
+ * @see alex_poly_eval_many()
+ */
+int alex_poly_eval_many_r(alex_poly *poly, const double *xs, double *out, size_t n);
+
 /**
  * @brief Determines the derivative of the polynomial function
  *
@@ -271,10 +639,67 @@ double alex_poly_eval(alex_poly *poly, double x);
  * @param poly the polynomial to differentiate
  * @return the first derivative
  *
- * @see alex_poly_integ(), alex_poly
+ * @see alex_poly_integ(), alex_poly_diff_arena(), alex_poly
  */
 alex_poly *alex_poly_diff(alex_poly *poly);
 
+/**
+ * @brief Determines the derivative of the polynomial function within an arena
+ *
+ * This function works like @ref alex_poly_diff(), except that the derivative is allocated
+ * from `arena` (see @ref alex_make_poly_arena()).
+ *
+ * @param poly the polynomial to differentiate
+ * @param arena the arena to allocate from
+ * @return the first derivative
+ *
+ * @see alex_poly_diff(), alex_make_poly_arena()
+ */
+alex_poly *alex_poly_diff_arena(alex_poly *poly, alex_arena *arena);
+
+/**
+ * @brief Determines the derivative of the polynomial function and stores it in an existing one
+ *
+ * This function computes the same derivative as @ref alex_poly_diff(), but writes it into `dst`
+ * instead of allocating a new polynomial. The degree of `dst` is updated accordingly.
+ * `dst` and `src` may be the same polynomial (see @ref alex_poly_diff_inplace()).
+ *
+ * `dst` must have room for at least `deg(src)` coefficients (one if `src` is constant). If it does
+ * not, `dst` is left untouched, `NULL` is returned and the flag @ref ALEX_POLY_CAP_FLAG is set.
+ *
+ * **Example**
+ *
+ *     alex_poly *dp = alex_make_poly(alex_poly_deg(p), NULL);
+ *     for (int i = 0; i < iterations; ++i) {
+ *         alex_poly_diff_into(dp, p); // no allocation
+ *         x -= alex_poly_eval(p, x) / alex_poly_eval(dp, x);
+ *         // ...
+ *     }
+ *
+ * @param dst the polynomial receiving the derivative
+ * @param src the polynomial to differentiate
+ * @return `dst`, or `NULL` on failure
+ *
+ * @see alex_poly_diff(), alex_poly_diff_inplace(), alex_poly_integ_into(), alex_make_poly_cap()
+ */
+alex_poly *alex_poly_diff_into(alex_poly *dst, alex_poly *src);
+
+/**
+ * @brief Differentiates the polynomial function in-place
+ *
+ * This is equivalent to
+ *
+ *     alex_poly_diff_into(poly, poly)
+ *
+ * and never fails for lack of capacity.
+ *
+ * @param poly the polynomial to differentiate
+ * @return `poly`, or `NULL` on failure
+ *
+ * @see alex_poly_diff_into(), alex_poly_integ_inplace()
+ */
+alex_poly *alex_poly_diff_inplace(alex_poly *poly);
+
 /**
  * @brief Determines the antiderivative (indefinite integral) of the polynomial function
  *
@@ -295,10 +720,62 @@ alex_poly *alex_poly_diff(alex_poly *poly);
  * @param c the integration constant
  * @return the antiderivative
  *
- * @see alex_poly_diff(), alex_poly
+ * @see alex_poly_diff(), alex_poly_integ_arena(), alex_poly
  */
 alex_poly *alex_poly_integ(alex_poly *poly, double c);
 
+/**
+ * @brief Determines the antiderivative of the polynomial function within an arena
+ *
+ * This function works like @ref alex_poly_integ(), except that the antiderivative is allocated
+ * from `arena` (see @ref alex_make_poly_arena()).
+ *
+ * @param poly the polynomial to integrate
+ * @param c the integration constant
+ * @param arena the arena to allocate from
+ * @return the antiderivative
+ *
+ * @see alex_poly_integ(), alex_make_poly_arena()
+ */
+alex_poly *alex_poly_integ_arena(alex_poly *poly, double c, alex_arena *arena);
+
+/**
+ * @brief Determines the antiderivative of the polynomial function and stores it in an existing one
+ *
+ * This function computes the same antiderivative as @ref alex_poly_integ(), but writes it into `dst`
+ * instead of allocating a new polynomial. The degree of `dst` is updated accordingly.
+ * `dst` and `src` may be the same polynomial (see @ref alex_poly_integ_inplace()).
+ *
+ * `dst` must have room for at least `deg(src) + 2` coefficients. If it does not, `dst` is left
+ * untouched, `NULL` is returned and the flag @ref ALEX_POLY_CAP_FLAG is set.
+ *
+ * @param dst the polynomial receiving the antiderivative
+ * @param src the polynomial to integrate
+ * @param c the integration constant
+ * @return `dst`, or `NULL` on failure
+ *
+ * @see alex_poly_integ(), alex_poly_integ_inplace(), alex_poly_diff_into(), alex_make_poly_cap()
+ */
+alex_poly *alex_poly_integ_into(alex_poly *dst, alex_poly *src, double c);
+
+/**
+ * @brief Integrates the polynomial function in-place
+ *
+ * This is equivalent to
+ *
+ *     alex_poly_integ_into(poly, poly, c)
+ *
+ * As such, it requires `poly` to have room for one more coefficient than its current degree
+ * requires (see @ref alex_make_poly_cap()), otherwise the flag @ref ALEX_POLY_CAP_FLAG is set.
+ *
+ * @param poly the polynomial to integrate
+ * @param c the integration constant
+ * @return `poly`, or `NULL` on failure
+ *
+ * @see alex_poly_integ_into(), alex_poly_diff_inplace()
+ */
+alex_poly *alex_poly_integ_inplace(alex_poly *poly, double c);
+
 /**
  * @brief Determines the definite integral of the polynomial function
  * over a given range
@@ -319,6 +796,8 @@ alex_poly *alex_poly_integ(alex_poly *poly, double c);
  *
  *     alex_free_poly(antid);
  *
+ * except that the antiderivative is evaluated on the fly and never allocated.
+ *
  * @param poly the polynomial to integrate
  * @param range the integration interval
  * @return the definite integral
@@ -327,6 +806,21 @@ alex_poly *alex_poly_integ(alex_poly *poly, double c);
  */
 double alex_poly_integ_range(alex_poly *poly, alex_range *range);
 
+/**
+ * @brief Reentrant variant of @ref alex_poly_integ_range()
+ *
+ * Computes the same value as @ref alex_poly_integ_range(), but stores it in `*res` and returns
+ * the flag instead of setting it. This function never accesses the flag.
+ *
+ * @param poly the polynomial to integrate
+ * @param range the integration interval
+ * @param res where the definite integral is stored (`0` on failure)
+ * @return @ref ALEX_OK_FLAG, or @ref ALEX_INV_PARAM_FLAG if `poly` or `range` is `NULL`
+ *
+ * @see alex_poly_integ_range()
+ */
+int alex_poly_integ_range_r(alex_poly *poly, alex_range *range, double *res);
+
 /**
  * @deprecated See the rest of the documentation for why this is deprecated
  *
@@ -340,9 +834,11 @@ double alex_poly_integ_range(alex_poly *poly, alex_range *range);
  * is by setting an `static` variable of type @ref alex_poly* internal to the implementation to
  * the argument. That means that if you perform two subsequent calls to this function, the value
  * will be overwritten by the second call, meaning that the object returned by the first call
- * will be working exactly like the second.
+ * will be working exactly like the second. The variable is shared by all threads, as such calls
+ * to this function from several threads at once race with each other.
  *
- * For this reason, this implementation is sub-optimal and **deprecated**. If you require a more stable
+ * For this reason, this implementation is sub-optimal and **deprecated**. Use @ref alex_poly_closure()
+ * together with the reentrant (`_r`) routines instead. If you require a more stable
  * way to construct @ref alex_func_1d objects, define a function yourself in this way:
  *
  *     alex_poly *poly;
@@ -359,10 +855,53 @@ double alex_poly_integ_range(alex_poly *poly, alex_range *range);
  * @param poly the struct representing the polynomial
  * @return the @ref alex_func_1d object
  *
- * @see alex_func_1d, alex_poly
+ * @see alex_poly_closure(), alex_func_1d, alex_poly
  */
 alex_func_1d alex_poly_func(alex_poly *poly);
 
+/**
+ * @brief Returns an @ref alex_closure_1d representing this polynomial function.
+ *
+ * Unlike @ref alex_poly_func(), the returned closure carries the polynomial as its context,
+ * as such any number of polynomial closures may be in use at the same time, from any thread.
+ * The closure evaluates the polynomial exactly like @ref alex_poly_eval(), without accessing
+ * the flag.
+ *
+ * **Example**
+ *
+ *     double area;
+ *     alex_closure_1d f = alex_poly_closure(poly);
+ *     alex_integrate_trap_r(f, range, 100, &area);
+ *
+ * **Notes**
+ *
+ * The closure refers to `poly` rather than copying it, as such `poly` must outlive
+ * any use of the closure.
+ *
+ * @param poly the struct representing the polynomial
+ * @return the @ref alex_closure_1d object (with a `NULL` function if `poly` is `NULL`)
+ *
+ * @see alex_closure_1d, alex_poly_func(), alex_poly
+ */
+alex_closure_1d alex_poly_closure(alex_poly *poly);
+
+/**
+ * @brief Returns an @ref alex_vclosure_1d representing this polynomial function.
+ *
+ * The returned closure evaluates blocks of points with the vector kernels of
+ * @ref alex_poly_eval_many(), as such polynomials can be passed directly to the vectorized
+ * integrators (such as @ref alex_integrate_trap_vec()). The closure does not access the flag.
+ *
+ * The closure refers to `poly` rather than copying it, as such `poly` must outlive
+ * any use of the closure.
+ *
+ * @param poly the struct representing the polynomial
+ * @return the @ref alex_vclosure_1d object (with a `NULL` function if `poly` is `NULL`)
+ *
+ * @see alex_vclosure_1d, alex_poly_closure(), alex_poly_eval_many(), alex_poly
+ */
+alex_vclosure_1d alex_poly_vclosure(alex_poly *poly);
+
 /**
  * @brief Indicates whether or not this polynomial is constant
  *
@@ -404,8 +943,304 @@ int alex_poly_cmp(alex_poly *p, alex_poly *q);
  * @param poly the original object
  * @return the copy of the object
  *
- * @see alex_make_poly(), alex_poly
+ * @see alex_make_poly(), alex_poly_cpy_arena(), alex_poly
  */
 alex_poly *alex_poly_cpy(alex_poly *poly);
 
-#endif
\ No newline at end of file
+/**
+ * @brief Duplicates the polynomial within an arena
+ *
+ * This function works like @ref alex_poly_cpy(), except that the copy is allocated
+ * from `arena` (see @ref alex_make_poly_arena()).
+ *
+ * @param poly the original object
+ * @param arena the arena to allocate from
+ * @return the copy of the object
+ *
+ * @see alex_poly_cpy(), alex_make_poly_arena()
+ */
+alex_poly *alex_poly_cpy_arena(alex_poly *poly, alex_arena *arena);
+
+/**
+ * @brief Copies the polynomial into an existing one
+ *
+ * The degree and coefficients of `src` are copied over to `dst`, which must have room for
+ * at least `deg(src) + 1` coefficients. If it does not, `dst` is left untouched, `NULL` is returned
+ * and the flag @ref ALEX_POLY_CAP_FLAG is set.
+ *
+ * @param dst the destination
+ * @param src the original object
+ * @return `dst`, or `NULL` on failure
+ *
+ * @see alex_poly_cpy(), alex_make_poly_cap()
+ */
+alex_poly *alex_poly_cpy_into(alex_poly *dst, alex_poly *src);
+
+/**
+ * @brief Adds two polynomials
+ *
+ * Returns a new polynomial holding \f$p + q\f$. Its degree is that of the largest nonzero
+ * coefficient, ie. leading coefficients cancelling each other out lower the degree (to `0` at
+ * least).
+ *
+ * The flag is set to @ref ALEX_INV_PARAM_FLAG if either argument is `NULL`, to
+ * @ref ALEX_BAD_ALLOC_FLAG if the allocation failed (in both cases `NULL` is returned) and to
+ * @ref ALEX_OK_FLAG otherwise.
+ *
+ * @param p the first summand
+ * @param q the second summand
+ * @return the sum, or `NULL` on failure
+ *
+ * @see alex_poly_add_arena(), alex_poly_add_into(), alex_poly_sub()
+ */
+alex_poly *alex_poly_add(alex_poly *p, alex_poly *q);
+
+/**
+ * @brief Adds two polynomials within an arena
+ *
+ * This function works like @ref alex_poly_add(), except that the sum is allocated from `arena`
+ * (see @ref alex_make_poly_arena()).
+ *
+ * @param p the first summand
+ * @param q the second summand
+ * @param arena the arena to allocate from
+ * @return the sum, or `NULL` on failure
+ *
+ * @see alex_poly_add()
+ */
+alex_poly *alex_poly_add_arena(alex_poly *p, alex_poly *q, alex_arena *arena);
+
+/**
+ * @brief Adds two polynomials and stores the sum in an existing one
+ *
+ * This function computes the same sum as @ref alex_poly_add(), but writes it into `dst`, which
+ * may be `p` or `q`. `dst` must have room for at least \f$\max(\deg p, \deg q) + 1\f$ coefficients.
+ * If it does not, `dst` is left untouched, `NULL` is returned and the flag
+ * @ref ALEX_POLY_CAP_FLAG is set.
+ *
+ * @param dst the polynomial receiving the sum
+ * @param p the first summand
+ * @param q the second summand
+ * @return `dst`, or `NULL` on failure
+ *
+ * @see alex_poly_add(), alex_make_poly_cap()
+ */
+alex_poly *alex_poly_add_into(alex_poly *dst, alex_poly *p, alex_poly *q);
+
+/**
+ * @brief Subtracts two polynomials
+ *
+ * Returns a new polynomial holding \f$p - q\f$, see @ref alex_poly_add() for the degree and flags.
+ *
+ * @param p the minuend
+ * @param q the subtrahend
+ * @return the difference, or `NULL` on failure
+ *
+ * @see alex_poly_sub_arena(), alex_poly_sub_into(), alex_poly_add()
+ */
+alex_poly *alex_poly_sub(alex_poly *p, alex_poly *q);
+
+/**
+ * @brief Subtracts two polynomials within an arena
+ *
+ * This function works like @ref alex_poly_sub(), except that the difference is allocated from
+ * `arena` (see @ref alex_make_poly_arena()).
+ *
+ * @param p the minuend
+ * @param q the subtrahend
+ * @param arena the arena to allocate from
+ * @return the difference, or `NULL` on failure
+ *
+ * @see alex_poly_sub()
+ */
+alex_poly *alex_poly_sub_arena(alex_poly *p, alex_poly *q, alex_arena *arena);
+
+/**
+ * @brief Subtracts two polynomials and stores the difference in an existing one
+ *
+ * See @ref alex_poly_add_into() for the requirements on `dst`.
+ *
+ * @param dst the polynomial receiving the difference
+ * @param p the minuend
+ * @param q the subtrahend
+ * @return `dst`, or `NULL` on failure
+ *
+ * @see alex_poly_sub(), alex_poly_add_into()
+ */
+alex_poly *alex_poly_sub_into(alex_poly *dst, alex_poly *p, alex_poly *q);
+
+/**
+ * @brief Multiplies two polynomials
+ *
+ * Returns a new polynomial of degree \f$\deg p + \deg q\f$ holding \f$p\cdot q\f$. The algorithm is
+ * chosen by the length of the shorter operand:
+ * - below @ref ALEX_POLY_KARATSUBA_THRESHOLD, the schoolbook method (\f$O(nm)\f$),
+ * - below @ref ALEX_POLY_FFT_THRESHOLD, Karatsuba's algorithm (\f$O(n^{1.58})\f$), applied
+ *   blockwise if the operands differ in length,
+ * - otherwise, a complex FFT of both operands (\f$O(n\log n)\f$).
+ *
+ * **Notes**
+ * - The FFT-based product has an absolute error on the order of
+ *   \f$\varepsilon\log_2 n\cdot\|p\|\|q\|\f$ for every coefficient, rather than an error relative to
+ *   each coefficient. Small coefficients of a product of polynomials whose coefficients vary by
+ *   many orders of magnitude thus lose accuracy.
+ * - All but the schoolbook method allocate scratch memory from the heap.
+ *
+ * The flag is set to @ref ALEX_INV_PARAM_FLAG if either argument is `NULL` or the degree of the
+ * product does not fit into an `unsigned int`, to @ref ALEX_BAD_ALLOC_FLAG if any allocation failed
+ * (in both cases `NULL` is returned) and to @ref ALEX_OK_FLAG otherwise.
+ *
+ * @param p the first factor
+ * @param q the second factor
+ * @return the product, or `NULL` on failure
+ *
+ * @see alex_poly_mul_arena(), alex_poly_mul_into()
+ */
+alex_poly *alex_poly_mul(alex_poly *p, alex_poly *q);
+
+/**
+ * @brief Multiplies two polynomials within an arena
+ *
+ * This function works like @ref alex_poly_mul(), except that the product is allocated from
+ * `arena` (see @ref alex_make_poly_arena()). Scratch memory still comes from the heap.
+ *
+ * @param p the first factor
+ * @param q the second factor
+ * @param arena the arena to allocate from
+ * @return the product, or `NULL` on failure
+ *
+ * @see alex_poly_mul()
+ */
+alex_poly *alex_poly_mul_arena(alex_poly *p, alex_poly *q, alex_arena *arena);
+
+/**
+ * @brief Multiplies two polynomials and stores the product in an existing one
+ *
+ * This function computes the same product as @ref alex_poly_mul(), but writes it into `dst`,
+ * which may be `p` or `q`. `dst` must have room for at least \f$\deg p + \deg q + 1\f$ coefficients.
+ * If it does not, `dst` is left untouched, `NULL` is returned and the flag
+ * @ref ALEX_POLY_CAP_FLAG is set.
+ *
+ * @param dst the polynomial receiving the product
+ * @param p the first factor
+ * @param q the second factor
+ * @return `dst`, or `NULL` on failure
+ *
+ * @see alex_poly_mul(), alex_make_poly_cap()
+ */
+alex_poly *alex_poly_mul_into(alex_poly *dst, alex_poly *p, alex_poly *q);
+
+/**
+ * @brief Divides two polynomials with remainder
+ *
+ * Determines the quotient \f$s\f$ and the remainder \f$r\f$ such that \f$p = s\cdot d + r\f$ with
+ * \f$\deg r < \deg d\f$, by long division in \f$O((\deg p - \deg d + 1)\deg d)\f$. Leading zero
+ * coefficients of `d` are ignored. If \f$\deg p < \deg d\f$, the quotient is \f$0\f$ and the
+ * remainder is \f$p\f$.
+ *
+ * The quotient is returned, the remainder is stored in `*rem` unless `rem` is `NULL`. Both are
+ * new polynomials, to be freed with @ref alex_free_poly().
+ *
+ * The flag is set to @ref ALEX_ALG_INV_OP_FLAG if `d` is the zero polynomial, to
+ * @ref ALEX_INV_PARAM_FLAG if `p` or `d` is `NULL`, to @ref ALEX_BAD_ALLOC_FLAG if any allocation
+ * failed (in all of which cases `NULL` is returned and `*rem` is untouched) and to
+ * @ref ALEX_OK_FLAG otherwise.
+ *
+ * @param p the dividend
+ * @param d the divisor
+ * @param rem where the remainder is stored, may be `NULL`
+ * @return the quotient, or `NULL` on failure
+ *
+ * @see alex_poly_divmod_arena(), alex_poly_divmod_into(), alex_poly_mul()
+ */
+alex_poly *alex_poly_divmod(alex_poly *p, alex_poly *d, alex_poly **rem);
+
+/**
+ * @brief Divides two polynomials with remainder within an arena
+ *
+ * This function works like @ref alex_poly_divmod(), except that the quotient and the remainder are
+ * allocated from `arena` (see @ref alex_make_poly_arena()).
+ *
+ * @param p the dividend
+ * @param d the divisor
+ * @param rem where the remainder is stored, may be `NULL`
+ * @param arena the arena to allocate from
+ * @return the quotient, or `NULL` on failure
+ *
+ * @see alex_poly_divmod()
+ */
+alex_poly *alex_poly_divmod_arena(alex_poly *p, alex_poly *d, alex_poly **rem, alex_arena *arena);
+
+/**
+ * @brief Divides two polynomials with remainder and stores the results in existing ones
+ *
+ * This function computes the same quotient and remainder as @ref alex_poly_divmod(), but writes
+ * them into `quot` and `rem` (which may be `NULL`). Any of `quot`, `rem` may be `p` or `d`, but not
+ * each other. With \f$n = \deg p\f$ and \f$m\f$ the degree of `d` without leading zeros, `quot` must
+ * have room for \f$n - m + 1\f$ coefficients (one if \f$n < m\f$) and `rem` for \f$m\f$ (one if
+ * \f$m = 0\f$, \f$n + 1\f$ if \f$n < m\f$). If they do not, both are left untouched, `NULL` is returned
+ * and the flag @ref ALEX_POLY_CAP_FLAG is set.
+ *
+ * @param quot the polynomial receiving the quotient
+ * @param rem the polynomial receiving the remainder, may be `NULL`
+ * @param p the dividend
+ * @param d the divisor
+ * @return `quot`, or `NULL` on failure
+ *
+ * @see alex_poly_divmod()
+ */
+alex_poly *alex_poly_divmod_into(alex_poly *quot, alex_poly *rem, alex_poly *p, alex_poly *d);
+
+/**
+ * @brief Composes two polynomials
+ *
+ * Returns a new polynomial of degree \f$\deg p\cdot\deg q\f$ holding \f$p(q(x))\f$. It is computed
+ * with Horner's scheme over polynomials, \f$r \leftarrow r\cdot q + p_k\f$, where every product is
+ * computed like by @ref alex_poly_mul(), such that the large products towards the end use the fast
+ * multiplication algorithms.
+ *
+ * The flag is set to @ref ALEX_INV_PARAM_FLAG if either argument is `NULL` or the degree of the
+ * result does not fit into an `unsigned int`, to @ref ALEX_BAD_ALLOC_FLAG if any allocation failed
+ * (in both cases `NULL` is returned) and to @ref ALEX_OK_FLAG otherwise.
+ *
+ * @param p the outer polynomial
+ * @param q the inner polynomial
+ * @return the composition, or `NULL` on failure
+ *
+ * @see alex_poly_compose_arena(), alex_poly_compose_into(), alex_poly_mul()
+ */
+alex_poly *alex_poly_compose(alex_poly *p, alex_poly *q);
+
+/**
+ * @brief Composes two polynomials within an arena
+ *
+ * This function works like @ref alex_poly_compose(), except that the result is allocated from
+ * `arena` (see @ref alex_make_poly_arena()).
+ *
+ * @param p the outer polynomial
+ * @param q the inner polynomial
+ * @param arena the arena to allocate from
+ * @return the composition, or `NULL` on failure
+ *
+ * @see alex_poly_compose()
+ */
+alex_poly *alex_poly_compose_arena(alex_poly *p, alex_poly *q, alex_arena *arena);
+
+/**
+ * @brief Composes two polynomials and stores the result in an existing one
+ *
+ * This function computes the same composition as @ref alex_poly_compose(), but writes it into
+ * `dst`, which may be `p` or `q`. `dst` must have room for \f$\deg p\cdot\deg q + 1\f$ coefficients.
+ * If it does not, `dst` is left untouched, `NULL` is returned and the flag
+ * @ref ALEX_POLY_CAP_FLAG is set.
+ *
+ * @param dst the polynomial receiving the composition
+ * @param p the outer polynomial
+ * @param q the inner polynomial
+ * @return `dst`, or `NULL` on failure
+ *
+ * @see alex_poly_compose(), alex_make_poly_cap()
+ */
+alex_poly *alex_poly_compose_into(alex_poly *dst, alex_poly *p, alex_poly *q);
+
+#endif
@@ -0,0 +1,336 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/**
+ * @file polybatch.h
+ * @author Lorenzo Calza
+ * @date 14 Oct 2026
+ * @brief Header file containing the declarations for batches of polynomials
+ *
+ * An @ref alex_poly_batch stores many polynomials of a bounded degree in a single coefficient
+ * matrix, coefficient by coefficient: row \f$k\f$ holds the coefficients of \f$x^k\f$ of all the
+ * polynomials, next to each other. The batch routines walk this matrix row by row and process
+ * each row across all polynomials with vector instructions, instead of chasing one pointer per
+ * polynomial as an array of @ref alex_poly would require.
+ *
+ * **Example**
+ *
+ *     alex_poly_batch *batch = alex_make_poly_batch(count, 3, 0);
+ *     for (size_t i = 0; i < count; ++i) {
+ *         alex_poly_batch_set(batch, i, polys[i]); // or write to alex_poly_batch_row() directly
+ *     }
+ *     alex_poly_batch_eval(batch, xs, ys); // ys[i] = polys[i](xs[i])
+ *     alex_free_poly_batch(batch);
+ */
+
+#ifndef _ALEX_POLYBATCH_H
+/**
+ * @brief Include guard for this file
+ */
+#define _ALEX_POLYBATCH_H
+
+#include <stddef.h>
+
+#include "func.h"
+#include "poly.h"
+#include "pool.h"
+
+/**
+ * @brief Alignment in bytes of the rows of an @ref alex_poly_batch
+ */
+#define ALEX_POLY_BATCH_ALIGN 64ul
+
+/**
+ * @brief Number of polynomials the batch routines process per tile
+ *
+ * Each tile of intermediate values stays in the L1 cache while all rows are applied to it.
+ */
+#define ALEX_POLY_BATCH_TILE 512ul
+
+/**
+ * @brief Represents a batch of polynomials of bounded degree
+ *
+ * The coefficient \f$c_k\f$ of polynomial `i` is stored in `coeffs[k * stride + i]`, for
+ * `k = 0, ..., deg` and `i = 0, ..., count - 1`. Polynomials of lower degree than `deg` have zero
+ * leading coefficients, which do not change their value. Every row starts at an address aligned
+ * to @ref ALEX_POLY_BATCH_ALIGN bytes, and the padding at the end of each row is kept at `0`.
+ *
+ * Like @ref alex_poly, the struct and its coefficients are stored in one block, which must only
+ * be created by @ref alex_make_poly_batch() and released by @ref alex_free_poly_batch().
+ *
+ * @see alex_make_poly_batch(), alex_poly_batch_row()
+ */
+typedef struct {
+    /**
+     * @brief The number of polynomials
+     */
+    size_t count;
+    /**
+     * @brief The distance between two rows, in doubles (at least `count`)
+     */
+    size_t stride;
+    /**
+     * @brief The (maximum) degree of the polynomials
+     */
+    unsigned int deg;
+    /**
+     * @brief The number of rows `coeffs` has room for (at least `deg + 1`)
+     */
+    unsigned int cap;
+    /**
+     * @brief The coefficient matrix
+     */
+    double *coeffs;
+} alex_poly_batch;
+
+/**
+ * @brief Returns a pointer to the coefficients of \f$x^k\f$ of all polynomials of the batch
+ *
+ * The row contains `batch->count` doubles (followed by padding).
+ */
+#define alex_poly_batch_row(batch, k) ((batch)->coeffs + (size_t) (k) * (batch)->stride)
+
+/**
+ * @brief Constructs a batch of polynomials and returns a pointer to it
+ *
+ * Allocates a batch of `count` polynomials of degree `deg`, with room for `cap` rows, in a single
+ * block. All coefficients are initialized to `0`. A `cap` of `0` is the same as `deg + 1`, higher
+ * values allow @ref alex_poly_batch_integ_into() to raise the degree in-place.
+ *
+ * The flag is set to @ref ALEX_INV_PARAM_FLAG if `cap` is nonzero but less than `deg + 1`, to
+ * @ref ALEX_BAD_ALLOC_FLAG if the allocation failed (in both cases `NULL` is returned) and to
+ * @ref ALEX_OK_FLAG otherwise.
+ *
+ * @param count the number of polynomials
+ * @param deg the degree
+ * @param cap the number of rows to allocate, or `0`
+ * @return the batch, or `NULL` on failure
+ *
+ * @see alex_free_poly_batch(), alex_poly_batch
+ */
+alex_poly_batch *alex_make_poly_batch(size_t count, unsigned int deg, unsigned int cap);
+
+/**
+ * @brief Frees a batch of polynomials
+ *
+ * @param batch the batch
+ *
+ * @see alex_make_poly_batch()
+ */
+void alex_free_poly_batch(alex_poly_batch *batch);
+
+/**
+ * @brief Stores a polynomial in a batch
+ *
+ * Copies the coefficients of `poly` into slot `i` of the batch, and clears the coefficients
+ * above its degree. The degree of `poly` must not exceed that of the batch, otherwise the flag
+ * @ref ALEX_POLY_CAP_FLAG is set and the batch is left untouched.
+ *
+ * @param batch the batch
+ * @param i the slot, less than `batch->count`
+ * @param poly the polynomial
+ *
+ * @see alex_poly_batch_get()
+ */
+void alex_poly_batch_set(alex_poly_batch *batch, size_t i, alex_poly *poly);
+
+/**
+ * @brief Extracts a polynomial from a batch
+ *
+ * Copies the coefficients in slot `i` of the batch into `dst`, whose degree is set to that of the
+ * largest nonzero coefficient. `dst` must have room for `batch->deg + 1` coefficients, otherwise
+ * the flag @ref ALEX_POLY_CAP_FLAG is set, `dst` is left untouched and `NULL` is returned.
+ *
+ * @param batch the batch
+ * @param i the slot, less than `batch->count`
+ * @param dst the polynomial receiving the coefficients
+ * @return `dst`, or `NULL` on failure
+ *
+ * @see alex_poly_batch_set(), alex_make_poly_cap()
+ */
+alex_poly *alex_poly_batch_get(alex_poly_batch *batch, size_t i, alex_poly *dst);
+
+/**
+ * @brief Evaluates every polynomial of a batch at its own point
+ *
+ * Stores \f$P_i(x_i)\f$ in `out[i]` for every polynomial \f$P_i\f$ of the batch, where \f$x_i\f$ is
+ * `xs[i]`. Horner's scheme is applied one row at a time to a tile of @ref ALEX_POLY_BATCH_TILE
+ * polynomials, with the widest vector instructions the CPU supports (see
+ * @ref alex_poly_eval_many()). The sequence of floating point operations is the same as in
+ * @ref alex_poly_eval(), as such the results are identical to evaluating each polynomial on its own
+ * (see @ref alex_poly_eval_many() for the caveat of `ALEX_INLINE`).
+ *
+ * `xs` and `out` must hold `batch->count` doubles each, and may be the same array.
+ *
+ * @param batch the batch
+ * @param xs the points, one per polynomial
+ * @param out where the values are stored
+ *
+ * @see alex_poly_batch_eval_r(), alex_poly_batch_eval_at()
+ */
+void alex_poly_batch_eval(alex_poly_batch *batch, const double *xs, double *out);
+
+/**
+ * @brief Reentrant variant of @ref alex_poly_batch_eval()
+ *
+ * @param batch the batch
+ * @param xs the points, one per polynomial
+ * @param out where the values are stored
+ * @return @ref ALEX_OK_FLAG, or @ref ALEX_INV_PARAM_FLAG if any pointer is `NULL`
+ *
+ * @see alex_poly_batch_eval()
+ */
+int alex_poly_batch_eval_r(alex_poly_batch *batch, const double *xs, double *out);
+
+/**
+ * @brief Multi-threaded variant of @ref alex_poly_batch_eval_r()
+ *
+ * Computes the same values as @ref alex_poly_batch_eval_r(), distributing the tiles of
+ * @ref ALEX_POLY_BATCH_TILE polynomials over the threads of a pool (see @ref alex_pool_for()).
+ * This function never accesses the flag.
+ *
+ * @param batch the batch
+ * @param xs the points, one per polynomial
+ * @param out where the values are stored
+ * @param pool the pool providing the threads (`NULL` for the default pool)
+ * @param threads the maximum number of threads (`0` for all the threads of the pool)
+ * @return @ref ALEX_OK_FLAG, or @ref ALEX_INV_PARAM_FLAG if any pointer is `NULL`
+ *
+ * @see alex_poly_batch_eval_r(), alex_pool
+ */
+int alex_poly_batch_eval_par(alex_poly_batch *batch, const double *xs, double *out, alex_pool *pool,
+        unsigned int threads);
+
+/**
+ * @brief Evaluates every polynomial of a batch at the same point
+ *
+ * Stores \f$P_i(x)\f$ in `out[i]` for every polynomial \f$P_i\f$ of the batch, see
+ * @ref alex_poly_batch_eval().
+ *
+ * @param batch the batch
+ * @param x the point
+ * @param out where the `batch->count` values are stored
+ *
+ * @see alex_poly_batch_eval_at_r(), alex_poly_batch_eval()
+ */
+void alex_poly_batch_eval_at(alex_poly_batch *batch, double x, double *out);
+
+/**
+ * @brief Reentrant variant of @ref alex_poly_batch_eval_at()
+ *
+ * @param batch the batch
+ * @param x the point
+ * @param out where the values are stored
+ * @return @ref ALEX_OK_FLAG, or @ref ALEX_INV_PARAM_FLAG if any pointer is `NULL`
+ *
+ * @see alex_poly_batch_eval_at()
+ */
+int alex_poly_batch_eval_at_r(alex_poly_batch *batch, double x, double *out);
+
+/**
+ * @brief Differentiates every polynomial of a batch
+ *
+ * Returns a new batch of degree `deg - 1` (`0` for a batch of constants) holding the derivatives,
+ * computed like by @ref alex_poly_diff().
+ *
+ * The flag is set to @ref ALEX_INV_PARAM_FLAG if `batch` is `NULL`, to @ref ALEX_BAD_ALLOC_FLAG if
+ * the allocation failed (in both cases `NULL` is returned) and to @ref ALEX_OK_FLAG otherwise.
+ *
+ * @param batch the batch
+ * @return the batch of derivatives
+ *
+ * @see alex_poly_batch_diff_into(), alex_poly_batch_integ()
+ */
+alex_poly_batch *alex_poly_batch_diff(alex_poly_batch *batch);
+
+/**
+ * @brief Differentiates every polynomial of a batch, storing the result in an existing batch
+ *
+ * `dst` may be `src`. It must hold as many polynomials as `src` and have room for `src->deg` rows
+ * (one if `src->deg` is `0`). If it does not, `dst` is left untouched, `NULL` is returned and the
+ * flag @ref ALEX_POLY_CAP_FLAG is set.
+ *
+ * @param dst the batch receiving the derivatives
+ * @param src the batch to differentiate
+ * @return `dst`, or `NULL` on failure
+ *
+ * @see alex_poly_batch_diff()
+ */
+alex_poly_batch *alex_poly_batch_diff_into(alex_poly_batch *dst, alex_poly_batch *src);
+
+/**
+ * @brief Integrates every polynomial of a batch
+ *
+ * Returns a new batch of degree `deg + 1` holding the antiderivatives, computed like by
+ * @ref alex_poly_integ() with the same integration constant `c` for all of them.
+ *
+ * The flag is set to @ref ALEX_INV_PARAM_FLAG if `batch` is `NULL`, to @ref ALEX_BAD_ALLOC_FLAG if
+ * the allocation failed (in both cases `NULL` is returned) and to @ref ALEX_OK_FLAG otherwise.
+ *
+ * @param batch the batch
+ * @param c the integration constant
+ * @return the batch of antiderivatives
+ *
+ * @see alex_poly_batch_integ_into(), alex_poly_batch_diff()
+ */
+alex_poly_batch *alex_poly_batch_integ(alex_poly_batch *batch, double c);
+
+/**
+ * @brief Integrates every polynomial of a batch, storing the result in an existing batch
+ *
+ * `dst` may be `src`. It must hold as many polynomials as `src` and have room for `src->deg + 2`
+ * rows. If it does not, `dst` is left untouched, `NULL` is returned and the flag
+ * @ref ALEX_POLY_CAP_FLAG is set.
+ *
+ * @param dst the batch receiving the antiderivatives
+ * @param src the batch to integrate
+ * @param c the integration constant
+ * @return `dst`, or `NULL` on failure
+ *
+ * @see alex_poly_batch_integ()
+ */
+alex_poly_batch *alex_poly_batch_integ_into(alex_poly_batch *dst, alex_poly_batch *src, double c);
+
+/**
+ * @brief Determines the definite integrals of every polynomial of a batch over a given range
+ *
+ * Stores the integral of polynomial `i` over `range` in `out[i]`. Like
+ * @ref alex_poly_integ_range(), the antiderivatives are evaluated on the fly without allocating
+ * them, and the results are identical to those of @ref alex_poly_integ_range().
+ *
+ * @param batch the batch
+ * @param range the range
+ * @param out where the `batch->count` integrals are stored
+ *
+ * @see alex_poly_batch_integ_range_r()
+ */
+void alex_poly_batch_integ_range(alex_poly_batch *batch, alex_range *range, double *out);
+
+/**
+ * @brief Reentrant variant of @ref alex_poly_batch_integ_range()
+ *
+ * @param batch the batch
+ * @param range the range
+ * @param out where the integrals are stored
+ * @return @ref ALEX_OK_FLAG, or @ref ALEX_INV_PARAM_FLAG if any pointer is `NULL`
+ *
+ * @see alex_poly_batch_integ_range()
+ */
+int alex_poly_batch_integ_range_r(alex_poly_batch *batch, alex_range *range, double *out);
+
+#endif
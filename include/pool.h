@@ -0,0 +1,168 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/**
+ * @file pool.h
+ * @author Lorenzo Calza
+ * @date 14 Oct 2026
+ * @brief Header file containing the declarations for the work-stealing thread pool
+ *
+ * An @ref alex_pool keeps its threads alive between parallel loops, as such a loop only costs a
+ * wake-up instead of creating and joining threads. The iterations of a loop are split into one
+ * contiguous range per thread taking part, each thread runs its own range front to back and, once
+ * it is empty, steals the upper half of the range of another thread. As such, the threads keep
+ * busy even if the iterations do not take the same time.
+ *
+ * Every parallel routine of the library runs its loops with @ref alex_pool_for() on the pool passed
+ * in its settings (see @ref alex_integ_ctx), or on the default pool, which has one thread per
+ * processor. A loop started from within a running loop, or while its pool is busy with a loop of
+ * another thread, runs on the calling thread alone, as such nested parallel calls never use more
+ * threads than the pool has.
+ *
+ * **Example**
+ *
+ *     alex_pool *pool = alex_make_pool(4);
+ *     alex_integ_ctx ctx = {0, ALEX_SUM_NAIVE, pool};
+ *     alex_integrate_trap_par(f, range, 10000000ul, &ctx, &area);
+ *     alex_pool_for(pool, 0, count, &body, data);
+ *     alex_free_pool(pool);
+ */
+
+#ifndef _ALEX_POOL_H
+/**
+ * @brief Include guard for this file
+ */
+#define _ALEX_POOL_H
+
+#include <stddef.h>
+
+#include "parallel.h"
+
+/**
+ * @brief Opaque type representing a thread pool
+ *
+ * @see alex_make_pool(), alex_pool_for(), alex_default_pool()
+ */
+typedef struct alex_pool alex_pool;
+
+/**
+ * @brief Typedef for the body of a parallel reduction, returning the value of iteration `index`
+ *
+ * @param index the loop index
+ * @param ctx the context pointer passed to @ref alex_pool_reduce()
+ */
+typedef double (*alex_par_reduce_body)(size_t index, void *ctx);
+
+/**
+ * @brief Constructs a thread pool
+ *
+ * The pool runs loops on up to `threads` threads, the calling thread of a loop included, as such
+ * `threads - 1` threads are created. If `threads` is `0`, @ref alex_cpu_count() is used.
+ *
+ * If the threads cannot be created, `NULL` is returned and the flag is set to @ref ALEX_BAD_ALLOC_FLAG,
+ * to @ref ALEX_OK_FLAG otherwise.
+ *
+ * @param threads the number of threads
+ * @return the pool, to be freed with @ref alex_free_pool()
+ *
+ * @see alex_free_pool(), alex_pool_for()
+ */
+alex_pool *alex_make_pool(unsigned int threads);
+
+/**
+ * @brief Stops the threads of a pool and frees it
+ *
+ * Must not be called while a loop runs on the pool. The flag is set to @ref ALEX_INV_PARAM_FLAG if
+ * `pool` is `NULL` or the default pool, and to @ref ALEX_OK_FLAG otherwise.
+ *
+ * @param pool the pool
+ *
+ * @see alex_make_pool()
+ */
+void alex_free_pool(alex_pool *pool);
+
+/**
+ * @brief Returns the pool used by the parallel routines when none is specified
+ *
+ * It is created on the first call, with one thread per processor, and lives until the process
+ * exits.
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @return the default pool, `NULL` if it could not be created (the loops then run on the
+ * calling thread)
+ */
+alex_pool *alex_default_pool(void);
+
+/**
+ * @brief Returns the number of threads of a pool, the calling thread of a loop included
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @param pool the pool (`NULL` for the default pool)
+ * @return the number of threads
+ */
+unsigned int alex_pool_threads(alex_pool *pool);
+
+/**
+ * @brief Runs the iterations of a loop on the threads of a pool
+ *
+ * Calls `body(i, ctx)` exactly once for every `i` in `0, 1, ..., count - 1`, on up to `threads`
+ * threads of the pool including the calling one, and returns once all iterations have completed.
+ * The order of the iterations and the threads running them are unspecified, as for
+ * @ref alex_parallel_for().
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @param pool the pool (`NULL` for the default pool)
+ * @param threads the maximum number of threads (`0` for all the threads of the pool)
+ * @param count the number of iterations
+ * @param body the loop body
+ * @param ctx the context pointer passed to `body`
+ *
+ * @see alex_pool_reduce(), alex_parallel_for()
+ */
+void alex_pool_for(alex_pool *pool, unsigned int threads, size_t count, alex_par_body body, void *ctx);
+
+/**
+ * @brief Sums the values of the iterations of a loop run on the threads of a pool
+ *
+ * Runs the loop as @ref alex_pool_for() and stores \f$\sum_{i=0}^{n-1}\f$ `body(i, ctx)` in
+ * `*res`. The values are summed pairwise in index order, as such the result does not depend on the
+ * number of threads nor on their scheduling. This function never accesses the flag.
+ *
+ * @param pool the pool (`NULL` for the default pool)
+ * @param threads the maximum number of threads (`0` for all the threads of the pool)
+ * @param count the number of iterations
+ * @param body the loop body, returning the value of an iteration
+ * @param ctx the context pointer passed to `body`
+ * @param res where the sum is stored (`0` on failure)
+ *
+ * @returns @ref ALEX_OK_FLAG or @ref ALEX_BAD_ALLOC_FLAG
+ * @see alex_pool_for()
+ */
+int alex_pool_reduce(alex_pool *pool, unsigned int threads, size_t count, alex_par_reduce_body body, void *ctx,
+        double *res);
+
+#endif
@@ -0,0 +1,292 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/**
+ * @file spoly.h
+ * @author Lorenzo Calza
+ * @date 14 Oct 2026
+ * @brief Header file containing the declarations for sparse polynomials
+ *
+ * An @ref alex_spoly stores only the non-zero terms of a polynomial, as such polynomials of high
+ * degree with few terms, ie. \f$x^{100000} + 1\f$, take memory and evaluation time proportional
+ * to their number of terms rather than to their degree. Dense polynomials (see @ref alex_poly) remain
+ * the better choice as soon as most coefficients are non-zero.
+ *
+ * **Example**
+ *
+ *     unsigned int exps[] = {0, 100000};
+ *     double coeffs[] = {1.0, 1.0};
+ *     alex_spoly *p = alex_make_spoly(2, exps, coeffs);
+ *     double y = alex_spoly_eval(p, 0.999);
+ *     alex_spoly *dp = alex_spoly_diff(p);
+ *     alex_free_spoly(dp);
+ *     alex_free_spoly(p);
+ *
+ * **Notes**
+ * - Evaluation runs Horner's scheme over the terms, bridging the gap between two consecutive
+ *   exponents by exponentiation by squaring. A polynomial with `t` terms and degree `n` is
+ *   evaluated in \f$O(t \log (n / t))\f$ operations, as opposed to \f$O(n)\f$ for its dense counterpart.
+ *   Gaps of one (dense stretches) cost a single multiplication, like in the dense scheme.
+ * - Each squaring rounds, as such a gap `g` contributes a relative error of up to about
+ *   \f$\log_2 g\f$ ulps, comparable to the error of the dense scheme over the same stretch.
+ */
+
+#ifndef _ALEX_SPOLY_H
+/**
+ * @brief Include guard for this file
+ */
+#define _ALEX_SPOLY_H
+
+#include <stddef.h>
+
+#include "func.h"
+#include "poly.h"
+
+/**
+ * @brief Represents a polynomial function by its non-zero terms
+ *
+ * The polynomial is \f$\sum_{k=0}^{t-1} c_kx^{e_k}\f$, where \f$t\f$ is `nterms`, \f$c_k\f$ is
+ * `coeffs[k]` and \f$e_k\f$ is `exps[k]`. The exponents are strictly increasing and no coefficient
+ * is zero, as such the zero polynomial has no terms at all.
+ *
+ * Do **not** create a @ref alex_spoly struct object yourself! Use @ref alex_make_spoly() instead,
+ * which establishes the invariants above, and free the result with @ref alex_free_spoly(). The
+ * struct and its terms are stored in one contiguous block of memory.
+ *
+ * @see alex_make_spoly(), alex_free_spoly(), alex_poly_to_spoly()
+ */
+typedef struct {
+    /**
+     * @brief The number of non-zero terms
+     */
+    size_t nterms;
+    /**
+     * @brief The exponents, strictly increasing
+     */
+    unsigned int *exps;
+    /**
+     * @brief The coefficients, `coeffs[k]` belonging to `exps[k]`
+     */
+    double *coeffs;
+} alex_spoly;
+
+/**
+ * @brief Creates a sparse polynomial from its terms
+ *
+ * The terms may come in any order. Terms with the same exponent are summed, and terms whose
+ * (summed) coefficient is zero are dropped. If `nterms` is `0`, the zero polynomial is returned.
+ *
+ * **Example**
+ *
+ *     unsigned int exps[] = {1000, 0, 1000};
+ *     double coeffs[] = {2.0, -1.0, 1.0};
+ *     alex_spoly *p = alex_make_spoly(3, exps, coeffs); // 3x^1000 - 1
+ *
+ * **Notes**
+ *
+ * This function can set the flag to the following values:
+ * - @ref ALEX_OK_FLAG on success
+ * - @ref ALEX_INV_PARAM_FLAG if `exps` or `coeffs` is `NULL` while `nterms` is not `0`
+ * - @ref ALEX_BAD_ALLOC_FLAG if the memory could not be allocated
+ *
+ * @param nterms the number of terms
+ * @param exps the exponents of the terms
+ * @param coeffs the coefficients of the terms
+ * @return the sparse polynomial, or `NULL` on failure
+ *
+ * @see alex_free_spoly(), alex_spoly
+ */
+alex_spoly *alex_make_spoly(size_t nterms, const unsigned int exps[], const double coeffs[]);
+
+/**
+ * @brief Frees a sparse polynomial created by this library
+ *
+ * **Notes**
+ *
+ * This function can set the flag to the following values:
+ * - @ref ALEX_OK_FLAG on success
+ * - @ref ALEX_INV_PARAM_FLAG if `spoly` is `NULL`
+ *
+ * @param spoly the sparse polynomial
+ *
+ * @see alex_make_spoly()
+ */
+void alex_free_spoly(alex_spoly *spoly);
+
+/**
+ * @brief Returns the degree of the sparse polynomial
+ *
+ * The zero polynomial is said to be of degree `0`, like its dense counterpart.
+ *
+ * **Notes**
+ *
+ * This function can set the flag to the following values:
+ * - @ref ALEX_OK_FLAG on success
+ * - @ref ALEX_INV_PARAM_FLAG if `spoly` is `NULL` (and `0` is returned)
+ *
+ * @param spoly the sparse polynomial
+ * @return the degree
+ */
+unsigned int alex_spoly_deg(alex_spoly *spoly);
+
+/**
+ * @brief Returns the number of non-zero terms of the sparse polynomial
+ *
+ * **Notes**
+ *
+ * This function can set the flag to the following values:
+ * - @ref ALEX_OK_FLAG on success
+ * - @ref ALEX_INV_PARAM_FLAG if `spoly` is `NULL` (and `0` is returned)
+ *
+ * @param spoly the sparse polynomial
+ * @return the number of terms
+ */
+size_t alex_spoly_nterms(alex_spoly *spoly);
+
+/**
+ * @brief Evaluates the sparse polynomial at `x`
+ *
+ * **Notes**
+ *
+ * This function can set the flag to the following values:
+ * - @ref ALEX_OK_FLAG on success
+ * - @ref ALEX_INV_PARAM_FLAG if `spoly` is `NULL` (and `0` is returned)
+ *
+ * @param spoly the sparse polynomial
+ * @param x the location at which the function should be evaluated
+ * @return the function value
+ *
+ * @see alex_spoly_eval_r()
+ */
+double alex_spoly_eval(alex_spoly *spoly, double x);
+
+/**
+ * @brief Reentrant variant of @ref alex_spoly_eval()
+ *
+ * Computes the same value as @ref alex_spoly_eval(), but stores it in `*res` and returns
+ * the flag instead of setting it. This function never accesses the flag.
+ *
+ * @param spoly the sparse polynomial
+ * @param x the location at which the function should be evaluated
+ * @param res where the function value is stored (`0` on failure)
+ * @return @ref ALEX_OK_FLAG, or @ref ALEX_INV_PARAM_FLAG if `spoly` is `NULL`
+ *
+ * @see alex_spoly_eval()
+ */
+int alex_spoly_eval_r(alex_spoly *spoly, double x, double *res);
+
+/**
+ * @brief Returns the derivative of the sparse polynomial
+ *
+ * The result is a new sparse polynomial, which must be freed with @ref alex_free_spoly().
+ *
+ * **Notes**
+ *
+ * This function can set the flag to the following values:
+ * - @ref ALEX_OK_FLAG on success
+ * - @ref ALEX_INV_PARAM_FLAG if `spoly` is `NULL`
+ * - @ref ALEX_BAD_ALLOC_FLAG if the memory could not be allocated
+ *
+ * @param spoly the sparse polynomial
+ * @return the derivative, or `NULL` on failure
+ *
+ * @see alex_spoly_integ()
+ */
+alex_spoly *alex_spoly_diff(alex_spoly *spoly);
+
+/**
+ * @brief Returns the antiderivative of the sparse polynomial with constant term `c`
+ *
+ * The result is a new sparse polynomial, which must be freed with @ref alex_free_spoly().
+ *
+ * **Notes**
+ *
+ * This function can set the flag to the following values:
+ * - @ref ALEX_OK_FLAG on success
+ * - @ref ALEX_INV_PARAM_FLAG if `spoly` is `NULL`
+ * - @ref ALEX_ALG_OVERFLOW_FLAG if the degree of the result would not fit in an `unsigned int`
+ * - @ref ALEX_BAD_ALLOC_FLAG if the memory could not be allocated
+ *
+ * @param spoly the sparse polynomial
+ * @param c the constant term of the antiderivative
+ * @return the antiderivative, or `NULL` on failure
+ *
+ * @see alex_spoly_diff()
+ */
+alex_spoly *alex_spoly_integ(alex_spoly *spoly, double c);
+
+/**
+ * @brief Converts a dense polynomial to a sparse one
+ *
+ * Only the non-zero coefficients of `poly` are kept.
+ *
+ * **Notes**
+ *
+ * This function can set the flag to the following values:
+ * - @ref ALEX_OK_FLAG on success
+ * - @ref ALEX_INV_PARAM_FLAG if `poly` is `NULL`
+ * - @ref ALEX_BAD_ALLOC_FLAG if the memory could not be allocated
+ *
+ * @param poly the dense polynomial
+ * @return the sparse polynomial, or `NULL` on failure
+ *
+ * @see alex_spoly_to_poly()
+ */
+alex_spoly *alex_poly_to_spoly(alex_poly *poly);
+
+/**
+ * @brief Converts a sparse polynomial to a dense one
+ *
+ * The result has the degree of `spoly` and must be freed with @ref alex_free_poly(). Mind that it
+ * takes `deg + 1` doubles of memory, however few terms `spoly` has.
+ *
+ * **Notes**
+ *
+ * This function can set the flag to the following values:
+ * - @ref ALEX_OK_FLAG on success
+ * - @ref ALEX_INV_PARAM_FLAG if `spoly` is `NULL`
+ * - @ref ALEX_BAD_ALLOC_FLAG if the memory could not be allocated
+ *
+ * @param spoly the sparse polynomial
+ * @return the dense polynomial, or `NULL` on failure
+ *
+ * @see alex_poly_to_spoly()
+ */
+alex_poly *alex_spoly_to_poly(alex_spoly *spoly);
+
+/**
+ * @brief Returns an @ref alex_closure_1d representing this sparse polynomial function
+ *
+ * The closure evaluates the polynomial exactly like @ref alex_spoly_eval(), without accessing
+ * the flag. It refers to `spoly` rather than copying it, as such `spoly` must outlive any use
+ * of the closure.
+ *
+ * **Notes**
+ *
+ * This function can set the flag to the following values:
+ * - @ref ALEX_OK_FLAG on success
+ * - @ref ALEX_INV_PARAM_FLAG if `spoly` is `NULL`
+ *
+ * @param spoly the sparse polynomial
+ * @return the @ref alex_closure_1d object (with a `NULL` function if `spoly` is `NULL`)
+ *
+ * @see alex_closure_1d, alex_poly_closure()
+ */
+alex_closure_1d alex_spoly_closure(alex_spoly *spoly);
+
+#endif
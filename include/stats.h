@@ -0,0 +1,296 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/**
+ * @file stats.h
+ * @author Lorenzo Calza
+ * @date 14 Oct 2026
+ * @brief Header file containing the declarations for the optional instrumentation counters
+ *
+ * When the library is compiled with the macro `ALEX_STATS` defined, eg. with
+ *
+ *     CFLAGS="-O2 -DALEX_STATS" ./build.sh lib
+ *
+ * the integrators, cubature rules, root finders, polynomial operations and approximation builders
+ * count their calls, the evaluations of the functions passed to them, the polynomials they allocate
+ * and the time spent in them, grouped by the families listed below (`ALEX_STATS_*`). Each thread
+ * records into counters of its own, which @ref alex_stats_snapshot() adds up on demand, as such
+ * the instrumented routines never contend. Without `ALEX_STATS` (the default), the instrumentation
+ * is compiled out and all counters stay `0`.
+ *
+ * **Example**
+ *
+ *     alex_stats before = alex_stats_snapshot();
+ *     run_workload();
+ *     alex_stats after = alex_stats_snapshot();
+ *     for (unsigned int api = 0; api < ALEX_STATS_APIS; ++api)
+ *         printf("%s: %llu evaluations in %llu ns\n", alex_stats_api_name(api),
+ *                after.apis[api].evals - before.apis[api].evals, after.apis[api].nanos - before.apis[api].nanos);
+ *
+ * **Notes**
+ * - A call made within another instrumented call on the same thread (eg. the trapezoid refinements
+ *   of @ref alex_integrate_romberg_r()) is accounted to the outer one only.
+ * - The evaluations are those of the closures passed by the caller, including the ones made by worker
+ *   threads. Polynomial evaluations by @ref alex_poly_eval_many() count one evaluation per point.
+ * - Allocations made outside of an instrumented call count towards @ref ALEX_STATS_POLY.
+ * - When enabled, every evaluation of a counted closure costs an atomic increment (a few
+ *   nanoseconds), and every instrumented call two reads of the monotonic clock.
+ */
+
+#ifndef _ALEX_STATS_H
+/**
+ * @brief Include guard for this file
+ */
+#define _ALEX_STATS_H
+
+#include <stddef.h>
+
+#include "func.h"
+
+/**
+ * @brief The one-dimensional integrators of integrate.h
+ */
+#define ALEX_STATS_INTEGRATE 0u
+
+/**
+ * @brief The multi-dimensional integrators of cubature.h
+ */
+#define ALEX_STATS_CUBATURE 1u
+
+/**
+ * @brief The root finders of optimize.h, including the polynomial ones
+ */
+#define ALEX_STATS_ROOT 2u
+
+/**
+ * @brief The polynomial evaluations and arithmetic of poly.h and polybatch.h
+ */
+#define ALEX_STATS_POLY 3u
+
+/**
+ * @brief The construction of piecewise approximations of approx.h
+ */
+#define ALEX_STATS_APPROX 4u
+
+/**
+ * @brief The number of families of instrumented routines
+ */
+#define ALEX_STATS_APIS 5u
+
+/**
+ * @brief The counters of a family of instrumented routines
+ *
+ * @see alex_stats
+ */
+typedef struct {
+    /**
+     * @brief The number of calls
+     */
+    unsigned long long calls;
+    /**
+     * @brief The number of evaluations of the functions passed to the calls
+     */
+    unsigned long long evals;
+    /**
+     * @brief The number of polynomials allocated (on the heap or from an arena)
+     */
+    unsigned long long allocs;
+    /**
+     * @brief The number of bytes of these allocations
+     */
+    unsigned long long bytes;
+    /**
+     * @brief The total wall-clock time spent in the calls, in nanoseconds
+     */
+    unsigned long long nanos;
+} alex_stats_counters;
+
+/**
+ * @brief The counters of all families of instrumented routines, summed over all threads
+ *
+ * @see alex_stats_snapshot()
+ */
+typedef struct {
+    /**
+     * @brief The counters, indexed by `ALEX_STATS_*`
+     */
+    alex_stats_counters apis[ALEX_STATS_APIS];
+} alex_stats;
+
+/**
+ * @brief Whether the library was compiled with the instrumentation
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @return `1` if it was compiled with `ALEX_STATS`, `0` otherwise
+ */
+int alex_stats_enabled(void);
+
+/**
+ * @brief Returns the counters, summed over all threads, since the start or the last reset
+ *
+ * The counters of threads which have exited are kept. The calls still running are not included.
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @return the counters (all `0` if the instrumentation is compiled out)
+ *
+ * @see alex_stats_reset()
+ */
+alex_stats alex_stats_snapshot(void);
+
+/**
+ * @brief Resets the counters of all threads to `0`
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @see alex_stats_snapshot()
+ */
+void alex_stats_reset(void);
+
+/**
+ * @brief Returns the name of a family of instrumented routines
+ *
+ * The names are `"integrate"`, `"cubature"`, `"root"`, `"poly"` and `"approx"`.
+ *
+ * **Notes**
+ *
+ * This function does not set any flags
+ *
+ * @param api one of the `ALEX_STATS_*` values
+ * @return the name, or `"unknown"` if `api` is invalid
+ */
+const char *alex_stats_api_name(unsigned int api);
+
+#if defined(ALEX_STATS)
+
+#if !defined(__GNUC__)
+#error "ALEX_STATS requires GCC or Clang"
+#endif
+
+/**
+ * @internal
+ * @brief State of an instrumented call, see @ref ALEX_STATS_SCOPE
+ */
+typedef struct {
+    unsigned int api;
+    int active;
+    unsigned long long start;
+    unsigned long long evals;
+} alex_stats_scope;
+
+/**
+ * @internal
+ * @brief Closure counting the evaluations of another one into a scope, see @ref ALEX_STATS_COUNT
+ */
+typedef struct {
+    alex_closure_1d inner;
+    alex_stats_scope *scope;
+} alex_stats_closure;
+
+/**
+ * @internal
+ * @brief Vectorized variant of @ref alex_stats_closure
+ */
+typedef struct {
+    alex_vclosure_1d inner;
+    alex_stats_scope *scope;
+} alex_stats_vclosure;
+
+/**
+ * @internal
+ * @brief Multi-dimensional variant of @ref alex_stats_closure
+ */
+typedef struct {
+    alex_vclosure_nd inner;
+    alex_stats_scope *scope;
+} alex_stats_vclosure_nd;
+
+/** @internal */
+alex_stats_scope alex_stats_begin(unsigned int api);
+/** @internal */
+void alex_stats_end(alex_stats_scope *scope);
+/** @internal */
+alex_closure_1d alex_stats_count(alex_stats_scope *scope, alex_stats_closure *counted, alex_closure_1d f);
+/** @internal */
+alex_vclosure_1d alex_stats_vcount(alex_stats_scope *scope, alex_stats_vclosure *counted, alex_vclosure_1d f);
+/** @internal */
+alex_vclosure_nd alex_stats_ndcount(alex_stats_scope *scope, alex_stats_vclosure_nd *counted, alex_vclosure_nd f);
+/** @internal */
+void alex_stats_evals(alex_stats_scope *scope, unsigned long long n);
+/** @internal */
+void alex_stats_alloc(size_t bytes);
+
+/**
+ * @internal
+ * @brief Instruments the enclosing function as a call of the family `api`, until it returns
+ */
+#define ALEX_STATS_SCOPE(api) \
+    alex_stats_scope _alex_scope __attribute__((cleanup(alex_stats_end))) = alex_stats_begin(api)
+
+/**
+ * @internal
+ * @brief Replaces the closure variable `f` by one counting its evaluations into the current scope
+ */
+#define ALEX_STATS_COUNT(f) \
+    alex_stats_closure _alex_counted_##f; (f) = alex_stats_count(&_alex_scope, &_alex_counted_##f, (f))
+
+/**
+ * @internal
+ * @brief Vectorized variant of @ref ALEX_STATS_COUNT
+ */
+#define ALEX_STATS_VCOUNT(f) \
+    alex_stats_vclosure _alex_counted_##f; (f) = alex_stats_vcount(&_alex_scope, &_alex_counted_##f, (f))
+
+/**
+ * @internal
+ * @brief Multi-dimensional variant of @ref ALEX_STATS_COUNT
+ */
+#define ALEX_STATS_NDCOUNT(f) \
+    alex_stats_vclosure_nd _alex_counted_##f; (f) = alex_stats_ndcount(&_alex_scope, &_alex_counted_##f, (f))
+
+/**
+ * @internal
+ * @brief Adds `n` evaluations to the current scope
+ */
+#define ALEX_STATS_EVALS(n) alex_stats_evals(&_alex_scope, (n))
+
+/**
+ * @internal
+ * @brief Records the allocation of a polynomial of `bytes` bytes
+ */
+#define ALEX_STATS_ALLOC(bytes) alex_stats_alloc(bytes)
+
+#else
+
+#define ALEX_STATS_SCOPE(api) ((void) 0)
+#define ALEX_STATS_COUNT(f) ((void) 0)
+#define ALEX_STATS_VCOUNT(f) ((void) 0)
+#define ALEX_STATS_NDCOUNT(f) ((void) 0)
+#define ALEX_STATS_EVALS(n) ((void) 0)
+#define ALEX_STATS_ALLOC(bytes) ((void) 0)
+
+#endif
+
+#endif
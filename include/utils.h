@@ -54,6 +54,16 @@
  */
 #define alex_swap(m,n,type) {type tmp_swap_var = m; m = n; n = tmp_swap_var;}
 
+/**
+ * @brief Size in bytes from which @ref alex_mclear_nt() bypasses the cache
+ *
+ * Below this size, the cleared block is likely to fit into the last level cache and be
+ * used again soon, in which case regular stores are faster.
+ */
+#ifndef ALEX_MCLEAR_NT_THRESHOLD
+#define ALEX_MCLEAR_NT_THRESHOLD (1UL << 22)
+#endif
+
 /**
  * @brief Clears chunk of memory (ie. sets all bytes to 0)
  *
@@ -66,14 +76,34 @@
  *
  * @param ptr the pointer to the chunk of memory
  * @param size how many bytes should be cleared
+ *
+ * @see alex_mclear_nt()
  */
 void alex_mclear(void *ptr, size_t size);
 
+/**
+ * @brief Clears a large chunk of memory without pulling it into the cache
+ *
+ * This function has the same effect as @ref alex_mclear(), but uses non-temporal (streaming)
+ * stores for the bulk of the block on x86 with SSE2. These write to memory directly instead
+ * of evicting other data from the cache, which pays off for buffers much larger than the
+ * cache that are not read again right away, eg. a scratch arena that is being recycled.
+ *
+ * Blocks smaller than @ref ALEX_MCLEAR_NT_THRESHOLD, as well as any block on other platforms,
+ * are cleared with regular stores.
+ *
+ * @param ptr the pointer to the chunk of memory
+ * @param size how many bytes should be cleared
+ *
+ * @see alex_mclear()
+ */
+void alex_mclear_nt(void *ptr, size_t size);
+
 /**
  * @brief Initializes chunk of memory (ie. sets all bytes to a chosen value)
  *
  * This function will overwrite the block starting at the location at which `ptr`
- * points to, and ending at `ptr + size`.
+ * points to, and ending at `ptr + size`. It is forwarded to the platform `memset()`.
  *
  * A shorthand form for
  *
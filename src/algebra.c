@@ -17,31 +17,157 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <limits.h>
+
 #include "../include/algebra.h"
-#include "../include/utils.h"
 #include "../include/flags.h"
 
-unsigned int alex_gcd(unsigned int m, unsigned int n) {
-    if (m == 0 && n == 0) {
-        alex_set_flag(ALEX_ALG_INV_OP_FLAG);
+/*
+ * Count trailing zeros of a nonzero argument. GCC and Clang compile the builtins to a single
+ * instruction (tzcnt/bsf, rbit+clz).
+ */
+#if defined(__GNUC__)
+#define _ctz(x) __builtin_ctz(x)
+#define _ctzl(x) __builtin_ctzl(x)
+#else
+static int _ctzl(unsigned long x) {
+    int n = 0;
+    while ((x & 1) == 0) {
+        x >>= 1;
+        ++n;
+    }
+    return n;
+}
+#define _ctz(x) _ctzl(x)
+#endif
+
+/*
+ * Binary (Stein) GCD: the common power of two is factored out once, after which both operands
+ * are kept odd and the larger is replaced by their difference. The loop body has no data
+ * dependent branches apart from its exit condition, so it does not suffer from mispredictions
+ * the way the division based Euclid did. Returns m + n if either is 0, ie. 0 for (0,0).
+ */
+static inline unsigned int _gcd(unsigned int m, unsigned int n) {
+    if (m == 0 || n == 0) {
+        return m | n;
+    }
+    int shift = _ctz(m | n);
+    m >>= _ctz(m);
+    do {
+        n >>= _ctz(n);
+        unsigned int min = m < n ? m : n;
+        n = (m < n ? n : m) - min;
+        m = min;
+    } while (n != 0);
+    return m << shift;
+}
+
+static inline unsigned long _gcdl(unsigned long m, unsigned long n) {
+    if (m == 0 || n == 0) {
+        return m | n;
+    }
+    int shift = _ctzl(m | n);
+    m >>= _ctzl(m);
+    do {
+        n >>= _ctzl(n);
+        unsigned long min = m < n ? m : n;
+        n = (m < n ? n : m) - min;
+        m = min;
+    } while (n != 0);
+    return m << shift;
+}
+
+/*
+ * The lcm is computed as m / gcd * n, so the intermediate never exceeds the result.
+ * Returns 0 on overflow, which cannot be a valid lcm of two nonzero integers.
+ */
+static inline unsigned long _lcml(unsigned long m, unsigned long n) {
+    if (m == 0 || n == 0) {
         return 0;
     }
-    else if(n < m) {
-        alex_swap_int(m,n);
+    unsigned long q = m / _gcdl(m, n);
+    return q > ULONG_MAX / n ? 0 : q * n;
+}
+
+int alex_gcd_r(unsigned int m, unsigned int n, unsigned int *res) {
+    *res = _gcd(m, n);
+    return m == 0 && n == 0 ? ALEX_ALG_INV_OP_FLAG : ALEX_OK_FLAG;
+}
+
+unsigned int alex_gcd(unsigned int m, unsigned int n) {
+    unsigned int res;
+    alex_set_flag(alex_gcd_r(m, n, &res));
+    return res;
+}
+
+int alex_gcdl_r(unsigned long m, unsigned long n, unsigned long *res) {
+    *res = _gcdl(m, n);
+    return m == 0 && n == 0 ? ALEX_ALG_INV_OP_FLAG : ALEX_OK_FLAG;
+}
+
+unsigned long alex_gcdl(unsigned long m, unsigned long n) {
+    unsigned long res;
+    alex_set_flag(alex_gcdl_r(m, n, &res));
+    return res;
+}
+
+int alex_lcm_r(unsigned int m, unsigned int n, unsigned int *res) {
+    if (m == 0 || n == 0) {
+        *res = 0;
+        return ALEX_OK_FLAG;
     }
-    alex_set_flag(ALEX_OK_FLAG);
 
-    int r;
-    while(1) {
-        r = m % n;
-        if (r == 0) return n;
-        m = n;
-        n = r;
+    unsigned int q = m / _gcd(m, n);
+    if (q > UINT_MAX / n) {
+        *res = 0;
+        return ALEX_ALG_OVERFLOW_FLAG;
     }
+    *res = q * n;
+    return ALEX_OK_FLAG;
 }
 
 unsigned int alex_lcm(unsigned int m, unsigned int n) {
-    alex_set_flag(ALEX_OK_FLAG);
-    if (m == 0 && n == 0) return 0;
-    return m*n/alex_gcd(m,n);
+    unsigned int res;
+    alex_set_flag(alex_lcm_r(m, n, &res));
+    return res;
+}
+
+int alex_lcml_r(unsigned long m, unsigned long n, unsigned long *res) {
+    *res = _lcml(m, n);
+    return *res == 0 && m != 0 && n != 0 ? ALEX_ALG_OVERFLOW_FLAG : ALEX_OK_FLAG;
+}
+
+unsigned long alex_lcml(unsigned long m, unsigned long n) {
+    unsigned long res;
+    alex_set_flag(alex_lcml_r(m, n, &res));
+    return res;
+}
+
+int alex_gcd_many(const unsigned long *a, const unsigned long *b, unsigned long *out, size_t n) {
+    // the (0,0) check is accumulated rather than branched on, the loop has no early exit
+    unsigned long zero_pair = 0;
+    for (size_t i = 0; i < n; ++i) {
+        unsigned long m = a[i], k = b[i];
+        zero_pair |= (m | k) == 0;
+        out[i] = _gcdl(m, k);
+    }
+    return zero_pair ? ALEX_ALG_INV_OP_FLAG : ALEX_OK_FLAG;
+}
+
+int alex_lcm_reduce(const unsigned long *a, size_t n, unsigned long *res) {
+    // a single 0 makes the lcm 0, even if the elements before it overflowed
+    unsigned long lcm = 1;
+    int overflow = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (a[i] == 0) {
+            *res = 0;
+            return ALEX_OK_FLAG;
+        }
+        if (!overflow) {
+            lcm = _lcml(lcm, a[i]);
+            overflow = lcm == 0;
+        }
+    }
+    *res = lcm;
+    return overflow ? ALEX_ALG_OVERFLOW_FLAG : ALEX_OK_FLAG;
 }
@@ -0,0 +1,360 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <stdlib.h>
+#include <math.h>
+
+#include "../include/approx.h"
+#include "../include/flags.h"
+#include "../include/stats.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/*
+ * An approximation and its data live in a single block: the struct, the npieces + 1 breaks,
+ * the ncoeffs coefficients of all pieces one after the other and the npieces poly structs.
+ */
+#define _approx_round(size) ((((size) + sizeof(double) - 1) / sizeof(double)) * sizeof(double))
+
+static alex_approx *_approx_alloc(unsigned int npieces, size_t ncoeffs, double **coeffs) {
+    size_t head = _approx_round(sizeof(alex_approx)), breaks = ((size_t) npieces + 1) * sizeof(double);
+    alex_approx *approx = malloc(head + breaks + ncoeffs * sizeof(double) + npieces * _approx_round(sizeof(alex_poly)));
+    if (approx == NULL) {
+        return NULL;
+    }
+
+    approx->npieces = npieces;
+    approx->nevals = 0;
+    approx->breaks = (double *) ((char *) approx + head);
+    *coeffs = approx->breaks + npieces + 1;
+    approx->pieces = (alex_poly *) (*coeffs + ncoeffs);
+    return approx;
+}
+
+// converts the Chebyshev series c[0] T_0 + ... + c[m] T_m into the coefficients a[0..m] of 1, t, ..., t^m
+static void _cheb_to_monomial(const double *c, unsigned int m, double *a) {
+    double buf[3][ALEX_APPROX_MAX_DEG + 1] = {{0}};
+    double *prev = buf[0], *cur = buf[1], *next = buf[2];
+
+    for (unsigned int i = 0; i <= m; ++i) {
+        a[i] = 0;
+    }
+    prev[0] = 1; // T_0
+    a[0] = c[0];
+    if (m == 0) {
+        return;
+    }
+    cur[1] = 1; // T_1
+    a[1] = c[1];
+
+    for (unsigned int k = 2; k <= m; ++k) {
+        // T_k = 2t T_{k-1} - T_{k-2}
+        next[0] = -prev[0];
+        for (unsigned int i = 1; i <= k; ++i) {
+            next[i] = 2 * cur[i - 1] - prev[i];
+        }
+        for (unsigned int i = 0; i <= k; ++i) {
+            a[i] += c[k] * next[i];
+        }
+        double *tmp = prev;
+        prev = cur;
+        cur = next;
+        next = tmp;
+    }
+}
+
+typedef struct {
+    double a, b;
+} _approx_iv;
+
+int alex_make_approx_r(alex_closure_1d f, alex_range *range, double tol, unsigned int deg,
+        unsigned int maxpieces, alex_approx **res) {
+    ALEX_STATS_SCOPE(ALEX_STATS_APPROX);
+    ALEX_STATS_COUNT(f);
+    *res = NULL;
+    if (range == NULL || !(range->min < range->max) || !(tol > 0) || deg == 0 || deg > ALEX_APPROX_MAX_DEG
+            || maxpieces == 0) {
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    // the subintervals waiting to be processed, and the accepted pieces from left to right
+    size_t stride = (size_t) deg + 1;
+    _approx_iv *stack = malloc(maxpieces * sizeof(_approx_iv));
+    double *breaks = malloc(((size_t) maxpieces + 1) * sizeof(double)), *coeffs = malloc(maxpieces * stride * sizeof(double));
+    unsigned int *degs = malloc(maxpieces * sizeof(unsigned int));
+    if (stack == NULL || breaks == NULL || coeffs == NULL || degs == NULL) {
+        free(stack);
+        free(breaks);
+        free(coeffs);
+        free(degs);
+        return ALEX_BAD_ALLOC_FLAG;
+    }
+
+    double cosines[2 * ALEX_APPROX_MAX_DEG];
+    for (unsigned int m = 0; m < 2 * deg; ++m) {
+        cosines[m] = cos(M_PI * m / deg);
+    }
+
+    int flag = ALEX_OK_FLAG;
+    unsigned int npieces = 0;
+    unsigned long nevals = 0;
+    size_t top = 0, ncoeffs = 0;
+    stack[top++] = (_approx_iv) {range->min, range->max};
+    breaks[0] = range->min;
+
+    while (top > 0) {
+        _approx_iv iv = stack[--top];
+        double mid = (iv.a + iv.b) / 2, half = (iv.b - iv.a) / 2, v[ALEX_APPROX_MAX_DEG + 1], c[ALEX_APPROX_MAX_DEG + 1];
+
+        // samples at the Chebyshev points cos(pi j / deg), from b down to a
+        v[0] = alex_closure_eval(f, iv.b);
+        for (unsigned int j = 1; j < deg; ++j) {
+            v[j] = alex_closure_eval(f, mid + half * cosines[j]);
+        }
+        v[deg] = alex_closure_eval(f, iv.a);
+        nevals += deg + 1;
+
+        for (unsigned int k = 0; k <= deg; ++k) {
+            double sum = (v[0] + v[deg] * cosines[(size_t) k * deg % (2 * deg)]) / 2;
+            for (unsigned int j = 1; j < deg; ++j) {
+                sum += v[j] * cosines[(size_t) j * k % (2 * deg)];
+            }
+            c[k] = sum * 2 / deg;
+        }
+        c[0] /= 2;
+        c[deg] /= 2;
+
+        double tail = fabs(c[deg]) + (deg > 1 ? fabs(c[deg - 1]) : 0.);
+        int converged = tail <= tol / 2;
+        if (!converged && npieces + top + 2 <= maxpieces && mid > iv.a && mid < iv.b) {
+            stack[top++] = (_approx_iv) {mid, iv.b};
+            stack[top++] = (_approx_iv) {iv.a, mid}; // the left half is processed first
+            continue;
+        }
+        else if (!converged) {
+            flag = ALEX_APPROX_TOL_FLAG;
+        }
+
+        unsigned int m = deg;
+        for (double dropped = 0; m > 0 && dropped + fabs(c[m]) <= tol / 2; --m) {
+            dropped += fabs(c[m]);
+        }
+        _cheb_to_monomial(c, m, coeffs + npieces * stride);
+        degs[npieces] = m;
+        breaks[++npieces] = iv.b;
+        ncoeffs += (size_t) m + 1;
+    }
+
+    double *dst;
+    alex_approx *approx = _approx_alloc(npieces, ncoeffs, &dst);
+    if (approx != NULL) {
+        approx->nevals = nevals;
+        for (unsigned int k = 0; k <= npieces; ++k) {
+            approx->breaks[k] = breaks[k];
+        }
+        for (unsigned int k = 0; k < npieces; ++k) {
+            alex_poly *piece = approx->pieces + k;
+            piece->deg = degs[k];
+            piece->cap = degs[k] + 1;
+            piece->coeffs = dst;
+            for (unsigned int i = 0; i <= degs[k]; ++i) {
+                *dst++ = coeffs[k * stride + i];
+            }
+        }
+    }
+
+    free(stack);
+    free(breaks);
+    free(coeffs);
+    free(degs);
+    if (approx == NULL) {
+        return ALEX_BAD_ALLOC_FLAG;
+    }
+
+    *res = approx;
+    return flag;
+}
+
+alex_approx *alex_make_approx(alex_func_1d f, alex_range *range, double tol) {
+    alex_approx *res;
+    alex_set_flag(alex_make_approx_r(alex_func_closure(&f), range, tol, ALEX_DEFAULT_APPROX_DEG,
+            ALEX_DEFAULT_APPROX_PIECES, &res));
+    return res;
+}
+
+void alex_free_approx(alex_approx *approx) {
+    if (approx == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return;
+    }
+
+    free(approx); // the pieces are part of the same block
+    alex_set_flag(ALEX_OK_FLAG);
+}
+
+// the piece containing x, the first or last one outside of the range
+static unsigned int _approx_find(const alex_approx *approx, double x) {
+    unsigned int lo = 0, hi = approx->npieces;
+    while (hi - lo > 1) {
+        unsigned int mid = lo + (hi - lo) / 2;
+        if (x < approx->breaks[mid])
+            hi = mid;
+        else
+            lo = mid;
+    }
+    return lo;
+}
+
+static double _approx_piece_eval(const alex_approx *approx, unsigned int k, double x) {
+    double a = approx->breaks[k], b = approx->breaks[k + 1], res;
+    alex_poly_eval_r(approx->pieces + k, (x - (a + b) / 2) / ((b - a) / 2), &res);
+    return res;
+}
+
+#define _approx_outside(approx,x) ((x) < (approx)->breaks[0] || (x) > (approx)->breaks[(approx)->npieces])
+
+int alex_approx_eval_r(alex_approx *approx, double x, double *res) {
+    if (approx == NULL) {
+        *res = 0;
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    *res = _approx_piece_eval(approx, _approx_find(approx, x), x);
+    return _approx_outside(approx, x) ? ALEX_INV_PARAM_FLAG : ALEX_OK_FLAG;
+}
+
+double alex_approx_eval(alex_approx *approx, double x) {
+    double res;
+    alex_set_flag(alex_approx_eval_r(approx, x, &res));
+    return res;
+}
+
+int alex_approx_eval_many_r(alex_approx *approx, const double *xs, double *out, size_t n) {
+    if (approx == NULL || (n > 0 && (xs == NULL || out == NULL))) {
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    int flag = ALEX_OK_FLAG;
+    unsigned int k = 0;
+    for (size_t i = 0; i < n; ++i) {
+        double x = xs[i];
+        if (!(x >= approx->breaks[k] && x <= approx->breaks[k + 1])) {
+            k = _approx_find(approx, x);
+            if (_approx_outside(approx, x)) {
+                flag = ALEX_INV_PARAM_FLAG;
+            }
+        }
+        out[i] = _approx_piece_eval(approx, k, x);
+    }
+    return flag;
+}
+
+void alex_approx_eval_many(alex_approx *approx, const double *xs, double *out, size_t n) {
+    alex_set_flag(alex_approx_eval_many_r(approx, xs, out, n));
+}
+
+static double _approx_func(double x, void *ctx) {
+    double res;
+    alex_approx_eval_r(ctx, x, &res);
+    return res;
+}
+
+static void _approx_vfunc(const double *x, double *y, size_t n, void *ctx) {
+    alex_approx_eval_many_r(ctx, x, y, n);
+}
+
+alex_closure_1d alex_approx_closure(alex_approx *approx) {
+    return alex_make_closure(&_approx_func, approx);
+}
+
+alex_vclosure_1d alex_approx_vclosure(alex_approx *approx) {
+    return alex_make_vclosure(&_approx_vfunc, approx);
+}
+
+int alex_approx_integ_range_r(alex_approx *approx, alex_range *range, double *res) {
+    *res = 0;
+    if (approx == NULL || range == NULL || _approx_outside(approx, range->min)
+            || _approx_outside(approx, range->max)) {
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    double sum = 0;
+    for (unsigned int k = _approx_find(approx, range->min), last = _approx_find(approx, range->max); k <= last; ++k) {
+        double a = approx->breaks[k], b = approx->breaks[k + 1], center = (a + b) / 2, half = (b - a) / 2, integ;
+        alex_range local = {((range->min > a ? range->min : a) - center) / half,
+                ((range->max < b ? range->max : b) - center) / half};
+        alex_poly_integ_range_r(approx->pieces + k, &local, &integ);
+        sum += half * integ;
+    }
+
+    *res = sum;
+    return ALEX_OK_FLAG;
+}
+
+double alex_approx_integ_range(alex_approx *approx, alex_range *range) {
+    double res;
+    alex_set_flag(alex_approx_integ_range_r(approx, range, &res));
+    return res;
+}
+
+int alex_approx_diff_r(alex_approx *approx, alex_approx **res) {
+    *res = NULL;
+    if (approx == NULL) {
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    size_t ncoeffs = 0;
+    for (unsigned int k = 0; k < approx->npieces; ++k) {
+        ncoeffs += approx->pieces[k].deg == 0 ? 1u : approx->pieces[k].deg;
+    }
+
+    double *dst;
+    alex_approx *diff = _approx_alloc(approx->npieces, ncoeffs, &dst);
+    if (diff == NULL) {
+        return ALEX_BAD_ALLOC_FLAG;
+    }
+
+    for (unsigned int k = 0; k <= approx->npieces; ++k) {
+        diff->breaks[k] = approx->breaks[k];
+    }
+    for (unsigned int k = 0; k < approx->npieces; ++k) {
+        // d/dx = d/dt / half
+        alex_poly *src = approx->pieces + k, *piece = diff->pieces + k;
+        double half = (approx->breaks[k + 1] - approx->breaks[k]) / 2;
+        piece->deg = src->deg == 0 ? 0u : src->deg - 1;
+        piece->cap = piece->deg + 1;
+        piece->coeffs = dst;
+        if (src->deg == 0) {
+            *dst++ = 0;
+        }
+        for (unsigned int i = 1; i <= src->deg; ++i) {
+            *dst++ = i * src->coeffs[i] / half;
+        }
+    }
+
+    *res = diff;
+    return ALEX_OK_FLAG;
+}
+
+alex_approx *alex_approx_diff(alex_approx *approx) {
+    alex_approx *res;
+    alex_set_flag(alex_approx_diff_r(approx, &res));
+    return res;
+}
@@ -0,0 +1,122 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <stdlib.h>
+#include <stddef.h>
+
+#include "../include/arena.h"
+#include "../include/flags.h"
+
+typedef struct _arena_chunk {
+    struct _arena_chunk *next;
+    size_t size;
+    size_t used;
+} _arena_chunk;
+
+struct alex_arena {
+    size_t chunk_size;
+    _arena_chunk *head;
+    _arena_chunk *cur;
+};
+
+#define _arena_round(n) (((n) + ALEX_ARENA_ALIGN - 1) & ~(ALEX_ARENA_ALIGN - 1))
+#define _arena_data(chunk) ((char *) (chunk) + _arena_round(sizeof(_arena_chunk)))
+
+alex_arena *alex_make_arena(size_t chunk_size) {
+    alex_arena *arena = malloc(sizeof(alex_arena));
+    if (arena == NULL) {
+        alex_set_flag(ALEX_BAD_ALLOC_FLAG);
+        return NULL;
+    }
+
+    arena->chunk_size = chunk_size ? chunk_size : ALEX_DEFAULT_ARENA_CHUNK;
+    arena->head = arena->cur = NULL;
+    alex_set_flag(ALEX_OK_FLAG);
+    return arena;
+}
+
+void alex_free_arena(alex_arena *arena) {
+    if (arena == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return;
+    }
+
+    _arena_chunk *chunk = arena->head;
+    while (chunk != NULL) {
+        _arena_chunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    free(arena);
+    alex_set_flag(ALEX_OK_FLAG);
+}
+
+void *alex_arena_alloc(alex_arena *arena, size_t size) {
+    if (arena == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+
+    size = _arena_round(size);
+    _arena_chunk *chunk = arena->cur;
+
+    // skip over recycled chunks which are too small for this request
+    while (chunk != NULL && chunk->size - chunk->used < size) {
+        chunk = chunk->next;
+    }
+
+    if (chunk == NULL) {
+        size_t chunk_size = size > arena->chunk_size ? size : arena->chunk_size;
+        chunk = malloc(_arena_round(sizeof(_arena_chunk)) + chunk_size);
+        if (chunk == NULL) {
+            alex_set_flag(ALEX_BAD_ALLOC_FLAG);
+            return NULL;
+        }
+        chunk->size = chunk_size;
+        chunk->used = 0;
+
+        // the new chunk becomes the current one, following those in use
+        if (arena->cur == NULL) {
+            chunk->next = arena->head;
+            arena->head = chunk;
+        }
+        else {
+            chunk->next = arena->cur->next;
+            arena->cur->next = chunk;
+        }
+    }
+
+    arena->cur = chunk;
+    void *block = _arena_data(chunk) + chunk->used;
+    chunk->used += size;
+    alex_set_flag(ALEX_OK_FLAG);
+    return block;
+}
+
+void alex_arena_reset(alex_arena *arena) {
+    if (arena == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return;
+    }
+
+    for (_arena_chunk *chunk = arena->head; chunk != NULL; chunk = chunk->next) {
+        chunk->used = 0;
+    }
+    arena->cur = arena->head;
+    alex_set_flag(ALEX_OK_FLAG);
+}
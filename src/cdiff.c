@@ -0,0 +1,43 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <math.h>
+
+#include "../include/cdiff.h"
+#include "../include/flags.h"
+
+#ifndef CMPLX
+#define CMPLX(x, y) ((double complex) ((double) (x) + I * (double) (y)))
+#endif
+
+int alex_diff_complex_r(alex_ctxcfunc_1d f, void *ctx, double x, double *res) {
+    double h = ALEX_COMPLEX_STEP * fmax(fabs(x), 1.);
+    *res = cimag(f(CMPLX(x, h), ctx)) / h;
+    return ALEX_OK_FLAG;
+}
+
+static double complex _cfunc_trampoline(double complex z, void *ctx) {
+    return (*(alex_cfunc_1d *) ctx)(z);
+}
+
+double alex_diff_complex(alex_cfunc_1d f, double x) {
+    double res;
+    alex_set_flag(alex_diff_complex_r(&_cfunc_trampoline, &f, x, &res));
+    return res;
+}
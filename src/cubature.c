@@ -0,0 +1,586 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "../include/cubature.h"
+#include "../include/flags.h"
+#include "../include/stats.h"
+#include "../include/parallel.h"
+#include "sum.h"
+
+static int _check_box(unsigned int dim, alex_range *box[]) {
+    if (dim == 0 || dim > ALEX_MAX_DIM || box == NULL) {
+        return ALEX_INV_PARAM_FLAG;
+    }
+    for (unsigned int j = 0; j < dim; ++j) {
+        if (box[j] == NULL) {
+            return ALEX_INV_PARAM_FLAG;
+        }
+    }
+    return ALEX_OK_FLAG;
+}
+
+static void _set_info(alex_cubature_info *info, double abserr, unsigned long nevals) {
+    if (info != NULL) {
+        info->abserr = abserr;
+        info->nevals = nevals;
+    }
+}
+
+// same partition as the parallel integrators in integrate.c
+static size_t _nchunks(unsigned long count) {
+    size_t nchunks = (count + ALEX_PAR_CHUNK - 1) / ALEX_PAR_CHUNK;
+    return nchunks > ALEX_PAR_MAX_CHUNKS ? ALEX_PAR_MAX_CHUNKS : nchunks;
+}
+
+// floor(count * k / nchunks) without overflowing
+static unsigned long _chunk_bound(unsigned long count, size_t k, size_t nchunks) {
+    return count / nchunks * k + count % nchunks * k / nchunks;
+}
+
+/*
+ * Tensor-product Gauss-Legendre rule. The points are enumerated like the numbers with dim
+ * digits in base n, the last axis being the fastest, and chunk k stores its weighted sum in
+ * partial[k].
+ */
+typedef struct {
+    alex_vclosure_nd f;
+    unsigned int dim, n;
+    const double *nodes, *weights;
+    double center[ALEX_MAX_DIM], half[ALEX_MAX_DIM];
+    unsigned long count;
+    size_t nchunks;
+    double *partial;
+} _gauss_job;
+
+static void _gauss_chunk(size_t k, void *ctx) {
+    _gauss_job *job = ctx;
+    unsigned long lo = _chunk_bound(job->count, k, job->nchunks),
+            hi = _chunk_bound(job->count, k + 1, job->nchunks);
+
+    unsigned int digit[ALEX_MAX_DIM], dim = job->dim;
+    unsigned long rest = lo;
+    for (unsigned int j = dim; j-- > 0;) {
+        digit[j] = (unsigned int) (rest % job->n);
+        rest /= job->n;
+    }
+
+    double x[ALEX_VEC_BLOCK * ALEX_MAX_DIM], w[ALEX_VEC_BLOCK], y[ALEX_VEC_BLOCK], sum = 0;
+    for (unsigned long i = lo; i < hi;) {
+        size_t m = hi - i < ALEX_VEC_BLOCK ? hi - i : ALEX_VEC_BLOCK;
+        for (size_t p = 0; p < m; ++p) {
+            double weight = 1;
+            for (unsigned int j = 0; j < dim; ++j) {
+                x[p * dim + j] = job->center[j] + job->half[j] * job->nodes[digit[j]];
+                weight *= job->weights[digit[j]];
+            }
+            w[p] = weight;
+            for (unsigned int j = dim; j-- > 0 && ++digit[j] == job->n;) {
+                digit[j] = 0;
+            }
+        }
+
+        job->f.func(dim, x, y, m, job->f.ctx);
+        for (size_t p = 0; p < m; ++p) {
+            sum += w[p] * y[p];
+        }
+        i += m;
+    }
+    job->partial[k] = sum;
+}
+
+int alex_integrate_gauss_nd_r(alex_vclosure_nd f, unsigned int dim, alex_range *box[], unsigned int n,
+        const alex_integ_ctx *ctx, double *res) {
+    ALEX_STATS_SCOPE(ALEX_STATS_CUBATURE);
+    ALEX_STATS_NDCOUNT(f);
+    *res = 0;
+    int flag = _check_box(dim, box);
+    if (flag != ALEX_OK_FLAG) {
+        return flag;
+    }
+
+    _gauss_job job;
+    if ((flag = alex_gauss_legendre(n, &job.nodes, &job.weights)) != ALEX_OK_FLAG) {
+        return flag;
+    }
+
+    double scale = 1;
+    job.count = 1;
+    for (unsigned int j = 0; j < dim; ++j) {
+        if (job.count > ULONG_MAX / n) {
+            return ALEX_INV_PARAM_FLAG;
+        }
+        job.count *= n;
+        job.center[j] = (box[j]->min + box[j]->max) / 2;
+        job.half[j] = alex_range_abs(box[j]) / 2;
+        scale *= job.half[j];
+    }
+
+    job.f = f;
+    job.dim = dim;
+    job.n = n;
+    job.nchunks = _nchunks(job.count);
+    if ((job.partial = malloc(job.nchunks * sizeof(double))) == NULL) {
+        return ALEX_BAD_ALLOC_FLAG;
+    }
+
+    alex_pool_for(ctx == NULL ? NULL : ctx->pool, ctx == NULL ? 0u : ctx->threads, job.nchunks,
+            &_gauss_chunk, &job);
+
+    *res = scale * alex_internal_sum_pairwise(job.partial, job.nchunks);
+    free(job.partial);
+    return ALEX_OK_FLAG;
+}
+
+static void _func_2d_vfunc(unsigned int dim, const double *x, double *y, size_t n, void *ctx) {
+    (void) dim; // always 2
+    alex_func_2d f = *(alex_func_2d *) ctx;
+    for (size_t i = 0; i < n; ++i, x += 2) {
+        y[i] = f(x[0], x[1]);
+    }
+}
+
+static void _func_3d_vfunc(unsigned int dim, const double *x, double *y, size_t n, void *ctx) {
+    (void) dim; // always 3
+    alex_func_3d f = *(alex_func_3d *) ctx;
+    for (size_t i = 0; i < n; ++i, x += 3) {
+        y[i] = f(x[0], x[1], x[2]);
+    }
+}
+
+// the classic routines run on the calling thread only, since plain functions are rarely thread-safe
+static const alex_integ_ctx _single_thread = {1, ALEX_SUM_NAIVE, NULL};
+
+double alex_integrate_gauss_2d(alex_func_2d f, alex_range *rangeX, alex_range *rangeY, unsigned int n) {
+    alex_range *box[2] = {rangeX, rangeY};
+    double res;
+    alex_set_flag(alex_integrate_gauss_nd_r(alex_make_vclosure_nd(&_func_2d_vfunc, &f), 2, box, n,
+            &_single_thread, &res));
+    return res;
+}
+
+double alex_integrate_gauss_3d(alex_func_3d f, alex_range *rangeX, alex_range *rangeY, alex_range *rangeZ,
+        unsigned int n) {
+    alex_range *box[3] = {rangeX, rangeY, rangeZ};
+    double res;
+    alex_set_flag(alex_integrate_gauss_nd_r(alex_make_vclosure_nd(&_func_3d_vfunc, &f), 3, box, n,
+            &_single_thread, &res));
+    return res;
+}
+
+double alex_integrate_gauss_nd(alex_func_nd f, int dim, alex_range *box[], unsigned int n) {
+    double res;
+    alex_set_flag(alex_integrate_gauss_nd_r(alex_func_nd_vclosure(&f), (unsigned int) dim, box, n,
+            &_single_thread, &res));
+    return res;
+}
+
+/*
+ * Primitive polynomials and initial direction numbers of the Sobol sequence for the dimensions
+ * 2, ..., 16, from the new-joe-kuo-6.21201 table of S. Joe and F. Y. Kuo. The first dimension is
+ * the van der Corput sequence in base 2.
+ */
+static const struct {
+    unsigned char s, a;
+    unsigned char m[6];
+} _sobol_params[ALEX_MAX_DIM - 1] = {
+    {1, 0, {1}},
+    {2, 1, {1, 3}},
+    {3, 1, {1, 3, 1}},
+    {3, 2, {1, 1, 1}},
+    {4, 1, {1, 1, 3, 3}},
+    {4, 4, {1, 3, 5, 13}},
+    {5, 2, {1, 1, 5, 5, 17}},
+    {5, 4, {1, 1, 5, 5, 5}},
+    {5, 7, {1, 1, 7, 11, 19}},
+    {5, 11, {1, 1, 5, 1, 1}},
+    {5, 13, {1, 1, 1, 3, 11}},
+    {5, 14, {1, 3, 5, 5, 31}},
+    {6, 1, {1, 3, 3, 9, 7, 49}},
+    {6, 13, {1, 1, 1, 15, 21, 21}},
+    {6, 16, {1, 3, 1, 13, 27, 49}}
+};
+
+#define _SOBOL_BITS 32u
+
+static const unsigned int _halton_primes[ALEX_MAX_DIM] = {
+    2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53
+};
+
+static void _sobol_directions(unsigned int dim, uint32_t v[][_SOBOL_BITS]) {
+    for (unsigned int k = 0; k < _SOBOL_BITS; ++k) {
+        v[0][k] = (uint32_t) 1 << (31 - k);
+    }
+    for (unsigned int j = 1; j < dim; ++j) {
+        unsigned int s = _sobol_params[j - 1].s, a = _sobol_params[j - 1].a;
+        for (unsigned int k = 0; k < s; ++k) {
+            v[j][k] = (uint32_t) _sobol_params[j - 1].m[k] << (31 - k);
+        }
+        for (unsigned int k = s; k < _SOBOL_BITS; ++k) {
+            v[j][k] = v[j][k - s] ^ (v[j][k - s] >> s);
+            for (unsigned int l = 1; l < s; ++l) {
+                if ((a >> (s - 1 - l)) & 1u) {
+                    v[j][k] ^= v[j][k - l];
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Fills x with the points first, ..., first + n - 1 (already validated), the Sobol points being
+ * advanced in Gray code order from the directly computed first one and XORed with dshift.
+ */
+static void _qmc_fill(alex_qmc_seq seq, unsigned int dim, const uint32_t v[][_SOBOL_BITS],
+        const uint32_t *dshift, unsigned long first, size_t n, double *x) {
+    if (seq == ALEX_QMC_SOBOL) {
+        uint32_t state[ALEX_MAX_DIM], gray = (uint32_t) (first ^ (first >> 1));
+        for (unsigned int j = 0; j < dim; ++j) {
+            state[j] = dshift[j];
+            for (unsigned int k = 0; k < _SOBOL_BITS; ++k) {
+                if ((gray >> k) & 1u) {
+                    state[j] ^= v[j][k];
+                }
+            }
+        }
+        for (size_t i = 0; i < n; ++i) {
+            unsigned int bit = 0;
+            for (unsigned long next = first + i + 1; !(next & 1ul); next >>= 1) {
+                ++bit;
+            }
+            for (unsigned int j = 0; j < dim; ++j) {
+                x[i * dim + j] = state[j] * 0x1p-32;
+                if (bit < _SOBOL_BITS) { // past the last point otherwise
+                    state[j] ^= v[j][bit];
+                }
+            }
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        for (unsigned int j = 0; j < dim; ++j) {
+            unsigned long index = first + i + 1, base = _halton_primes[j];
+            double inv = 1. / (double) base, scale = inv, r = 0;
+            for (; index != 0; index /= base) {
+                r += scale * (double) (index % base);
+                scale *= inv;
+            }
+            x[i * dim + j] = r;
+        }
+    }
+}
+
+static int _check_seq(alex_qmc_seq seq, unsigned long first, size_t n) {
+    if (seq == ALEX_QMC_SOBOL) {
+        return (unsigned long long) first + n <= 1ull << _SOBOL_BITS ? ALEX_OK_FLAG : ALEX_INV_PARAM_FLAG;
+    }
+    return seq == ALEX_QMC_HALTON && n <= ULONG_MAX - first ? ALEX_OK_FLAG : ALEX_INV_PARAM_FLAG;
+}
+
+int alex_qmc_points(alex_qmc_seq seq, unsigned int dim, unsigned long first, size_t n, double *x) {
+    if (dim == 0 || dim > ALEX_MAX_DIM || x == NULL || _check_seq(seq, first, n) != ALEX_OK_FLAG) {
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    uint32_t v[ALEX_MAX_DIM][_SOBOL_BITS], dshift[ALEX_MAX_DIM] = {0};
+    if (seq == ALEX_QMC_SOBOL) {
+        _sobol_directions(dim, v);
+    }
+    _qmc_fill(seq, dim, v, dshift, first, n, x);
+    return ALEX_OK_FLAG;
+}
+
+/*
+ * splitmix64 seeds the xoshiro256** streams, see https://prng.di.unimi.it
+ */
+static uint64_t _splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+typedef struct {
+    uint64_t s[4];
+} _rng;
+
+static void _rng_seed(_rng *rng, uint64_t seed, uint64_t stream) {
+    // hashing the stream index keeps the splitmix64 sequences of neighbouring streams apart
+    uint64_t state = stream;
+    state = seed ^ _splitmix64(&state);
+    for (int i = 0; i < 4; ++i) {
+        rng->s[i] = _splitmix64(&state);
+    }
+}
+
+static inline uint64_t _rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// uniformly distributed in [0, 1)
+static inline double _rng_next(_rng *rng) {
+    uint64_t *s = rng->s, res = _rotl(s[1] * 5, 7) * 9, t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = _rotl(s[3], 45);
+    return (double) (res >> 11) * 0x1p-53;
+}
+
+/*
+ * Randomized quasi-Monte Carlo. Task t covers chunk t % nchunks of replica t / nchunks, whose
+ * points are randomized with dshift[replica] (Sobol, digital shift) or shift[replica] (Halton,
+ * shift modulo 1) and mapped to the box.
+ */
+typedef struct {
+    alex_vclosure_nd f;
+    unsigned int dim;
+    alex_qmc_seq seq;
+    uint32_t v[ALEX_MAX_DIM][_SOBOL_BITS];
+    uint32_t dshift[ALEX_QMC_REPLICAS][ALEX_MAX_DIM];
+    double shift[ALEX_QMC_REPLICAS][ALEX_MAX_DIM], min[ALEX_MAX_DIM], width[ALEX_MAX_DIM];
+    unsigned long count;
+    size_t nchunks;
+    double *partial;
+} _qmc_job;
+
+static void _qmc_task(size_t t, void *ctx) {
+    _qmc_job *job = ctx;
+    size_t r = t / job->nchunks, k = t % job->nchunks;
+    unsigned long lo = _chunk_bound(job->count, k, job->nchunks),
+            hi = _chunk_bound(job->count, k + 1, job->nchunks);
+
+    unsigned int dim = job->dim;
+    double x[ALEX_VEC_BLOCK * ALEX_MAX_DIM], y[ALEX_VEC_BLOCK], sum = 0;
+    for (unsigned long i = lo; i < hi;) {
+        size_t m = hi - i < ALEX_VEC_BLOCK ? hi - i : ALEX_VEC_BLOCK;
+        _qmc_fill(job->seq, dim, job->v, job->dshift[r], i, m, x);
+        for (size_t p = 0; p < m; ++p) {
+            for (unsigned int j = 0; j < dim; ++j) {
+                double u = x[p * dim + j] + job->shift[r][j];
+                u -= (double) (u >= 1);
+                x[p * dim + j] = job->min[j] + job->width[j] * u;
+            }
+        }
+
+        job->f.func(dim, x, y, m, job->f.ctx);
+        for (size_t p = 0; p < m; ++p) {
+            sum += y[p];
+        }
+        i += m;
+    }
+    job->partial[t] = sum;
+}
+
+int alex_integrate_qmc_r(alex_vclosure_nd f, unsigned int dim, alex_range *box[], alex_qmc_seq seq,
+        unsigned long npoints, unsigned long seed, const alex_integ_ctx *ctx, alex_cubature_info *info,
+        double *res) {
+    ALEX_STATS_SCOPE(ALEX_STATS_CUBATURE);
+    ALEX_STATS_NDCOUNT(f);
+    *res = 0;
+    _set_info(info, 0, 0);
+    unsigned long count = npoints / ALEX_QMC_REPLICAS;
+    if (_check_box(dim, box) != ALEX_OK_FLAG || count == 0 || _check_seq(seq, 0, count) != ALEX_OK_FLAG) {
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    _qmc_job *job = malloc(sizeof(_qmc_job));
+    size_t nchunks = _nchunks(count);
+    double *partial = malloc(ALEX_QMC_REPLICAS * nchunks * sizeof(double));
+    if (job == NULL || partial == NULL) {
+        free(job);
+        free(partial);
+        return ALEX_BAD_ALLOC_FLAG;
+    }
+
+    job->f = f;
+    job->dim = dim;
+    job->seq = seq;
+    job->count = count;
+    job->nchunks = nchunks;
+    job->partial = partial;
+    if (seq == ALEX_QMC_SOBOL) {
+        _sobol_directions(dim, job->v);
+    }
+
+    double volume = 1;
+    for (unsigned int j = 0; j < dim; ++j) {
+        job->min[j] = box[j]->min;
+        job->width[j] = alex_range_abs(box[j]);
+        volume *= job->width[j];
+    }
+    _rng rng;
+    _rng_seed(&rng, seed, 0);
+    for (unsigned int r = 0; r < ALEX_QMC_REPLICAS; ++r) {
+        for (unsigned int j = 0; j < dim; ++j) {
+            if (seq == ALEX_QMC_SOBOL) {
+                job->dshift[r][j] = (uint32_t) (_rng_next(&rng) * 0x1p32);
+                job->shift[r][j] = 0;
+            }
+            else {
+                job->dshift[r][j] = 0;
+                job->shift[r][j] = _rng_next(&rng);
+            }
+        }
+    }
+
+    alex_pool_for(ctx == NULL ? NULL : ctx->pool, ctx == NULL ? 0u : ctx->threads, ALEX_QMC_REPLICAS * nchunks,
+            &_qmc_task, job);
+
+    double est[ALEX_QMC_REPLICAS], mean = 0, var = 0;
+    for (unsigned int r = 0; r < ALEX_QMC_REPLICAS; ++r) {
+        est[r] = volume * alex_internal_sum_pairwise(partial + r * nchunks, nchunks) / (double) count;
+        mean += est[r];
+    }
+    mean /= ALEX_QMC_REPLICAS;
+    for (unsigned int r = 0; r < ALEX_QMC_REPLICAS; ++r) {
+        var += (est[r] - mean) * (est[r] - mean);
+    }
+    var /= ALEX_QMC_REPLICAS - 1;
+
+    free(partial);
+    free(job);
+    *res = mean;
+    _set_info(info, sqrt(var / ALEX_QMC_REPLICAS), count * ALEX_QMC_REPLICAS);
+    return ALEX_OK_FLAG;
+}
+
+double alex_integrate_qmc(alex_func_nd f, int dim, alex_range *box[], unsigned long npoints,
+        alex_cubature_info *info) {
+    double res;
+    alex_set_flag(alex_integrate_qmc_r(alex_func_nd_vclosure(&f), (unsigned int) dim, box, ALEX_QMC_SOBOL,
+            npoints, ALEX_DEFAULT_CUBATURE_SEED, &_single_thread, info, &res));
+    return res;
+}
+
+/*
+ * Plain Monte Carlo. Chunk k draws from the stream k and stores the count, mean and sum of
+ * squared deviations of its function values, which are merged in order afterwards.
+ */
+typedef struct {
+    unsigned long n;
+    double mean, m2;
+} _mc_stats;
+
+typedef struct {
+    alex_vclosure_nd f;
+    unsigned int dim;
+    uint64_t seed;
+    double min[ALEX_MAX_DIM], width[ALEX_MAX_DIM];
+    unsigned long count;
+    size_t nchunks;
+    _mc_stats *partial;
+} _mc_job;
+
+static void _mc_chunk(size_t k, void *ctx) {
+    _mc_job *job = ctx;
+    unsigned long lo = _chunk_bound(job->count, k, job->nchunks),
+            hi = _chunk_bound(job->count, k + 1, job->nchunks);
+
+    _rng rng;
+    _rng_seed(&rng, job->seed, k);
+
+    // the deviations are taken from the first value, which keeps the sums well conditioned
+    unsigned int dim = job->dim;
+    double x[ALEX_VEC_BLOCK * ALEX_MAX_DIM], y[ALEX_VEC_BLOCK], ref = 0, sum = 0, sum2 = 0;
+    for (unsigned long i = lo; i < hi;) {
+        size_t m = hi - i < ALEX_VEC_BLOCK ? hi - i : ALEX_VEC_BLOCK;
+        for (size_t p = 0; p < m; ++p) {
+            for (unsigned int j = 0; j < dim; ++j) {
+                x[p * dim + j] = job->min[j] + job->width[j] * _rng_next(&rng);
+            }
+        }
+
+        job->f.func(dim, x, y, m, job->f.ctx);
+        if (i == lo) {
+            ref = y[0];
+        }
+        for (size_t p = 0; p < m; ++p) {
+            double d = y[p] - ref;
+            sum += d;
+            sum2 += d * d;
+        }
+        i += m;
+    }
+
+    _mc_stats *stats = job->partial + k;
+    stats->n = hi - lo;
+    stats->mean = ref + sum / (double) stats->n;
+    stats->m2 = sum2 - sum * sum / (double) stats->n;
+}
+
+int alex_integrate_mc_r(alex_vclosure_nd f, unsigned int dim, alex_range *box[], unsigned long npoints,
+        unsigned long seed, const alex_integ_ctx *ctx, alex_cubature_info *info, double *res) {
+    ALEX_STATS_SCOPE(ALEX_STATS_CUBATURE);
+    ALEX_STATS_NDCOUNT(f);
+    *res = 0;
+    _set_info(info, 0, 0);
+    if (_check_box(dim, box) != ALEX_OK_FLAG || npoints < 2) {
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    _mc_job job;
+    job.nchunks = _nchunks(npoints);
+    if ((job.partial = malloc(job.nchunks * sizeof(_mc_stats))) == NULL) {
+        return ALEX_BAD_ALLOC_FLAG;
+    }
+
+    job.f = f;
+    job.dim = dim;
+    job.seed = seed;
+    job.count = npoints;
+    double volume = 1;
+    for (unsigned int j = 0; j < dim; ++j) {
+        job.min[j] = box[j]->min;
+        job.width[j] = alex_range_abs(box[j]);
+        volume *= job.width[j];
+    }
+
+    alex_pool_for(ctx == NULL ? NULL : ctx->pool, ctx == NULL ? 0u : ctx->threads, job.nchunks, &_mc_chunk, &job);
+
+    // Chan et al.'s pairwise update of the mean and of the sum of squared deviations
+    _mc_stats total = job.partial[0];
+    for (size_t k = 1; k < job.nchunks; ++k) {
+        _mc_stats *s = job.partial + k;
+        double n = (double) (total.n + s->n), delta = s->mean - total.mean;
+        total.mean += delta * (double) s->n / n;
+        total.m2 += s->m2 + delta * delta * (double) total.n * (double) s->n / n;
+        total.n += s->n;
+    }
+    free(job.partial);
+
+    double var = total.m2 / (double) (npoints - 1);
+    *res = volume * total.mean;
+    _set_info(info, volume * sqrt(var / (double) npoints), npoints);
+    return ALEX_OK_FLAG;
+}
+
+double alex_integrate_mc(alex_func_nd f, int dim, alex_range *box[], unsigned long npoints,
+        alex_cubature_info *info) {
+    double res;
+    alex_set_flag(alex_integrate_mc_r(alex_func_nd_vclosure(&f), (unsigned int) dim, box, npoints,
+            ALEX_DEFAULT_CUBATURE_SEED, &_single_thread, info, &res));
+    return res;
+}
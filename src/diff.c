@@ -17,34 +17,140 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <math.h>
+
 #include "../include/flags.h"
 #include "../include/diff.h"
 #include "../include/integrate.h"
 
 static double dx_step = ALEX_DEFAULT_DX;
 
-double alex_secant_method(alex_func_1d f, alex_range *range, unsigned iterations) {
+int alex_secant_method_r(alex_closure_1d f, alex_range *range, unsigned iterations, double *res) {
     if (iterations == 0) {
-        alex_set_flag(ALEX_INV_PARAM_FLAG);
-        return 0.;
+        *res = 0.;
+        return ALEX_INV_PARAM_FLAG;
     }
 
-    double x0, x1, x2;
-    x0 = range->min;
-    x1 = range->max;
+    double x0 = range->min, x1 = range->max;
+    double f0 = alex_closure_eval(f, x0), f1 = alex_closure_eval(f, x1);
 
-    for (int i = 0; i < iterations; ++i) {
-        x2 = x1 - f(x1) * (x1 - x0) / (f(x1) - f(x0));
+    /*
+     * The value at the previous point is carried over, so each step costs one evaluation.
+     * The iteration stops early once it hits the root or the secant becomes horizontal,
+     * since every further step would divide by zero.
+     */
+    for (unsigned int i = 0; i < iterations && f1 != 0 && f1 != f0; ++i) {
+        double x2 = x1 - f1 * (x1 - x0) / (f1 - f0);
         x0 = x1;
+        f0 = f1;
         x1 = x2;
+        f1 = alex_closure_eval(f, x1);
     }
 
-    return x2;
+    *res = x1;
+    return ALEX_OK_FLAG;
+}
+
+double alex_secant_method(alex_func_1d f, alex_range *range, unsigned iterations) {
+    double res;
+    alex_set_flag(alex_secant_method_r(alex_func_closure(&f), range, iterations, &res));
+    return res;
+}
+
+/*
+ * Turns the relative step dx into an absolute one, scaled by |x| but never below dx itself
+ * so x = 0 is not a division by zero. The step is rounded so that x + h is representable,
+ * otherwise the rounding error of x + h would enter the difference quotient undivided.
+ */
+static double _diff_step(double x, double dx) {
+    double h = dx * fmax(fabs(x), 1.);
+    return (x + h) - x;
+}
+
+int alex_diff_r(alex_closure_1d f, double x, double *res) {
+    double h = _diff_step(x, dx_step);
+    *res = (alex_closure_eval(f, x + h) - alex_closure_eval(f, x)) / h;
+    return ALEX_OK_FLAG;
 }
 
 double alex_diff(alex_func_1d f, double x) {
-    double dx = x * dx_step;
-    return (f(x + dx) - f(x)) / dx;
+    double res;
+    alex_diff_r(alex_func_closure(&f), x, &res); // does not set any flags
+    return res;
+}
+
+int alex_diff_central_r(alex_closure_1d f, double x, double dx, double *res) {
+    if (!(dx > 0)) {
+        *res = 0.;
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    double h = _diff_step(x, dx);
+    *res = (alex_closure_eval(f, x + h) - alex_closure_eval(f, x - h)) / (2 * h);
+    return ALEX_OK_FLAG;
+}
+
+double alex_diff_central(alex_func_1d f, double x) {
+    double res;
+    alex_set_flag(alex_diff_central_r(alex_func_closure(&f), x, ALEX_DEFAULT_CENTRAL_DX, &res));
+    return res;
+}
+
+int alex_diff_richardson_r(alex_closure_1d f, double x, double dx, double *res) {
+    if (!(dx > 0)) {
+        *res = 0.;
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    /*
+     * With D(h) the central difference, (4 D(h/2) - D(h)) / 3 cancels the h^2 error term,
+     * which expands to the five point stencil below.
+     */
+    double h = _diff_step(x, dx);
+    double d1 = alex_closure_eval(f, x + h) - alex_closure_eval(f, x - h);
+    double d2 = alex_closure_eval(f, x + h / 2) - alex_closure_eval(f, x - h / 2);
+    *res = (8 * d2 - d1) / (6 * h);
+    return ALEX_OK_FLAG;
+}
+
+double alex_diff_richardson(alex_func_1d f, double x) {
+    double res;
+    alex_set_flag(alex_diff_richardson_r(alex_func_closure(&f), x, ALEX_DEFAULT_RICHARDSON_DX, &res));
+    return res;
+}
+
+int alex_diff_many(alex_vclosure_1d f, double min, double spacing, size_t n, double *out) {
+    if (!(spacing > 0)) {
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    /*
+     * y[k] holds f at grid index first - 2 + k. Each block evaluates the values the stencils
+     * of its points need, except for the four it shares with the previous block, which are
+     * carried over to the front of the buffer.
+     */
+    double x[ALEX_VEC_BLOCK + 4], y[ALEX_VEC_BLOCK + 4];
+    const double scale = 1. / (12 * spacing);
+    size_t carry = 0;
+
+    for (size_t first = 0; first < n; first += ALEX_VEC_BLOCK) {
+        size_t m = n - first < ALEX_VEC_BLOCK ? n - first : ALEX_VEC_BLOCK, j;
+        for (j = carry; j < m + 4; ++j) {
+            x[j] = min + ((double) (first + j) - 2) * spacing;
+        }
+        f.func(x + carry, y + carry, m + 4 - carry, f.ctx);
+
+        for (j = 0; j < m; ++j) {
+            out[first + j] = ((y[j] - y[j + 4]) + 8 * (y[j + 3] - y[j + 1])) * scale;
+        }
+
+        for (j = 0; j < 4; ++j) {
+            y[j] = y[m + j];
+        }
+        carry = 4;
+    }
+
+    return ALEX_OK_FLAG;
 }
 
 void alex_set_dx(double dx) {
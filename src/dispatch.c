@@ -0,0 +1,115 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/dispatch.h"
+#include "../include/flags.h"
+
+// the same conditions as the kernels in poly.c and polybatch.c
+#if defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+#define _DISPATCH_SSE2
+#if defined(__GNUC__)
+#define _DISPATCH_AVX
+#endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define _DISPATCH_NEON
+#endif
+
+// the selected instruction set, _ISA_UNSET until the first query
+#define _ISA_UNSET 0xffffffffu
+
+static unsigned int _isa = _ISA_UNSET;
+
+static const char *const _isa_names[ALEX_ISA_COUNT] = {"scalar", "sse2", "avx2", "avx512", "neon"};
+
+int alex_isa_supported(unsigned int isa) {
+    switch (isa) {
+        case ALEX_ISA_SCALAR:
+            return 1;
+#if defined(_DISPATCH_SSE2)
+        case ALEX_ISA_SSE2:
+            return 1;
+#endif
+#if defined(_DISPATCH_AVX)
+        case ALEX_ISA_AVX2:
+            return __builtin_cpu_supports("avx2") != 0;
+        case ALEX_ISA_AVX512:
+            return __builtin_cpu_supports("avx512f") != 0;
+#endif
+#if defined(_DISPATCH_NEON)
+        case ALEX_ISA_NEON:
+            return 1;
+#endif
+        default:
+            return 0;
+    }
+}
+
+unsigned int alex_isa_detected(void) {
+    // SSE2 and NEON are part of the x86_64 and AArch64 baselines, only the wider sets are probed
+    static const unsigned int order[] = {ALEX_ISA_AVX512, ALEX_ISA_AVX2, ALEX_ISA_SSE2, ALEX_ISA_NEON};
+    for (size_t i = 0; i < sizeof(order) / sizeof(order[0]); ++i) {
+        if (alex_isa_supported(order[i]))
+            return order[i];
+    }
+    return ALEX_ISA_SCALAR;
+}
+
+// the detected instruction set, overridden by the environment if it names a supported one
+static unsigned int _isa_initial(void) {
+    const char *env = getenv("ALEX_ISA");
+    if (env != NULL) {
+        for (unsigned int isa = 0; isa < ALEX_ISA_COUNT; ++isa) {
+            if (strcmp(env, _isa_names[isa]) == 0 && alex_isa_supported(isa))
+                return isa;
+        }
+    }
+    return alex_isa_detected();
+}
+
+unsigned int alex_get_isa(void) {
+    unsigned int isa = __atomic_load_n(&_isa, __ATOMIC_RELAXED);
+    if (isa == _ISA_UNSET) {
+        // racing threads compute the same value, the first one wins without overriding alex_set_isa()
+        unsigned int expected = _ISA_UNSET;
+        isa = _isa_initial();
+        if (!__atomic_compare_exchange_n(&_isa, &expected, isa, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            isa = expected;
+        }
+    }
+    return isa;
+}
+
+void alex_set_isa(unsigned int isa) {
+    if (isa == ALEX_ISA_AUTO) {
+        isa = alex_isa_detected();
+    }
+    if (!alex_isa_supported(isa)) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return;
+    }
+
+    __atomic_store_n(&_isa, isa, __ATOMIC_RELAXED);
+    alex_set_flag(ALEX_OK_FLAG);
+}
+
+const char *alex_isa_name(unsigned int isa) {
+    return isa < ALEX_ISA_COUNT ? _isa_names[isa] : "unknown";
+}
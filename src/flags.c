@@ -17,14 +17,17 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#undef ALEX_INLINE // this file defines the out-of-line functions which ALEX_INLINE replaces
+
 #include "../include/flags.h"
 
-static int alex_flag = ALEX_OK_FLAG;
+// not static, such that the inline accessors of ALEX_INLINE can refer to it
+ALEX_THREAD_LOCAL int _alex_flag = ALEX_OK_FLAG;
 
 int alex_get_flag(void) {
-    return alex_flag;
+    return _alex_flag;
 }
 
 void alex_set_flag(int flag) {
-    alex_flag = flag;
+    _alex_flag = flag;
 }
\ No newline at end of file
@@ -1,48 +1,246 @@
 #include <stddef.h>
+#include <limits.h>
+#include <math.h>
+#include <string.h>
 
 #include "../include/func.h"
 #include "../include/flags.h"
 
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+alex_closure_1d alex_make_closure(alex_ctxfunc_1d func, void *ctx) {
+    alex_closure_1d closure = {func, ctx};
+    return closure;
+}
+
+static double _func_1d_closure(double x, void *ctx) {
+    return (*(alex_func_1d *) ctx)(x);
+}
+
+alex_closure_1d alex_func_closure(alex_func_1d *f) {
+    return alex_make_closure(&_func_1d_closure, f);
+}
+
+alex_vclosure_1d alex_make_vclosure(alex_vfunc_1d func, void *ctx) {
+    alex_vclosure_1d closure = {func, ctx};
+    return closure;
+}
+
+static void _closure_vfunc(const double *x, double *y, size_t n, void *ctx) {
+    alex_closure_1d f = *(alex_closure_1d *) ctx;
+    for (size_t i = 0; i < n; ++i) {
+        y[i] = alex_closure_eval(f, x[i]);
+    }
+}
+
+alex_vclosure_1d alex_closure_vclosure(alex_closure_1d *f) {
+    return alex_make_vclosure(&_closure_vfunc, f);
+}
+
+alex_vclosure_nd alex_make_vclosure_nd(alex_vfunc_nd func, void *ctx) {
+    alex_vclosure_nd closure = {func, ctx};
+    return closure;
+}
+
+static void _func_nd_vfunc(unsigned int dim, const double *x, double *y, size_t n, void *ctx) {
+    alex_func_nd f = *(alex_func_nd *) ctx;
+    double v[ALEX_MAX_DIM]; // f may modify its argument
+    for (size_t i = 0; i < n; ++i) {
+        memcpy(v, x + i * dim, dim * sizeof(double));
+        y[i] = f((int) dim, v);
+    }
+}
+
+alex_vclosure_nd alex_func_nd_vclosure(alex_func_nd *f) {
+    return alex_make_vclosure_nd(&_func_nd_vfunc, f);
+}
+
+/*
+ * n! for n = 0, ..., 20, the largest factorials which fit into 64 bits. The lookup replaces
+ * the multiplication loop entirely, unsigned int factorials use the first 13 entries.
+ */
+static const unsigned long long _fact_table[21] = {
+    1ull,
+    1ull,
+    2ull,
+    6ull,
+    24ull,
+    120ull,
+    720ull,
+    5040ull,
+    40320ull,
+    362880ull,
+    3628800ull,
+    39916800ull,
+    479001600ull,
+    6227020800ull,
+    87178291200ull,
+    1307674368000ull,
+    20922789888000ull,
+    355687428096000ull,
+    6402373705728000ull,
+    121645100408832000ull,
+    2432902008176640000ull
+};
+
+#define _FACT_MAX_UINT 12u
+#define _FACT_MAX_ULONG (ULONG_MAX >= 2432902008176640000ull ? 20ul : 12ul)
+
+int alex_fact_r(unsigned int x, unsigned int *res) {
+    if (x > _FACT_MAX_UINT) {
+        *res = 0;
+        return ALEX_FACT_OVERFLOW_FLAG;
+    }
+
+    *res = (unsigned int) _fact_table[x];
+    return ALEX_OK_FLAG;
+}
+
 unsigned int alex_fact(unsigned int x) {
-    unsigned int res = 1;
-    for (unsigned int i = 0; i < x; ++i ) {
-        res *= i;
-        if (res <= i) {
-            // overflow
-            alex_set_flag(ALEX_FACT_OVERFLOW_FLAG);
-            return 0;
-        }
+    unsigned int res;
+    alex_set_flag(alex_fact_r(x, &res));
+    return res;
+}
+
+int alex_factl_r(unsigned long x, unsigned long *res) {
+    if (x > _FACT_MAX_ULONG) {
+        *res = 0;
+        return ALEX_FACT_OVERFLOW_FLAG;
     }
-    alex_set_flag(ALEX_OK_FLAG);
-    return res*x;
+
+    *res = (unsigned long) _fact_table[x];
+    return ALEX_OK_FLAG;
 }
 
 unsigned long alex_factl(unsigned long x) {
-    unsigned long res = 1;
-    for (unsigned long i = 0; i < x; ++i ) {
-        res *= i;
-        if (res <= i) {
-            // overflow
-            alex_set_flag(ALEX_FACT_OVERFLOW_FLAG);
-            return 0;
+    unsigned long res;
+    alex_set_flag(alex_factl_r(x, &res));
+    return res;
+}
+
+/*
+ * The binomial coefficients are computed multiplicatively,
+ *
+ *     C(m, k) = prod_{i=1}^k (m - k + i) / i,   k = min(n, m - n),
+ *
+ * where the partial product after step i is C(m - k + i, i), an integer. As such every division
+ * is exact. The intermediate product is formed in twice the width of the result, so that it only
+ * overflows if the result itself does.
+ */
+int alex_binom_coeff_r(unsigned int m, unsigned int n, unsigned int *res) {
+    if (m < n) {
+        *res = 0;
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    unsigned int k = n < m - n ? n : m - n;
+    unsigned long long prod = 1;
+    for (unsigned int i = 1; i <= k; ++i) {
+        prod = prod * (m - k + i) / i;
+        if (prod > UINT_MAX) {
+            *res = 0;
+            return ALEX_BINOM_OVERFLOW_FLAG;
         }
     }
-    alex_set_flag(ALEX_OK_FLAG);
-    return res*x;
+
+    *res = (unsigned int) prod;
+    return ALEX_OK_FLAG;
 }
 
 unsigned int alex_binom_coeff(unsigned int m, unsigned int n) {
+    unsigned int res;
+    alex_set_flag(alex_binom_coeff_r(m, n, &res));
+    return res;
+}
+
+int alex_binom_coeffl_r(unsigned long m, unsigned long n, unsigned long *res) {
     if (m < n) {
-        alex_set_flag(ALEX_INV_PARAM_FLAG);
-        return 0;
+        *res = 0L;
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    unsigned long k = n < m - n ? n : m - n;
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 prod = 1;
+    for (unsigned long i = 1; i <= k; ++i) {
+        prod = prod * (m - k + i) / i;
+        if (prod > ULONG_MAX) {
+            *res = 0L;
+            return ALEX_BINOM_OVERFLOW_FLAG;
+        }
+    }
+#else
+    // without a wider type, cancel gcd(prod, i) first: i / g then divides m - k + i evenly
+    unsigned long prod = 1;
+    for (unsigned long i = 1; i <= k; ++i) {
+        unsigned long a = prod, b = i, t;
+        while (b != 0) {
+            t = a % b;
+            a = b;
+            b = t;
+        }
+        unsigned long factor = (m - k + i) / (i / a);
+        if (prod / a > ULONG_MAX / factor) {
+            *res = 0L;
+            return ALEX_BINOM_OVERFLOW_FLAG;
+        }
+        prod = prod / a * factor;
     }
-    return alex_fact(m) / (alex_fact(n) * alex_fact(m - n));
+#endif
+
+    *res = (unsigned long) prod;
+    return ALEX_OK_FLAG;
 }
 
 unsigned long alex_binom_coeffl(unsigned long m, unsigned long n) {
+    unsigned long res;
+    alex_set_flag(alex_binom_coeffl_r(m, n, &res));
+    return res;
+}
+
+/*
+ * Remainder of Stirling's series, ln x! - (x ln x - x + ln(2 pi x) / 2), accurate to
+ * double precision for x > 20.
+ */
+static double _stirling_tail(double x) {
+    double r = 1 / x, r2 = r * r;
+    return r * (1. / 12 - r2 * (1. / 360 - r2 * (1. / 1260 - r2 * (1. / 1680 - r2 * (1. / 1188 - r2 * 691. / 360360)))));
+}
+
+double alex_log_fact(unsigned long x) {
+    alex_set_flag(ALEX_OK_FLAG);
+    if (x <= 20) {
+        return log((double) _fact_table[x]);
+    }
+
+    double d = (double) x;
+    return d * log(d) - d + 0.5 * log(2 * M_PI * d) + _stirling_tail(d);
+}
+
+double alex_log_binom_coeff(unsigned long m, unsigned long n) {
     if (m < n) {
         alex_set_flag(ALEX_INV_PARAM_FLAG);
-        return 0L;
+        return 0.;
     }
-    return alex_factl(m) / (alex_factl(n) * alex_factl(m - n));
+    alex_set_flag(ALEX_OK_FLAG);
+
+    unsigned long k = n < m - n ? n : m - n;
+    if (k <= 64) {
+        double res = 0;
+        for (unsigned long i = 1; i <= k; ++i) {
+            res += log((double) (m - k + i) / (double) i);
+        }
+        return res;
+    }
+
+    /*
+     * Stirling's series for all three factorials, with the large terms combined analytically
+     * such that they do not cancel each other out:
+     * m ln m - k ln k - (m - k) ln(m - k) = k ln(m / k) - (m - k) ln(1 - k / m)
+     */
+    double dm = (double) m, dk = (double) k, dmk = (double) (m - k);
+    return dk * log(dm / dk) - dmk * log1p(-dk / dm) + 0.5 * log(dm / (2 * M_PI * dk * dmk))
+            + _stirling_tail(dm) - _stirling_tail(dk) - _stirling_tail(dmk);
 }
@@ -17,12 +17,25 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#undef ALEX_INLINE // this file defines out-of-line functions which ALEX_INLINE replaces
+
 #include <stdlib.h>
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
 
 #include "../include/integrate.h"
 #include "../include/diff.h"
 #include "../include/func.h"
 #include "../include/flags.h"
+#include "../include/stats.h"
+#include "../include/parallel.h"
+#include "sum.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
 
 static unsigned long nbins = ALEX_DEFAULT_NBINS;
 
@@ -56,71 +69,837 @@ double alex_range_abs(alex_range *range) {
     return range->max - range->min;
 }
 
-double alex_integrate_bins(alex_func_1d f, alex_range *range) {
-    int n = alex_get_bins();
-    double area = 0, cur = range->min, step = alex_range_abs(range) / n;
-    while (cur <= range->max) {
-        area += step * f(cur);
-        cur += step;
+int alex_integrate_bins_r(alex_closure_1d f, alex_range *range, unsigned long nbins, double *res) {
+    ALEX_STATS_SCOPE(ALEX_STATS_INTEGRATE);
+    ALEX_STATS_COUNT(f);
+    if (nbins == 0) {
+        *res = 0;
+        return ALEX_INV_PARAM_FLAG;
     }
 
-    alex_set_flag(ALEX_OK_FLAG);
-    return area;
+    // the abscissae are generated from their index, accumulating the step would drift
+    double sum = 0, step = alex_range_abs(range) / nbins;
+    for (unsigned long i = 0; i < nbins; ++i) {
+        sum += alex_closure_eval(f, range->min + (double) i * step);
+    }
+
+    *res = step * sum;
+    return ALEX_OK_FLAG;
 }
 
-/*
-double alex_integrate_bins2D(alex_func2d f, alex_range *rangeX, alex_func1d callback, *rangeY) {
-    alex_integrate_bins()
+double alex_integrate_bins(alex_func_1d f, alex_range *range) {
+    double res;
+    alex_set_flag(alex_integrate_bins_r(alex_func_closure(&f), range, alex_get_bins(), &res));
+    return res;
 }
-*/
 
-double alex_integrate_rect(alex_func_1d f, alex_range *range, int subintervals) {
+int alex_integrate_rect_r(alex_closure_1d f, alex_range *range, int subintervals, double *res) {
+    ALEX_STATS_SCOPE(ALEX_STATS_INTEGRATE);
+    ALEX_STATS_COUNT(f);
     if (subintervals < 0) {
-        alex_set_flag(ALEX_INV_PARAM_FLAG);
-        return 0;
+        *res = 0;
+        return ALEX_INV_PARAM_FLAG;
     }
 
-    alex_set_flag(ALEX_OK_FLAG);
+    // without extension, this is the composite rule with a single subinterval
+    int n = subintervals ? subintervals : 1;
+    double step = alex_range_abs(range) / n, min = range->min + step / 2, sum = 0;
+    for (int k = 0; k < n; ++k) {
+        sum += alex_closure_eval(f, min + k * step);
+    }
+
+    *res = step * sum;
+    return ALEX_OK_FLAG;
+}
+
+double alex_integrate_rect(alex_func_1d f, alex_range *range, int subintervals) {
+    double res;
+    alex_set_flag(alex_integrate_rect_r(alex_func_closure(&f), range, subintervals, &res));
+    return res;
+}
+
+int alex_integrate_trap_r(alex_closure_1d f, alex_range *range, int subintervals, double *res) {
+    ALEX_STATS_SCOPE(ALEX_STATS_INTEGRATE);
+    ALEX_STATS_COUNT(f);
+    if (subintervals < 0) {
+        *res = 0;
+        return ALEX_INV_PARAM_FLAG;
+    }
 
     double head = (range->max - range->min),
-            body = (range->min + range->max);
+    body = alex_closure_eval(f, range->min) + alex_closure_eval(f, range->max);
 
     if (!subintervals) {
-        return head * f(body / 2);
+        *res = head * body / 2;
+        return ALEX_OK_FLAG;
     }
 
     head /= subintervals;
 
     double mid = 0;
     for (int k = 1; k <= subintervals - 1; ++k) {
-        mid += range->min + k*head;
+        mid += alex_closure_eval(f, range->min + k*head);
     }
-
-    body = f(body / 2 + mid);
-    return head * body;
+    body = body / 2 + mid;
+    *res = head * body;
+    return ALEX_OK_FLAG;
 }
 
 double alex_integrate_trap(alex_func_1d f, alex_range *range, int subintervals) {
+    double res;
+    alex_set_flag(alex_integrate_trap_r(alex_func_closure(&f), range, subintervals, &res));
+    return res;
+}
+
+/*
+ * Sums f(min + i * step) over the indices first, ..., first + count - 1, generating the abscissae
+ * in blocks and summing the values of each block with four independent accumulators.
+ */
+static double _vec_sum(alex_vclosure_1d f, double min, double step, unsigned long first, unsigned long count) {
+    double x[ALEX_VEC_BLOCK], y[ALEX_VEC_BLOCK];
+    double acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+
+    for (unsigned long i = 0; i < count; i += ALEX_VEC_BLOCK) {
+        size_t n = count - i < ALEX_VEC_BLOCK ? count - i : ALEX_VEC_BLOCK, j;
+        for (j = 0; j < n; ++j) {
+            x[j] = min + (double) (first + i + j) * step;
+        }
+
+        f.func(x, y, n, f.ctx);
+        for (j = 0; j + 4 <= n; j += 4) {
+            acc0 += y[j];
+            acc1 += y[j + 1];
+            acc2 += y[j + 2];
+            acc3 += y[j + 3];
+        }
+        for (; j < n; ++j) {
+            acc0 += y[j];
+        }
+    }
+
+    return (acc0 + acc1) + (acc2 + acc3);
+}
+
+int alex_integrate_bins_vec(alex_vclosure_1d f, alex_range *range, unsigned long nbins, double *res) {
+    ALEX_STATS_SCOPE(ALEX_STATS_INTEGRATE);
+    ALEX_STATS_VCOUNT(f);
+    if (nbins == 0) {
+        *res = 0;
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    double step = alex_range_abs(range) / nbins;
+    *res = step * _vec_sum(f, range->min, step, 0, nbins);
+    return ALEX_OK_FLAG;
+}
+
+int alex_integrate_rect_vec(alex_vclosure_1d f, alex_range *range, int subintervals, double *res) {
+    ALEX_STATS_SCOPE(ALEX_STATS_INTEGRATE);
+    ALEX_STATS_VCOUNT(f);
     if (subintervals < 0) {
-        alex_set_flag(ALEX_INV_PARAM_FLAG);
-        return 0;
+        *res = 0;
+        return ALEX_INV_PARAM_FLAG;
     }
 
-    alex_set_flag(ALEX_OK_FLAG);
+    unsigned long n = subintervals ? (unsigned long) subintervals : 1;
+    double step = alex_range_abs(range) / n;
+    *res = step * _vec_sum(f, range->min + step / 2, step, 0, n);
+    return ALEX_OK_FLAG;
+}
+
+int alex_integrate_trap_vec(alex_vclosure_1d f, alex_range *range, int subintervals, double *res) {
+    ALEX_STATS_SCOPE(ALEX_STATS_INTEGRATE);
+    ALEX_STATS_VCOUNT(f);
+    if (subintervals < 0) {
+        *res = 0;
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    double ends[2] = {range->min, range->max}, fends[2];
+    f.func(ends, fends, 2, f.ctx);
 
     double head = (range->max - range->min),
-    body = f(range->min) + f(range->max);
+            body = fends[0] + fends[1];
 
     if (!subintervals) {
-        return head * body / 2;
+        *res = head * body / 2;
+        return ALEX_OK_FLAG;
     }
 
     head /= subintervals;
+    *res = head * (body / 2 + _vec_sum(f, range->min, head, 1, subintervals - 1));
+    return ALEX_OK_FLAG;
+}
 
-    double mid = 0;
-    for (int k = 1; k <= subintervals - 1; ++k) {
-        mid += f(range->min + k*head);
+/*
+ * A parallel sum of f(min + i * step) over the indices first, ..., first + count - 1.
+ * The indices are partitioned into nchunks chunks, chunk k storing its sum in partial[k].
+ */
+typedef struct {
+    alex_closure_1d f;
+    double min, step;
+    unsigned long first, count;
+    size_t nchunks;
+    unsigned int summation;
+    double *partial;
+} _par_sum_job;
+
+// adds v to the compensated sum (*sum, *comp) with the Kahan-Babuska (Neumaier) step
+static inline void _sum_neumaier(double *sum, double *comp, double v) {
+    double t = *sum + v;
+    if (fabs(*sum) >= fabs(v)) {
+        *comp += (*sum - t) + v;
     }
-    body = body / 2 + mid;
-    return head * body;
-}
\ No newline at end of file
+    else {
+        *comp += (v - t) + *sum;
+    }
+    *sum = t;
+}
+
+/*
+ * The compensated or pairwise sum of f over the indices lo, ..., hi - 1. The values are computed in
+ * blocks of ALEX_VEC_BLOCK. In pairwise mode, levels[l] holds the sum of a run of 2^l blocks,
+ * merged as in a binary counter, such that every value goes through O(log n) additions.
+ */
+static double _sum_blocks(const _par_sum_job *job, unsigned long long lo, unsigned long long hi) {
+    double y[ALEX_VEC_BLOCK], levels[64], sums[4] = {0, 0, 0, 0}, comps[4] = {0, 0, 0, 0};
+    unsigned long long nblocks = 0;
+    unsigned int nlevels = 0;
+
+    for (unsigned long long i = lo; i < hi; i += ALEX_VEC_BLOCK) {
+        size_t n = hi - i < ALEX_VEC_BLOCK ? (size_t) (hi - i) : ALEX_VEC_BLOCK, j;
+        for (j = 0; j < n; ++j) {
+            y[j] = alex_closure_eval(job->f, job->min + (double) (i + j) * job->step);
+        }
+
+        if (job->summation == ALEX_SUM_KAHAN) {
+            // four independent accumulators, such that the dependency chains interleave
+            for (j = 0; j + 4 <= n; j += 4) {
+                _sum_neumaier(&sums[0], &comps[0], y[j]);
+                _sum_neumaier(&sums[1], &comps[1], y[j + 1]);
+                _sum_neumaier(&sums[2], &comps[2], y[j + 2]);
+                _sum_neumaier(&sums[3], &comps[3], y[j + 3]);
+            }
+            for (; j < n; ++j) {
+                _sum_neumaier(&sums[0], &comps[0], y[j]);
+            }
+            continue;
+        }
+
+        double block = alex_internal_sum_pairwise(y, n);
+        unsigned int l = 0;
+        for (unsigned long long b = nblocks++; b & 1; b >>= 1) {
+            block += levels[l++];
+        }
+        levels[l] = block;
+        if (l + 1 > nlevels) {
+            nlevels = l + 1;
+        }
+    }
+
+    if (job->summation == ALEX_SUM_KAHAN) {
+        double sum = 0, comp = 0;
+        for (int k = 0; k < 4; ++k) {
+            _sum_neumaier(&sum, &comp, sums[k]);
+            comp += comps[k];
+        }
+        return sum + comp;
+    }
+
+    // the pending runs are those of the set bits of nblocks, the smallest ones first
+    double sum = 0;
+    for (unsigned int l = 0; l < nlevels; ++l) {
+        if (nblocks >> l & 1) {
+            sum += levels[l];
+        }
+    }
+    return sum;
+}
+
+static void _par_sum_chunk(size_t k, void *ctx) {
+    _par_sum_job *job = ctx;
+    unsigned long long lo = (unsigned long long) job->count * k / job->nchunks,
+            hi = (unsigned long long) job->count * (k + 1) / job->nchunks;
+
+    if (job->summation != ALEX_SUM_NAIVE) {
+        job->partial[k] = _sum_blocks(job, job->first + lo, job->first + hi);
+        return;
+    }
+
+    double sum = 0;
+    for (unsigned long long i = job->first + lo; i < job->first + hi; ++i) {
+        sum += alex_closure_eval(job->f, job->min + (double) i * job->step);
+    }
+    job->partial[k] = sum;
+}
+
+static int _par_sum(alex_closure_1d f, double min, double step, unsigned long first, unsigned long count,
+        const alex_integ_ctx *ctx, double *res) {
+    unsigned int summation = ctx == NULL ? ALEX_SUM_NAIVE : ctx->summation;
+    if (summation > ALEX_SUM_KAHAN) {
+        *res = 0;
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    size_t nchunks = (count + ALEX_PAR_CHUNK - 1) / ALEX_PAR_CHUNK;
+    if (nchunks > ALEX_PAR_MAX_CHUNKS) {
+        nchunks = ALEX_PAR_MAX_CHUNKS;
+    }
+    if (nchunks == 0) {
+        *res = 0;
+        return ALEX_OK_FLAG;
+    }
+
+    double *partial = malloc(nchunks * sizeof(double));
+    if (partial == NULL) {
+        *res = 0;
+        return ALEX_BAD_ALLOC_FLAG;
+    }
+
+    _par_sum_job job = {f, min, step, first, count, nchunks, summation, partial};
+    alex_pool_for(ctx == NULL ? NULL : ctx->pool, ctx == NULL ? 0u : ctx->threads, nchunks,
+            &_par_sum_chunk, &job);
+
+    *res = alex_internal_sum_pairwise(partial, nchunks);
+    free(partial);
+    return ALEX_OK_FLAG;
+}
+
+int alex_integrate_bins_par(alex_closure_1d f, alex_range *range, unsigned long nbins,
+        const alex_integ_ctx *ctx, double *res) {
+    ALEX_STATS_SCOPE(ALEX_STATS_INTEGRATE);
+    ALEX_STATS_COUNT(f);
+    if (nbins == 0) {
+        *res = 0;
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    double step = alex_range_abs(range) / nbins, sum;
+    int flag = _par_sum(f, range->min, step, 0, nbins, ctx, &sum);
+
+    *res = flag == ALEX_OK_FLAG ? step * sum : 0;
+    return flag;
+}
+
+int alex_integrate_trap_par(alex_closure_1d f, alex_range *range, unsigned long subintervals,
+        const alex_integ_ctx *ctx, double *res) {
+    ALEX_STATS_SCOPE(ALEX_STATS_INTEGRATE);
+    ALEX_STATS_COUNT(f);
+    double head = alex_range_abs(range),
+            body = alex_closure_eval(f, range->min) + alex_closure_eval(f, range->max);
+
+    if (!subintervals) {
+        *res = head * body / 2;
+        return ALEX_OK_FLAG;
+    }
+
+    head /= subintervals;
+
+    double mid;
+    int flag = _par_sum(f, range->min, head, 1, subintervals - 1, ctx, &mid);
+
+    *res = flag == ALEX_OK_FLAG ? head * (body / 2 + mid) : 0;
+    return flag;
+}
+
+/*
+ * Nodes and weights of the 7-point Gauss and 15-point Kronrod rules on [-1, 1] (from QUADPACK).
+ * The Kronrod nodes with odd index are the Gauss nodes, _gk_xgk[7] is the center.
+ */
+static const double _gk_xgk[8] = {
+    0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+    0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+    0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+    0.207784955007898467600689403773245, 0.000000000000000000000000000000000
+};
+
+static const double _gk_wgk[8] = {
+    0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+    0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+    0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+    0.204432940075298892414161999234649, 0.209482141084727828012999174891714
+};
+
+static const double _gk_wg[4] = {
+    0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+    0.381830050505118944950369775488975, 0.417959183673469387755102040816327
+};
+
+typedef struct {
+    double a, b, result, error;
+} _quad_interval;
+
+/*
+ * Applies the Gauss-Kronrod rule to [a, b], with the error estimate of QUADPACK's qk15.
+ */
+static void _gk15(alex_closure_1d f, _quad_interval *iv) {
+    double center = (iv->a + iv->b) / 2, half = (iv->b - iv->a) / 2, fv[15];
+
+    fv[7] = alex_closure_eval(f, center);
+    for (int j = 0; j < 7; ++j) {
+        double dx = half * _gk_xgk[j];
+        fv[j] = alex_closure_eval(f, center - dx);
+        fv[14 - j] = alex_closure_eval(f, center + dx);
+    }
+
+    double resk = fv[7] * _gk_wgk[7], resg = fv[7] * _gk_wg[3], resabs = fabs(resk);
+    for (int j = 0; j < 7; ++j) {
+        double pair = fv[j] + fv[14 - j];
+        resk += _gk_wgk[j] * pair;
+        resabs += _gk_wgk[j] * (fabs(fv[j]) + fabs(fv[14 - j]));
+        if (j % 2 == 1) {
+            resg += _gk_wg[j / 2] * pair;
+        }
+    }
+
+    double mean = resk / 2, resasc = _gk_wgk[7] * fabs(fv[7] - mean);
+    for (int j = 0; j < 7; ++j) {
+        resasc += _gk_wgk[j] * (fabs(fv[j] - mean) + fabs(fv[14 - j] - mean));
+    }
+
+    double err = fabs((resk - resg) * half);
+    resasc *= fabs(half);
+    resabs *= fabs(half);
+    if (resasc != 0 && err != 0) {
+        double scale = pow(200 * err / resasc, 1.5);
+        err = scale < 1 ? resasc * scale : resasc;
+    }
+    if (resabs > DBL_MIN / (50 * DBL_EPSILON) && err < 50 * DBL_EPSILON * resabs) {
+        err = 50 * DBL_EPSILON * resabs;
+    }
+
+    iv->result = resk * half;
+    iv->error = err;
+}
+
+/*
+ * The subintervals are kept in a binary max-heap ordered by their error estimate.
+ */
+static void _quad_heap_push(_quad_interval *heap, unsigned int n, _quad_interval iv) {
+    unsigned int i = n;
+    while (i > 0 && heap[(i - 1) / 2].error < iv.error) {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = iv;
+}
+
+static _quad_interval _quad_heap_pop(_quad_interval *heap, unsigned int n) {
+    _quad_interval top = heap[0], last = heap[n - 1];
+    unsigned int i = 0, child;
+    --n;
+    while ((child = 2 * i + 1) < n) {
+        if (child + 1 < n && heap[child + 1].error > heap[child].error) {
+            ++child;
+        }
+        if (heap[child].error <= last.error) {
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = last;
+    return top;
+}
+
+int alex_integrate_adaptive_r(alex_closure_1d f, alex_range *range, double epsabs, double epsrel,
+        unsigned int limit, alex_quad_info *info, double *res) {
+    ALEX_STATS_SCOPE(ALEX_STATS_INTEGRATE);
+    ALEX_STATS_COUNT(f);
+    if (epsabs <= 0 && epsrel <= 0) {
+        *res = 0;
+        return ALEX_INV_PARAM_FLAG;
+    }
+    if (limit == 0) {
+        limit = ALEX_DEFAULT_QUAD_LIMIT;
+    }
+
+    _quad_interval *heap = malloc(limit * sizeof(_quad_interval));
+    if (heap == NULL) {
+        *res = 0;
+        return ALEX_BAD_ALLOC_FLAG;
+    }
+
+    _quad_interval whole = {range->min, range->max, 0, 0};
+    _gk15(f, &whole);
+    heap[0] = whole;
+
+    unsigned int n = 1;
+    unsigned long nevals = 15;
+    double result = whole.result, error = whole.error;
+
+    while (error > fmax(epsabs, epsrel * fabs(result)) && n < limit) {
+        _quad_interval worst = _quad_heap_pop(heap, n--);
+        double mid = (worst.a + worst.b) / 2;
+        _quad_interval left = {worst.a, mid, 0, 0}, right = {mid, worst.b, 0, 0};
+
+        _gk15(f, &left);
+        _gk15(f, &right);
+        nevals += 30;
+
+        _quad_heap_push(heap, n++, left);
+        _quad_heap_push(heap, n++, right);
+        result += left.result + right.result - worst.result;
+        error += left.error + right.error - worst.error;
+    }
+
+    // sum up from scratch, the running totals may have drifted
+    result = error = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+        result += heap[i].result;
+        error += heap[i].error;
+    }
+    free(heap);
+
+    if (info != NULL) {
+        info->abserr = error;
+        info->nevals = nevals;
+        info->nintervals = n;
+    }
+
+    *res = result;
+    return error > fmax(epsabs, epsrel * fabs(result)) ? ALEX_INTEG_TOL_FLAG : ALEX_OK_FLAG;
+}
+
+double alex_integrate_adaptive(alex_func_1d f, alex_range *range, double epsabs, double epsrel,
+        alex_quad_info *info) {
+    double res;
+    alex_set_flag(alex_integrate_adaptive_r(alex_func_closure(&f), range, epsabs, epsrel, 0u, info, &res));
+    return res;
+}
+
+int alex_trap_init_r(alex_closure_1d f, alex_range *range, alex_trap_state *state, double *res) {
+    ALEX_STATS_SCOPE(ALEX_STATS_INTEGRATE);
+    ALEX_STATS_COUNT(f);
+    state->min = range->min;
+    state->width = range->max - range->min;
+    state->sum = (alex_closure_eval(f, range->min) + alex_closure_eval(f, range->max)) / 2;
+    state->subintervals = 1;
+    state->nevals = 2;
+
+    if (res != NULL) {
+        *res = state->width * state->sum;
+    }
+    return ALEX_OK_FLAG;
+}
+
+int alex_trap_refine_r(alex_closure_1d f, alex_trap_state *state, double *res) {
+    ALEX_STATS_SCOPE(ALEX_STATS_INTEGRATE);
+    ALEX_STATS_COUNT(f);
+    unsigned long n = state->subintervals;
+    if (n > ULONG_MAX / 2) {
+        return ALEX_ALG_OVERFLOW_FLAG;
+    }
+
+    // the new abscissae are the midpoints min + (2k + 1) * width / 2n
+    double step = state->width / (2 * n), mid = 0;
+    for (unsigned long k = 0; k < n; ++k) {
+        mid += alex_closure_eval(f, state->min + (2 * k + 1) * step);
+    }
+    state->sum += mid;
+    state->subintervals = 2 * n;
+    state->nevals += n;
+
+    if (res != NULL) {
+        *res = step * state->sum;
+    }
+    return ALEX_OK_FLAG;
+}
+
+int alex_integrate_romberg_r(alex_closure_1d f, alex_range *range, double epsabs, double epsrel,
+        unsigned int levels, alex_quad_info *info, double *res) {
+    ALEX_STATS_SCOPE(ALEX_STATS_INTEGRATE);
+    ALEX_STATS_COUNT(f);
+    if (levels == 0) {
+        levels = ALEX_DEFAULT_ROMBERG_LEVELS;
+    }
+    if (!(epsabs > 0 || epsrel > 0) || levels > ALEX_ROMBERG_MAX_LEVELS) {
+        *res = 0;
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    // row[j] holds R(k, j) of the current level, overwritten in place by the next level
+    double row[ALEX_ROMBERG_MAX_LEVELS + 1], trap;
+    alex_trap_state state;
+    alex_trap_init_r(f, range, &state, &row[0]);
+
+    double error = INFINITY;
+    unsigned int k;
+    for (k = 1; k <= levels; ++k) {
+        alex_trap_refine_r(f, &state, &trap);
+
+        double prev = row[0], factor = 4;
+        row[0] = trap;
+        for (unsigned int j = 1; j <= k; ++j) {
+            double extrap = row[j - 1] + (row[j - 1] - prev) / (factor - 1);
+            if (j < k) {
+                prev = row[j];
+            }
+            row[j] = extrap;
+            factor *= 4;
+        }
+
+        // R(k - 1, k - 1) was overwritten, prev still holds it
+        error = fabs(row[k] - prev);
+        if (k >= 4 && error <= fmax(epsabs, epsrel * fabs(row[k]))) {
+            break;
+        }
+    }
+    if (k > levels) {
+        k = levels;
+    }
+
+    if (info != NULL) {
+        info->abserr = error;
+        info->nevals = state.nevals;
+        info->nintervals = (unsigned int) state.subintervals;
+    }
+
+    *res = row[k];
+    return error > fmax(epsabs, epsrel * fabs(row[k])) ? ALEX_INTEG_TOL_FLAG : ALEX_OK_FLAG;
+}
+
+double alex_integrate_romberg(alex_func_1d f, alex_range *range, double epsabs, double epsrel,
+        alex_quad_info *info) {
+    double res;
+    alex_set_flag(alex_integrate_romberg_r(alex_func_closure(&f), range, epsabs, epsrel, 0u, info, &res));
+    return res;
+}
+
+/*
+ * Gauss-Legendre rules, computed on demand and published once through an atomic pointer.
+ * Writers serialize on the mutex, readers only perform an acquire load.
+ */
+typedef struct {
+    double *nodes;
+    double *weights;
+} _gauss_rule;
+
+static _gauss_rule *_gauss_rules[ALEX_GAUSS_MAX_ORDER + 1];
+static pthread_mutex_t _gauss_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Finds the roots of P_n with Newton's method, starting from the Tricomi approximation, and
+ * derives the weights w_i = 2 / ((1 - x_i^2) P_n'(x_i)^2). Only half the roots are computed,
+ * the other half follows by symmetry.
+ */
+static _gauss_rule *_gauss_compute(unsigned int n) {
+    _gauss_rule *rule = malloc(sizeof(_gauss_rule) + 2 * n * sizeof(double));
+    if (rule == NULL) {
+        return NULL;
+    }
+    rule->nodes = (double *) (rule + 1);
+    rule->weights = rule->nodes + n;
+
+    for (unsigned int i = 0; i < (n + 1) / 2; ++i) {
+        double x = cos(M_PI * (i + 0.75) / (n + 0.5)), dp = 1;
+        for (int iter = 0; iter < 100; ++iter) {
+            double p0 = 1, p1 = x;
+            for (unsigned int k = 2; k <= n; ++k) {
+                double p2 = ((2 * k - 1) * x * p1 - (k - 1) * p0) / k;
+                p0 = p1;
+                p1 = p2;
+            }
+            if (n == 1) {
+                p0 = 1;
+            }
+            dp = n * (x * p1 - p0) / (x * x - 1);
+            double dx = p1 / dp;
+            x -= dx;
+            if (fabs(dx) <= 4 * DBL_EPSILON * fabs(x)) {
+                break;
+            }
+        }
+
+        // recompute the derivative at the converged root
+        double p0 = 1, p1 = x;
+        for (unsigned int k = 2; k <= n; ++k) {
+            double p2 = ((2 * k - 1) * x * p1 - (k - 1) * p0) / k;
+            p0 = p1;
+            p1 = p2;
+        }
+        dp = n == 1 ? 1 : n * (x * p1 - p0) / (x * x - 1);
+
+        double w = 2 / ((1 - x * x) * dp * dp);
+        if (2 * i + 1 == n) {
+            x = 0; // center node of odd orders
+        }
+        rule->nodes[i] = -x;
+        rule->nodes[n - 1 - i] = x;
+        rule->weights[i] = rule->weights[n - 1 - i] = w;
+    }
+
+    return rule;
+}
+
+int alex_gauss_legendre(unsigned int n, const double **nodes, const double **weights) {
+    if (n == 0 || n > ALEX_GAUSS_MAX_ORDER) {
+        *nodes = *weights = NULL;
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    _gauss_rule *rule = __atomic_load_n(&_gauss_rules[n], __ATOMIC_ACQUIRE);
+    if (rule == NULL) {
+        pthread_mutex_lock(&_gauss_lock);
+        rule = _gauss_rules[n];
+        if (rule == NULL && (rule = _gauss_compute(n)) != NULL) {
+            __atomic_store_n(&_gauss_rules[n], rule, __ATOMIC_RELEASE);
+        }
+        pthread_mutex_unlock(&_gauss_lock);
+
+        if (rule == NULL) {
+            *nodes = *weights = NULL;
+            return ALEX_BAD_ALLOC_FLAG;
+        }
+    }
+
+    *nodes = rule->nodes;
+    *weights = rule->weights;
+    return ALEX_OK_FLAG;
+}
+
+int alex_integrate_gauss_r(alex_closure_1d f, alex_range *range, unsigned int n, double *res) {
+    ALEX_STATS_SCOPE(ALEX_STATS_INTEGRATE);
+    ALEX_STATS_COUNT(f);
+    const double *nodes, *weights;
+    int flag = alex_gauss_legendre(n, &nodes, &weights);
+    if (flag != ALEX_OK_FLAG) {
+        *res = 0;
+        return flag;
+    }
+
+    double half = alex_range_abs(range) / 2, center = (range->min + range->max) / 2, sum = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+        sum += weights[i] * alex_closure_eval(f, center + half * nodes[i]);
+    }
+
+    *res = half * sum;
+    return ALEX_OK_FLAG;
+}
+
+double alex_integrate_gauss(alex_func_1d f, alex_range *range, unsigned int n) {
+    double res;
+    alex_set_flag(alex_integrate_gauss_r(alex_func_closure(&f), range, n, &res));
+    return res;
+}
+
+int alex_integrate_gauss_vec(alex_vclosure_1d f, alex_range *range, unsigned int n, double *res) {
+    ALEX_STATS_SCOPE(ALEX_STATS_INTEGRATE);
+    ALEX_STATS_VCOUNT(f);
+    const double *nodes, *weights;
+    int flag = alex_gauss_legendre(n, &nodes, &weights);
+    if (flag != ALEX_OK_FLAG) {
+        *res = 0;
+        return flag;
+    }
+
+    double x[ALEX_GAUSS_MAX_ORDER], y[ALEX_GAUSS_MAX_ORDER];
+    double half = alex_range_abs(range) / 2, center = (range->min + range->max) / 2, sum = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+        x[i] = center + half * nodes[i];
+    }
+
+    f.func(x, y, n, f.ctx);
+    for (unsigned int i = 0; i < n; ++i) {
+        sum += weights[i] * y[i];
+    }
+
+    *res = half * sum;
+    return ALEX_OK_FLAG;
+}
+
+int alex_integ_stream_init_r(alex_integ_stream *stream, unsigned int rule) {
+    if (rule != ALEX_STREAM_TRAP && rule != ALEX_STREAM_SIMPSON) {
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    *stream = (alex_integ_stream) {0};
+    stream->rule = rule;
+    return ALEX_OK_FLAG;
+}
+
+// Simpson's rule over [x0, x2] for the possibly unequal intervals [x0, x1] and [x1, x2]
+static inline double _stream_simpson_pair(const double *x, const double *y) {
+    double h0 = x[1] - x[0], h1 = x[2] - x[1], h = h0 + h1;
+    return h / 6 * ((2 - h1 / h0) * y[0] + h * h / (h0 * h1) * y[1] + (2 - h0 / h1) * y[2]);
+}
+
+int alex_integ_stream_feed_r(alex_integ_stream *stream, const double *xs, const double *ys,
+        size_t n, size_t stride) {
+    ALEX_STATS_SCOPE(ALEX_STATS_INTEGRATE);
+    if (stride == 0 || (n > 0 && (xs == NULL || ys == NULL))) {
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    // the state is kept in locals and written back once, such that the loop runs in registers
+    double sum = stream->sum, comp = stream->comp;
+    double x0 = stream->x[0], x1 = stream->x[1], x2 = stream->x[2];
+    double y0 = stream->y[0], y1 = stream->y[1], y2 = stream->y[2];
+    unsigned long count = stream->nsamples;
+    int flag = ALEX_OK_FLAG;
+
+    for (size_t k = 0; k < n; ++k) {
+        double x = xs[k * stride], y = ys[k * stride];
+        if (count > 0 && !(x > x2)) {
+            flag = ALEX_INV_PARAM_FLAG;
+            break;
+        }
+        x0 = x1, x1 = x2, x2 = x;
+        y0 = y1, y1 = y2, y2 = y;
+        ++count;
+
+        if (stream->rule == ALEX_STREAM_TRAP) {
+            if (count >= 2)
+                _sum_neumaier(&sum, &comp, (x2 - x1) * (y1 + y2) / 2);
+        }
+        else if (count >= 3 && count % 2 == 1) {
+            // a pair of intervals ends at every odd sample
+            double px[3] = {x0, x1, x2}, py[3] = {y0, y1, y2};
+            _sum_neumaier(&sum, &comp, _stream_simpson_pair(px, py));
+        }
+    }
+
+    stream->sum = sum;
+    stream->comp = comp;
+    stream->x[0] = x0, stream->x[1] = x1, stream->x[2] = x2;
+    stream->y[0] = y0, stream->y[1] = y1, stream->y[2] = y2;
+    stream->nsamples = count;
+    return flag;
+}
+
+int alex_integ_stream_result_r(const alex_integ_stream *stream, double *res) {
+    const double *x = stream->x, *y = stream->y;
+    unsigned long count = stream->nsamples;
+    double tail = 0;
+
+    if (stream->rule == ALEX_STREAM_SIMPSON && count % 2 == 0 && count >= 2) {
+        if (count == 2) {
+            tail = (x[2] - x[1]) * (y[1] + y[2]) / 2;
+        }
+        else {
+            // the unpaired last interval [x1, x2], over the parabola through the last three samples
+            double h0 = x[1] - x[0], h1 = x[2] - x[1];
+            double alpha = (2 * h1 * h1 + 3 * h0 * h1) / (6 * (h0 + h1));
+            double beta = (h1 * h1 + 3 * h0 * h1) / (6 * h0);
+            double eta = h1 * h1 * h1 / (6 * h0 * (h0 + h1));
+            tail = alpha * y[2] + beta * y[1] - eta * y[0];
+        }
+    }
+
+    *res = stream->sum + (stream->comp + tail);
+    return ALEX_OK_FLAG;
+}
+
+int alex_integrate_samples_r(const double *xs, const double *ys, size_t n, size_t stride,
+        unsigned int rule, double *res) {
+    alex_integ_stream stream;
+    int flag = alex_integ_stream_init_r(&stream, rule);
+    if (flag == ALEX_OK_FLAG)
+        flag = alex_integ_stream_feed_r(&stream, xs, ys, n, stride);
+    if (flag != ALEX_OK_FLAG) {
+        *res = 0;
+        return flag;
+    }
+
+    return alex_integ_stream_result_r(&stream, res);
+}
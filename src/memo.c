@@ -0,0 +1,244 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "../include/memo.h"
+#include "../include/flags.h"
+
+typedef struct {
+    uint64_t keys[ALEX_MEMO_WAYS];
+    double values[ALEX_MEMO_WAYS];
+    unsigned int used, next; // next is the oldest entry once the bucket is full
+} _memo_bucket;
+
+/*
+ * Each stripe is on a cache line of its own, the counters are guarded by its lock. The stripes are
+ * stored behind the memo in the same block, starting at the first line boundary past it.
+ */
+#define _MEMO_LINE 64ul
+
+typedef struct {
+    pthread_mutex_t lock;
+    unsigned long hits, misses, evictions;
+} _memo_stripe;
+
+typedef union {
+    _memo_stripe stripe;
+    char pad[((sizeof(_memo_stripe) + _MEMO_LINE - 1) / _MEMO_LINE) * _MEMO_LINE];
+} _memo_padded_stripe;
+
+struct alex_memo {
+    alex_closure_1d f;
+    int shared;
+    size_t mask, stripe_mask;
+    _memo_bucket *buckets;
+    _memo_padded_stripe *stripes;
+};
+
+static inline uint64_t _memo_hash(uint64_t z) {
+    // finalizer of splitmix64, which spreads neighbouring doubles over all buckets
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+alex_memo *alex_make_memo(alex_closure_1d f, size_t capacity, unsigned int options) {
+    if (capacity == 0 || (options & ~ALEX_MEMO_SHARED) != 0 || capacity > SIZE_MAX / 2 / sizeof(_memo_bucket)) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+
+    size_t nbuckets = 1;
+    while (nbuckets * ALEX_MEMO_WAYS < capacity) {
+        nbuckets *= 2;
+    }
+    size_t nstripes = 1;
+    if (options & ALEX_MEMO_SHARED) {
+        while (nstripes < ALEX_MEMO_STRIPES && nstripes < nbuckets) {
+            nstripes *= 2;
+        }
+    }
+
+    alex_memo *memo = malloc(sizeof(alex_memo) + _MEMO_LINE + nstripes * sizeof(_memo_padded_stripe));
+    _memo_bucket *buckets = malloc(nbuckets * sizeof(_memo_bucket));
+    if (memo == NULL || buckets == NULL) {
+        free(memo);
+        free(buckets);
+        alex_set_flag(ALEX_BAD_ALLOC_FLAG);
+        return NULL;
+    }
+    uintptr_t start = (uintptr_t) (memo + 1);
+    _memo_padded_stripe *stripes = (_memo_padded_stripe *) ((start + _MEMO_LINE - 1) & ~(uintptr_t) (_MEMO_LINE - 1));
+
+    memo->f = f;
+    memo->shared = (options & ALEX_MEMO_SHARED) != 0;
+    memo->mask = nbuckets - 1;
+    memo->stripe_mask = nstripes - 1;
+    memo->buckets = buckets;
+    memo->stripes = stripes;
+    for (size_t s = 0; s < nstripes; ++s) {
+        pthread_mutex_init(&stripes[s].stripe.lock, NULL);
+    }
+    alex_memo_clear(memo); // sets the flag to ALEX_OK_FLAG
+    return memo;
+}
+
+void alex_free_memo(alex_memo *memo) {
+    if (memo == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return;
+    }
+
+    for (size_t s = 0; s <= memo->stripe_mask; ++s) {
+        pthread_mutex_destroy(&memo->stripes[s].stripe.lock);
+    }
+    free(memo->buckets);
+    free(memo); // the stripes are part of the same block
+    alex_set_flag(ALEX_OK_FLAG);
+}
+
+// looks key up in the bucket, storing the value in *value on a hit
+static inline int _memo_find(const _memo_bucket *bucket, uint64_t key, double *value) {
+    for (unsigned int i = 0; i < bucket->used; ++i) {
+        if (bucket->keys[i] == key) {
+            *value = bucket->values[i];
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static inline void _memo_insert(_memo_bucket *bucket, _memo_stripe *stripe, uint64_t key, double value) {
+    unsigned int slot;
+    if (bucket->used < ALEX_MEMO_WAYS) {
+        slot = bucket->used++;
+    }
+    else {
+        slot = bucket->next;
+        bucket->next = (bucket->next + 1) % ALEX_MEMO_WAYS;
+        ++stripe->evictions;
+    }
+    bucket->keys[slot] = key;
+    bucket->values[slot] = value;
+}
+
+double alex_memo_eval(alex_memo *memo, double x) {
+    uint64_t key;
+    memcpy(&key, &x, sizeof(key));
+    size_t b = (size_t) _memo_hash(key) & memo->mask;
+    _memo_bucket *bucket = memo->buckets + b;
+    _memo_stripe *stripe = &memo->stripes[b & memo->stripe_mask].stripe;
+
+    double y;
+    if (!memo->shared) {
+        if (_memo_find(bucket, key, &y)) {
+            ++stripe->hits;
+            return y;
+        }
+        ++stripe->misses;
+        y = alex_closure_eval(memo->f, x);
+        _memo_insert(bucket, stripe, key, y);
+        return y;
+    }
+
+    pthread_mutex_lock(&stripe->lock);
+    int hit = _memo_find(bucket, key, &y);
+    if (hit) {
+        ++stripe->hits;
+    }
+    else {
+        ++stripe->misses;
+    }
+    pthread_mutex_unlock(&stripe->lock);
+    if (hit) {
+        return y;
+    }
+
+    // evaluated without holding the lock, another thread may have inserted x in the meantime
+    y = alex_closure_eval(memo->f, x);
+    double cached;
+    pthread_mutex_lock(&stripe->lock);
+    if (!_memo_find(bucket, key, &cached)) {
+        _memo_insert(bucket, stripe, key, y);
+    }
+    pthread_mutex_unlock(&stripe->lock);
+    return y;
+}
+
+static double _memo_func(double x, void *ctx) {
+    return alex_memo_eval(ctx, x);
+}
+
+static void _memo_vfunc(const double *x, double *y, size_t n, void *ctx) {
+    for (size_t i = 0; i < n; ++i) {
+        y[i] = alex_memo_eval(ctx, x[i]);
+    }
+}
+
+alex_closure_1d alex_memo_closure(alex_memo *memo) {
+    return alex_make_closure(&_memo_func, memo);
+}
+
+alex_vclosure_1d alex_memo_vclosure(alex_memo *memo) {
+    return alex_make_vclosure(&_memo_vfunc, memo);
+}
+
+alex_memo_stats alex_memo_get_stats(alex_memo *memo) {
+    alex_memo_stats stats = {0, 0, 0, 0};
+    if (memo == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return stats;
+    }
+
+    for (size_t s = 0; s <= memo->stripe_mask; ++s) {
+        _memo_stripe *stripe = &memo->stripes[s].stripe;
+        if (memo->shared)
+            pthread_mutex_lock(&stripe->lock);
+        stats.hits += stripe->hits;
+        stats.misses += stripe->misses;
+        stats.evictions += stripe->evictions;
+        if (memo->shared)
+            pthread_mutex_unlock(&stripe->lock);
+    }
+    stats.capacity = (memo->mask + 1) * ALEX_MEMO_WAYS;
+
+    alex_set_flag(ALEX_OK_FLAG);
+    return stats;
+}
+
+void alex_memo_clear(alex_memo *memo) {
+    if (memo == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return;
+    }
+
+    for (size_t b = 0; b <= memo->mask; ++b) {
+        memo->buckets[b].used = 0;
+        memo->buckets[b].next = 0;
+    }
+    for (size_t s = 0; s <= memo->stripe_mask; ++s) {
+        memo->stripes[s].stripe.hits = 0;
+        memo->stripes[s].stripe.misses = 0;
+        memo->stripes[s].stripe.evictions = 0;
+    }
+    alex_set_flag(ALEX_OK_FLAG);
+}
@@ -0,0 +1,488 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "../include/optimize.h"
+#include "../include/poly.h"
+#include "../include/flags.h"
+#include "../include/stats.h"
+#include "../include/integrate.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static void _set_info(alex_root_info *info, double abserr, unsigned long nevals, unsigned int iterations) {
+    if (info != NULL) {
+        info->abserr = abserr;
+        info->nevals = nevals;
+        info->iterations = iterations;
+    }
+}
+
+int alex_root_brent_r(alex_closure_1d f, alex_range *range, double tol, unsigned int maxiter,
+        alex_root_info *info, double *res) {
+    ALEX_STATS_SCOPE(ALEX_STATS_ROOT);
+    ALEX_STATS_COUNT(f);
+    if (!(tol >= 0)) {
+        *res = 0.;
+        _set_info(info, 0., 0, 0);
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    double a = range->min, b = range->max;
+    double fa = alex_closure_eval(f, a), fb = alex_closure_eval(f, b);
+    unsigned long nevals = 2;
+
+    if ((fa > 0 && fb > 0) || (fa < 0 && fb < 0)) {
+        *res = 0.;
+        _set_info(info, fabs(b - a), nevals, 0);
+        return ALEX_ROOT_BRACKET_FLAG;
+    }
+
+    /*
+     * b is the current best approximation and [b, c] the bracket, a is the previous
+     * approximation and d, e are the last two steps.
+     */
+    double c = b, fc = fb, d = b - a, e = d;
+    for (unsigned int i = 0; i < maxiter; ++i) {
+        if ((fb > 0 && fc > 0) || (fb < 0 && fc < 0)) {
+            c = a;
+            fc = fa;
+            d = e = b - a;
+        }
+        if (fabs(fc) < fabs(fb)) {
+            a = b;
+            b = c;
+            c = a;
+            fa = fb;
+            fb = fc;
+            fc = fa;
+        }
+
+        double tol1 = 2 * DBL_EPSILON * fabs(b) + tol / 2, xm = (c - b) / 2;
+        if (fabs(xm) <= tol1 || fb == 0) {
+            *res = b;
+            _set_info(info, fabs(c - b), nevals, i);
+            return ALEX_OK_FLAG;
+        }
+
+        if (fabs(e) >= tol1 && fabs(fa) > fabs(fb)) {
+            // try inverse quadratic interpolation, or the secant step if only two points are distinct
+            double p, q, s = fb / fa;
+            if (a == c) {
+                p = 2 * xm * s;
+                q = 1 - s;
+            }
+            else {
+                double r = fb / fc;
+                q = fa / fc;
+                p = s * (2 * xm * q * (q - r) - (b - a) * (r - 1));
+                q = (q - 1) * (r - 1) * (s - 1);
+            }
+            if (p > 0) {
+                q = -q;
+            }
+            p = fabs(p);
+
+            // accept the interpolation only if it stays within the bracket and converges fast enough
+            if (2 * p < fmin(3 * xm * q - fabs(tol1 * q), fabs(e * q))) {
+                e = d;
+                d = p / q;
+            }
+            else {
+                d = e = xm;
+            }
+        }
+        else {
+            d = e = xm;
+        }
+
+        a = b;
+        fa = fb;
+        b += fabs(d) > tol1 ? d : copysign(tol1, xm);
+        fb = alex_closure_eval(f, b);
+        ++nevals;
+    }
+
+    *res = b;
+    _set_info(info, fabs(c - b), nevals, maxiter);
+    return ALEX_ROOT_MAXITER_FLAG;
+}
+
+double alex_root_brent(alex_func_1d f, alex_range *range, double tol, alex_root_info *info) {
+    double res;
+    alex_set_flag(alex_root_brent_r(alex_func_closure(&f), range, tol, ALEX_DEFAULT_ROOT_MAXITER, info, &res));
+    return res;
+}
+
+int alex_root_newton_r(alex_closure_1d f, alex_closure_1d df, double x0, double tol, unsigned int maxiter,
+        alex_root_info *info, double *res) {
+    ALEX_STATS_SCOPE(ALEX_STATS_ROOT);
+    ALEX_STATS_COUNT(f);
+    ALEX_STATS_COUNT(df);
+    if (!(tol >= 0)) {
+        *res = 0.;
+        _set_info(info, 0., 0, 0);
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    double x = x0, step = HUGE_VAL;
+    unsigned long nevals = 0;
+    for (unsigned int i = 0; i < maxiter; ++i) {
+        double fx = alex_closure_eval(f, x);
+        ++nevals;
+        if (fx == 0) {
+            *res = x;
+            _set_info(info, 0., nevals, i);
+            return ALEX_OK_FLAG;
+        }
+
+        double dfx = alex_closure_eval(df, x);
+        ++nevals;
+        if (dfx == 0) {
+            *res = x;
+            _set_info(info, fabs(step), nevals, i);
+            return ALEX_ROOT_DERIV_FLAG;
+        }
+
+        step = fx / dfx;
+        x -= step;
+        if (fabs(step) <= tol * fmax(fabs(x), 1.)) {
+            *res = x;
+            _set_info(info, fabs(step), nevals, i + 1);
+            return ALEX_OK_FLAG;
+        }
+    }
+
+    *res = x;
+    _set_info(info, fabs(step), nevals, maxiter);
+    return ALEX_ROOT_MAXITER_FLAG;
+}
+
+double alex_root_newton(alex_func_1d f, alex_func_1d df, double x0, double tol, alex_root_info *info) {
+    double res;
+    alex_set_flag(alex_root_newton_r(alex_func_closure(&f), alex_func_closure(&df), x0, tol,
+            ALEX_DEFAULT_ROOT_MAXITER, info, &res));
+    return res;
+}
+
+// evaluates the polynomial passed as ctx without accessing the flag
+static double _poly_eval_ctx(double x, void *ctx) {
+    double res;
+    alex_poly_eval_r(ctx, x, &res);
+    return res;
+}
+
+int alex_poly_newton_r(alex_poly *poly, alex_poly *deriv, double x0, double tol, unsigned int maxiter,
+        alex_root_info *info, double *res) {
+    ALEX_STATS_SCOPE(ALEX_STATS_ROOT);
+    if (poly == NULL || deriv == NULL) {
+        *res = 0.;
+        _set_info(info, 0., 0, 0);
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    alex_closure_1d f = alex_make_closure(&_poly_eval_ctx, poly), df = alex_make_closure(&_poly_eval_ctx, deriv);
+    ALEX_STATS_COUNT(f);
+    ALEX_STATS_COUNT(df);
+    return alex_root_newton_r(f, df, x0, tol, maxiter, info, res);
+}
+
+double alex_poly_newton(alex_poly *poly, double x0, double tol, alex_root_info *info) {
+    if (poly == NULL) {
+        _set_info(info, 0., 0, 0);
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return 0.;
+    }
+
+    alex_poly *deriv = alex_poly_diff(poly); // flags set by alex_poly_diff()
+    if (deriv == NULL) {
+        _set_info(info, 0., 0, 0);
+        return 0.;
+    }
+
+    double res;
+    int flag = alex_poly_newton_r(poly, deriv, x0, tol, ALEX_DEFAULT_ROOT_MAXITER, info, &res);
+    alex_free_poly(deriv);
+    alex_set_flag(flag);
+    return res;
+}
+
+/*
+ * Workspace of the Aberth iteration: the corrections of the current sweep and the converged
+ * state of every root. Degrees up to ALEX_ROOTS_STACK_DEG use the stack buffers.
+ */
+typedef struct {
+    double *wre, *wim;
+    unsigned char *done;
+    double stack_wre[ALEX_ROOTS_STACK_DEG], stack_wim[ALEX_ROOTS_STACK_DEG];
+    unsigned char stack_done[ALEX_ROOTS_STACK_DEG];
+} _aberth_ws;
+
+static int _aberth_ws_init(_aberth_ws *ws, unsigned int n) {
+    if (n <= ALEX_ROOTS_STACK_DEG) {
+        ws->wre = ws->stack_wre;
+        ws->wim = ws->stack_wim;
+        ws->done = ws->stack_done;
+        return ALEX_OK_FLAG;
+    }
+
+    ws->wre = malloc(n * (2 * sizeof(double) + 1));
+    if (ws->wre == NULL) {
+        return ALEX_BAD_ALLOC_FLAG;
+    }
+    ws->wim = ws->wre + n;
+    ws->done = (unsigned char *) (ws->wim + n);
+    return ALEX_OK_FLAG;
+}
+
+static void _aberth_ws_free(_aberth_ws *ws) {
+    if (ws->wre != ws->stack_wre) {
+        free(ws->wre);
+    }
+}
+
+/*
+ * Finds all roots of c[0] + c[1] x + ... + c[n] x^n, c[n] != 0, n >= 1. The estimates are
+ * updated Jacobi-style: every sweep computes all corrections from the same estimates before
+ * applying them, so the loops over the estimates carry no dependencies and vectorize.
+ */
+static int _aberth(const double *c, unsigned int n, double *re, double *im, unsigned int maxiter,
+        _aberth_ws *ws, alex_root_info *info) {
+    // roots at 0 are split off exactly, the iteration would only converge linearly towards them
+    while (n > 0 && c[0] == 0) {
+        re[n - 1] = im[n - 1] = 0.;
+        ++c;
+        --n;
+    }
+    if (n == 0) {
+        _set_info(info, 0., 0, 0);
+        return ALEX_OK_FLAG;
+    }
+
+    // start on a circle whose radius is the geometric mean of the root moduli
+    double radius = c[0] != 0 ? pow(fabs(c[0] / c[n]), 1. / n) : 1.;
+    for (unsigned int i = 0; i < n; ++i) {
+        double angle = 2 * M_PI * i / n + 0.4;
+        re[i] = radius * cos(angle);
+        im[i] = radius * sin(angle);
+        ws->done[i] = 0;
+    }
+
+    unsigned long nevals = 0;
+    unsigned int remaining = n;
+    double maxcorr = 0.;
+    for (unsigned int iter = 0; iter < maxiter; ++iter) {
+        maxcorr = 0.;
+        for (unsigned int i = 0; i < n; ++i) {
+            ws->wre[i] = ws->wim[i] = 0.;
+            if (ws->done[i]) {
+                continue;
+            }
+
+            // p(z), p'(z) and the rounding error bound of p(z), all by Horner's scheme
+            double zr = re[i], zi = im[i], r = hypot(zr, zi);
+            double pr = c[n], pi = 0., dr = 0., di = 0., bound = fabs(c[n]);
+            for (unsigned int k = n; k-- > 0;) {
+                double t = dr * zr - di * zi + pr;
+                di = dr * zi + di * zr + pi;
+                dr = t;
+                t = pr * zr - pi * zi + c[k];
+                pi = pr * zi + pi * zr;
+                pr = t;
+                bound = bound * r + fabs(c[k]);
+            }
+            nevals += 2;
+
+            // the estimate cannot be improved any further once |p(z)| is within rounding error
+            if (hypot(pr, pi) <= 4 * DBL_EPSILON * bound) {
+                ws->done[i] = 1;
+                --remaining;
+                continue;
+            }
+
+            // q = p'(z) / p(z)
+            double pp = pr * pr + pi * pi;
+            double qr = (dr * pr + di * pi) / pp, qi = (di * pr - dr * pi) / pp;
+
+            // s = sum of 1 / (z - z_j) over j != i, split such that both loops are branch-free
+            double sr = 0., si = 0.;
+            for (unsigned int j = 0; j < i; ++j) {
+                double ar = zr - re[j], ai = zi - im[j], a = ar * ar + ai * ai;
+                sr += ar / a;
+                si -= ai / a;
+            }
+            for (unsigned int j = i + 1; j < n; ++j) {
+                double ar = zr - re[j], ai = zi - im[j], a = ar * ar + ai * ai;
+                sr += ar / a;
+                si -= ai / a;
+            }
+
+            // the Aberth correction w = 1 / (q - s)
+            double br = qr - sr, bi = qi - si, b = br * br + bi * bi;
+            if (b > 0) {
+                ws->wre[i] = br / b;
+                ws->wim[i] = -bi / b;
+                maxcorr = fmax(maxcorr, sqrt(ws->wre[i] * ws->wre[i] + ws->wim[i] * ws->wim[i]));
+            }
+        }
+
+        if (remaining == 0) {
+            _set_info(info, maxcorr, nevals, iter);
+            return ALEX_OK_FLAG;
+        }
+        for (unsigned int i = 0; i < n; ++i) {
+            re[i] -= ws->wre[i];
+            im[i] -= ws->wim[i];
+        }
+    }
+
+    _set_info(info, maxcorr, nevals, maxiter);
+    return ALEX_ROOT_MAXITER_FLAG;
+}
+
+int alex_poly_roots_r(alex_poly *poly, double *re, double *im, unsigned int maxiter, alex_root_info *info) {
+    ALEX_STATS_SCOPE(ALEX_STATS_ROOT);
+    if (poly == NULL || poly->coeffs[poly->deg] == 0) {
+        _set_info(info, 0., 0, 0);
+        return ALEX_INV_PARAM_FLAG;
+    }
+    if (poly->deg == 0) {
+        _set_info(info, 0., 0, 0);
+        return ALEX_OK_FLAG;
+    }
+
+    _aberth_ws ws;
+    if (_aberth_ws_init(&ws, poly->deg) != ALEX_OK_FLAG) {
+        _set_info(info, 0., 0, 0);
+        return ALEX_BAD_ALLOC_FLAG;
+    }
+    int flag = _aberth(poly->coeffs, poly->deg, re, im, maxiter, &ws, info);
+    _aberth_ws_free(&ws);
+    return flag;
+}
+
+unsigned int alex_poly_roots(alex_poly *poly, double *re, double *im, alex_root_info *info) {
+    int flag = alex_poly_roots_r(poly, re, im, ALEX_DEFAULT_ROOT_MAXITER, info);
+    alex_set_flag(flag);
+    return flag == ALEX_INV_PARAM_FLAG || flag == ALEX_BAD_ALLOC_FLAG ? 0 : poly->deg;
+}
+
+typedef struct {
+    unsigned int deg;
+    const double *coeffs;
+    size_t count, per_chunk;
+    double *re, *im;
+    unsigned int maxiter;
+    alex_root_info *infos;
+    int *flags;
+} _roots_many_job;
+
+// the flags in order of precedence when combining the outcomes of several polynomials
+static int _roots_flag_rank(int flag) {
+    switch (flag) {
+        case ALEX_OK_FLAG: return 0;
+        case ALEX_ROOT_MAXITER_FLAG: return 1;
+        case ALEX_INV_PARAM_FLAG: return 2;
+        default: return 3;
+    }
+}
+
+static void _roots_many_chunk(size_t k, void *ctx) {
+    _roots_many_job *job = ctx;
+    size_t first = k * job->per_chunk;
+    size_t last = first + job->per_chunk < job->count ? first + job->per_chunk : job->count;
+    unsigned int n = job->deg;
+    alex_root_info total = {0., 0, 0}, info;
+    int flag = ALEX_OK_FLAG;
+
+    _aberth_ws ws;
+    if (_aberth_ws_init(&ws, n) != ALEX_OK_FLAG) {
+        job->infos[k] = total;
+        job->flags[k] = ALEX_BAD_ALLOC_FLAG;
+        return;
+    }
+
+    for (size_t i = first; i < last; ++i) {
+        const double *c = job->coeffs + i * (n + 1);
+        int res;
+        if (c[n] == 0) {
+            // leave the roots of this polynomial undefined, but carry on with the others
+            for (unsigned int j = 0; j < n; ++j) {
+                job->re[i * n + j] = job->im[i * n + j] = NAN;
+            }
+            res = ALEX_INV_PARAM_FLAG;
+        }
+        else {
+            res = _aberth(c, n, job->re + i * n, job->im + i * n, job->maxiter, &ws, &info);
+            total.abserr = fmax(total.abserr, info.abserr);
+            total.nevals += info.nevals;
+            total.iterations = info.iterations > total.iterations ? info.iterations : total.iterations;
+        }
+        if (_roots_flag_rank(res) > _roots_flag_rank(flag)) {
+            flag = res;
+        }
+    }
+
+    _aberth_ws_free(&ws);
+    job->infos[k] = total;
+    job->flags[k] = flag;
+}
+
+int alex_poly_roots_many(unsigned int deg, const double *coeffs, size_t count, double *re, double *im,
+        unsigned int maxiter, const alex_integ_ctx *ctx, alex_root_info *info) {
+    ALEX_STATS_SCOPE(ALEX_STATS_ROOT);
+    _set_info(info, 0., 0, 0);
+    if (deg == 0 || count == 0) {
+        return ALEX_OK_FLAG;
+    }
+
+    size_t nchunks = (count + ALEX_ROOTS_CHUNK - 1) / ALEX_ROOTS_CHUNK;
+    if (nchunks > ALEX_ROOTS_MAX_CHUNKS) {
+        nchunks = ALEX_ROOTS_MAX_CHUNKS;
+    }
+
+    alex_root_info *infos = malloc(nchunks * (sizeof(alex_root_info) + sizeof(int)));
+    if (infos == NULL) {
+        return ALEX_BAD_ALLOC_FLAG;
+    }
+    int *flags = (int *) (infos + nchunks);
+
+    _roots_many_job job = {deg, coeffs, count, (count + nchunks - 1) / nchunks, re, im, maxiter, infos, flags};
+    alex_pool_for(ctx == NULL ? NULL : ctx->pool, ctx == NULL ? 0u : ctx->threads, nchunks,
+            &_roots_many_chunk, &job);
+
+    int flag = ALEX_OK_FLAG;
+    alex_root_info total = {0., 0, 0};
+    for (size_t k = 0; k < nchunks; ++k) {
+        total.abserr = fmax(total.abserr, infos[k].abserr);
+        total.nevals += infos[k].nevals;
+        total.iterations = infos[k].iterations > total.iterations ? infos[k].iterations : total.iterations;
+        if (_roots_flag_rank(flags[k]) > _roots_flag_rank(flag)) {
+            flag = flags[k];
+        }
+    }
+    free(infos);
+
+    _set_info(info, total.abserr, total.nevals, total.iterations);
+    return flag;
+}
@@ -17,43 +17,116 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#undef ALEX_INLINE // this file defines out-of-line functions which ALEX_INLINE replaces
+
 #include <stdlib.h>
 #include <string.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <limits.h>
 #include <math.h>
 
 #include "../include/poly.h"
+#include "../include/arena.h"
 #include "../include/utils.h"
+#include "../include/dispatch.h"
 #include "../include/flags.h"
+#include "../include/stats.h"
+
+#if defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define ALEX_POLY_SSE2
+#if defined(__GNUC__)
+#define ALEX_POLY_AVX2
+#define ALEX_POLY_AVX512
+#endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define ALEX_POLY_NEON
+#endif
+
+/*
+ * The kernels must round every product and every sum, as such no multiplication and addition may be
+ * contracted into a fused multiply-add, whatever -ffp-contract or -march the library is built with.
+ */
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
 
-#define ALEX_POLY_PRINT_BUFSIZE 100
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
 
 static alex_poly *pub_poly;
 
-alex_poly *alex_make_poly(unsigned int deg, double coeffs[]) {
-    alex_poly *poly = malloc(sizeof(alex_poly));
+/*
+ * A poly and its coefficients live in a single block: the struct comes first, padded to the
+ * alignment of double, and is immediately followed by the deg + 1 coefficients.
+ */
+#define _POLY_HEADER_SIZE (((sizeof(alex_poly) + sizeof(double) - 1) / sizeof(double)) * sizeof(double))
+#define _poly_block_size(cap) (_POLY_HEADER_SIZE + (size_t) (cap) * sizeof(double))
+
+/*
+ * Allocates an uninitialized poly of degree deg with room for cap >= deg + 1 coefficients,
+ * from the arena if there is one and from the heap otherwise. Sets the flag on failure only.
+ */
+static alex_poly *_poly_alloc(unsigned int deg, unsigned int cap, alex_arena *arena) {
+    alex_poly *poly = arena == NULL ? malloc(_poly_block_size(cap)) : alex_arena_alloc(arena, _poly_block_size(cap));
     if (poly == NULL) {
         alex_set_flag(ALEX_BAD_ALLOC_FLAG);
         return NULL;
     }
+    ALEX_STATS_ALLOC(_poly_block_size(cap));
 
     poly->deg = deg;
-    poly->coeffs = calloc(deg + 1, sizeof(double));
+    poly->cap = cap;
+    poly->coeffs = (double *) ((char *) poly + _POLY_HEADER_SIZE);
+    return poly;
+}
 
-    if (poly->coeffs == NULL) {
-        alex_set_flag(ALEX_BAD_ALLOC_FLAG);
-        return NULL;
+static alex_poly *_poly_make(unsigned int deg, unsigned int cap, double coeffs[], alex_arena *arena) {
+    alex_poly *poly = _poly_alloc(deg, cap, arena);
+    if (poly == NULL) {
+        return NULL; // flag already set by _poly_alloc()
     }
 
-    for (int i = 0; i <= deg; ++i) {
-        poly->coeffs[i] = coeffs[i];
+    if (coeffs == NULL) {
+        alex_mclear(poly->coeffs, (size_t) cap * sizeof(double));
+    }
+    else {
+        memcpy(poly->coeffs, coeffs, ((size_t) deg + 1) * sizeof(double));
+        alex_mclear(poly->coeffs + deg + 1, (size_t) (cap - deg - 1) * sizeof(double));
     }
 
     alex_set_flag(ALEX_OK_FLAG);
     return poly;
 }
 
+alex_poly *alex_make_poly(unsigned int deg, double coeffs[]) {
+    return _poly_make(deg, deg + 1, coeffs, NULL); // flags set by _poly_make()
+}
+
+alex_poly *alex_make_poly_cap(unsigned int deg, double coeffs[], unsigned int cap) {
+    if (cap < deg + 1) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+
+    return _poly_make(deg, cap, coeffs, NULL); // flags set by _poly_make()
+}
+
+alex_poly *alex_make_poly_arena(unsigned int deg, double coeffs[], alex_arena *arena) {
+    if (arena == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+
+    return _poly_make(deg, deg + 1, coeffs, arena); // flags set by _poly_make()
+}
+
 void alex_free_poly(alex_poly *poly) {
     if (poly == NULL) {
         alex_set_flag(ALEX_INV_PARAM_FLAG);
@@ -62,8 +135,7 @@ void alex_free_poly(alex_poly *poly) {
     else if (poly == pub_poly)
         pub_poly = NULL;
 
-    free(poly->coeffs);
-    free(poly);
+    free(poly); // the coefficients are part of the same block
     alex_set_flag(ALEX_OK_FLAG);
 }
 
@@ -72,14 +144,152 @@ char *alex_poly_print(alex_poly *poly, char *dest) {
 }
 
 char *alex_poly_printf(alex_poly *poly, char *dest, const char *format) {
+    char *end = dest + strlen(dest); // the terms are written one after the other from here
     for (unsigned int i = 0; i <= poly->deg; ++i) {
-        strcat(dest, poly->coeffs[i] < 0 ? "- " : "+ ");
-        sprintf(dest + strlen(dest), format, fabs(poly->coeffs[i]));
-        sprintf(dest + strlen(dest), "x^%u ", i);
+        *end++ = poly->coeffs[i] < 0 ? '-' : '+';
+        *end++ = ' ';
+        int n = sprintf(end, format, fabs(poly->coeffs[i]));
+        if (n < 0) {
+            *end = '\0';
+            break;
+        }
+        end += n;
+        end += sprintf(end, "x^%u ", i);
     }
     return dest;
 }
 
+size_t alex_poly_snprintf(alex_poly *poly, char *dest, size_t size, const char *format) {
+    if (poly == NULL || format == NULL || (dest == NULL && size != 0)) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return 0;
+    }
+
+    // each piece is written where the previous one ended, or only measured once the buffer is full
+    size_t len = 0;
+    for (unsigned int i = 0; i <= poly->deg; ++i) {
+        for (int piece = 0; piece < 3; ++piece) {
+            char *at = len < size ? dest + len : NULL;
+            size_t left = len < size ? size - len : 0;
+            int n = piece == 0 ? snprintf(at, left, "%s", poly->coeffs[i] < 0 ? "- " : "+ ")
+                    : piece == 1 ? snprintf(at, left, format, fabs(poly->coeffs[i]))
+                    : snprintf(at, left, "x^%u ", i);
+            if (n < 0) {
+                if (size != 0) {
+                    dest[0] = '\0';
+                }
+                alex_set_flag(ALEX_INV_PARAM_FLAG);
+                return 0;
+            }
+            len += (size_t) n;
+        }
+    }
+
+    alex_set_flag(len < size ? ALEX_OK_FLAG : ALEX_BUF_SIZE_FLAG);
+    return len;
+}
+
+/*
+ * A serialized poly is the signature, the degree as uint32_t and the coefficients, see
+ * alex_poly_serialize(). Reading a record never parses more than its header.
+ */
+static const char _poly_signature[4] = {'A', 'L', 'X', 'P'};
+
+size_t alex_poly_serial_size(alex_poly *poly) {
+    return poly == NULL ? 0 : ALEX_POLY_SERIAL_HEADER + ((size_t) poly->deg + 1) * sizeof(double);
+}
+
+size_t alex_poly_serialize(alex_poly *poly, void *dest, size_t size) {
+    if (poly == NULL || (dest == NULL && size != 0)) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return 0;
+    }
+
+    size_t need = alex_poly_serial_size(poly);
+    if (size < need) {
+        alex_set_flag(ALEX_BUF_SIZE_FLAG);
+        return need;
+    }
+
+    uint32_t deg = poly->deg;
+    memcpy(dest, _poly_signature, sizeof(_poly_signature));
+    memcpy((char *) dest + sizeof(_poly_signature), &deg, sizeof(deg));
+    memcpy((char *) dest + ALEX_POLY_SERIAL_HEADER, poly->coeffs, need - ALEX_POLY_SERIAL_HEADER);
+
+    alex_set_flag(ALEX_OK_FLAG);
+    return need;
+}
+
+// validates the header of the record at src, whose degree is stored in *deg
+static int _poly_record(const void *src, size_t size, unsigned int *deg, size_t *used) {
+    uint32_t d;
+    if (src == NULL || size < ALEX_POLY_SERIAL_HEADER
+            || memcmp(src, _poly_signature, sizeof(_poly_signature)) != 0) {
+        return ALEX_POLY_FORMAT_FLAG;
+    }
+
+    memcpy(&d, (const char *) src + sizeof(_poly_signature), sizeof(d));
+    if (d >= UINT_MAX || (size - ALEX_POLY_SERIAL_HEADER) / sizeof(double) < (size_t) d + 1) {
+        return ALEX_POLY_FORMAT_FLAG;
+    }
+
+    *deg = d;
+    if (used != NULL) {
+        *used = ALEX_POLY_SERIAL_HEADER + ((size_t) d + 1) * sizeof(double);
+    }
+    return ALEX_OK_FLAG;
+}
+
+static alex_poly *_poly_deserialize(const void *src, size_t size, size_t *used, alex_arena *arena) {
+    unsigned int deg;
+    int flag = _poly_record(src, size, &deg, used);
+    if (flag != ALEX_OK_FLAG) {
+        alex_set_flag(flag);
+        return NULL;
+    }
+
+    alex_poly *poly = _poly_alloc(deg, deg + 1, arena);
+    if (poly == NULL) {
+        return NULL; // flag already set by _poly_alloc()
+    }
+
+    memcpy(poly->coeffs, (const char *) src + ALEX_POLY_SERIAL_HEADER, ((size_t) deg + 1) * sizeof(double));
+    alex_set_flag(ALEX_OK_FLAG);
+    return poly;
+}
+
+alex_poly *alex_poly_deserialize(const void *src, size_t size, size_t *used) {
+    return _poly_deserialize(src, size, used, NULL); // flags set by _poly_deserialize()
+}
+
+alex_poly *alex_poly_deserialize_arena(const void *src, size_t size, size_t *used, alex_arena *arena) {
+    if (arena == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+    return _poly_deserialize(src, size, used, arena); // flags set by _poly_deserialize()
+}
+
+alex_poly *alex_poly_view(const void *src, size_t size, alex_poly *view, size_t *used) {
+    if (view == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+
+    unsigned int deg;
+    int flag = (uintptr_t) src % _Alignof(double) != 0 ? ALEX_POLY_FORMAT_FLAG : _poly_record(src, size, &deg, used);
+    if (flag != ALEX_OK_FLAG) {
+        alex_set_flag(flag);
+        return NULL;
+    }
+
+    view->deg = deg;
+    view->cap = 0; // read-only, such that every _into/_inplace writer rejects it, see poly.h
+    view->coeffs = (double *) ((const char *) src + ALEX_POLY_SERIAL_HEADER);
+    alex_set_flag(ALEX_OK_FLAG);
+    return view;
+}
+
 unsigned int alex_poly_deg(alex_poly *poly) {
     if (poly == NULL) {
         alex_set_flag(ALEX_INV_PARAM_FLAG);
@@ -100,91 +310,327 @@ double alex_poly_coeff(alex_poly *poly, unsigned int index) {
     return poly->coeffs[index];
 }
 
-double alex_poly_eval(alex_poly *poly, double x) {
-    double res = 0;
+/*
+ * Horner's scheme for a single point. The vector kernels below apply exactly the
+ * same sequence of multiplications and additions to each lane (no fused multiply-add),
+ * so that alex_poly_eval() and alex_poly_eval_many() yield identical results.
+ */
+static double _poly_horner(const double *coeffs, unsigned int deg, double x) {
+    double res = coeffs[deg];
+    for (unsigned int i = deg; i-- > 0;) {
+        res = res * x + coeffs[i];
+    }
+    return res;
+}
 
-    for (int i = 0; i < poly->deg + 1; ++i) {
-        res += poly->coeffs[i] * pow(x, i);
+typedef void (*_poly_eval_kernel)(const double *coeffs, unsigned int deg,
+        const double *xs, double *out, size_t n);
+
+static void _poly_eval_many_scalar(const double *coeffs, unsigned int deg,
+        const double *xs, double *out, size_t n) {
+    for (size_t j = 0; j < n; ++j) {
+        out[j] = _poly_horner(coeffs, deg, xs[j]);
     }
+}
 
-    alex_set_flag(ALEX_OK_FLAG);
-    return res;
+#if defined(ALEX_POLY_SSE2)
+static void _poly_eval_many_sse2(const double *coeffs, unsigned int deg,
+        const double *xs, double *out, size_t n) {
+    size_t j = 0;
+    for (; j + 4 <= n; j += 4) {
+        __m128d x0 = _mm_loadu_pd(xs + j), x1 = _mm_loadu_pd(xs + j + 2);
+        __m128d r0 = _mm_set1_pd(coeffs[deg]), r1 = r0;
+        for (unsigned int i = deg; i-- > 0;) {
+            __m128d c = _mm_set1_pd(coeffs[i]);
+            r0 = _mm_add_pd(_mm_mul_pd(r0, x0), c);
+            r1 = _mm_add_pd(_mm_mul_pd(r1, x1), c);
+        }
+        _mm_storeu_pd(out + j, r0);
+        _mm_storeu_pd(out + j + 2, r1);
+    }
+    _poly_eval_many_scalar(coeffs, deg, xs + j, out + j, n - j);
 }
+#endif
 
-alex_poly *alex_poly_diff(alex_poly *poly) {
-    if (poly->deg == 0) {
-        double *coeffs = malloc(sizeof(double));
-        if (coeffs == NULL) {
-            alex_set_flag(ALEX_BAD_ALLOC_FLAG);
-            return NULL;
+#if defined(ALEX_POLY_AVX2)
+__attribute__((target("avx2")))
+static void _poly_eval_many_avx2(const double *coeffs, unsigned int deg,
+        const double *xs, double *out, size_t n) {
+    size_t j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m256d x0 = _mm256_loadu_pd(xs + j), x1 = _mm256_loadu_pd(xs + j + 4);
+        __m256d r0 = _mm256_set1_pd(coeffs[deg]), r1 = r0;
+        for (unsigned int i = deg; i-- > 0;) {
+            __m256d c = _mm256_set1_pd(coeffs[i]);
+            r0 = _mm256_add_pd(_mm256_mul_pd(r0, x0), c);
+            r1 = _mm256_add_pd(_mm256_mul_pd(r1, x1), c);
         }
-        *coeffs = 0.;
-        return alex_make_poly(0u, coeffs);
+        _mm256_storeu_pd(out + j, r0);
+        _mm256_storeu_pd(out + j + 4, r1);
     }
+    _poly_eval_many_scalar(coeffs, deg, xs + j, out + j, n - j);
+}
+#endif
 
-    double *coeffs = calloc(poly->deg, sizeof(double));
-    if (coeffs == NULL) {
-        alex_set_flag(ALEX_BAD_ALLOC_FLAG);
-        return NULL;
+#if defined(ALEX_POLY_AVX512)
+/*
+ * AVX-512F implies FMA, which GCC would otherwise contract _mm512_mul_pd() and _mm512_add_pd()
+ * into. The rounding variants are not contracted.
+ */
+#define _horner512(r, x, c) _mm512_add_round_pd(_mm512_mul_round_pd(r, x, _MM_FROUND_CUR_DIRECTION), c, \
+        _MM_FROUND_CUR_DIRECTION)
+
+__attribute__((target("avx512f")))
+static void _poly_eval_many_avx512(const double *coeffs, unsigned int deg,
+        const double *xs, double *out, size_t n) {
+    size_t j = 0;
+    for (; j + 16 <= n; j += 16) {
+        __m512d x0 = _mm512_loadu_pd(xs + j), x1 = _mm512_loadu_pd(xs + j + 8);
+        __m512d r0 = _mm512_set1_pd(coeffs[deg]), r1 = r0;
+        for (unsigned int i = deg; i-- > 0;) {
+            __m512d c = _mm512_set1_pd(coeffs[i]);
+            r0 = _horner512(r0, x0, c);
+            r1 = _horner512(r1, x1, c);
+        }
+        _mm512_storeu_pd(out + j, r0);
+        _mm512_storeu_pd(out + j + 8, r1);
+    }
+    // masked tail, a scalar one would be contracted as well
+    for (; j < n; j += 8) {
+        __mmask8 m = n - j >= 8 ? (__mmask8) 0xff : (__mmask8) ((1u << (n - j)) - 1);
+        __m512d x0 = _mm512_maskz_loadu_pd(m, xs + j), r0 = _mm512_set1_pd(coeffs[deg]);
+        for (unsigned int i = deg; i-- > 0;) {
+            r0 = _horner512(r0, x0, _mm512_set1_pd(coeffs[i]));
+        }
+        _mm512_mask_storeu_pd(out + j, m, r0);
     }
+}
+#endif
 
-    for (int i = 0; i <= poly->deg - 1; ++i) {
-        coeffs[i] = poly->coeffs[i + 1] * ((double) i + 1);
+#if defined(ALEX_POLY_NEON)
+static void _poly_eval_many_neon(const double *coeffs, unsigned int deg,
+        const double *xs, double *out, size_t n) {
+    size_t j = 0;
+    for (; j + 4 <= n; j += 4) {
+        float64x2_t x0 = vld1q_f64(xs + j), x1 = vld1q_f64(xs + j + 2);
+        float64x2_t r0 = vdupq_n_f64(coeffs[deg]), r1 = r0;
+        for (unsigned int i = deg; i-- > 0;) {
+            float64x2_t c = vdupq_n_f64(coeffs[i]);
+            r0 = vaddq_f64(vmulq_f64(r0, x0), c);
+            r1 = vaddq_f64(vmulq_f64(r1, x1), c);
+        }
+        vst1q_f64(out + j, r0);
+        vst1q_f64(out + j + 2, r1);
     }
+    _poly_eval_many_scalar(coeffs, deg, xs + j, out + j, n - j);
+}
+#endif
 
-    alex_poly *diff = alex_make_poly(poly->deg - 1, coeffs);
-    if (diff == NULL) {
-        return NULL; // flag already set by alex_make_poly()
+/*
+ * The kernels indexed by instruction set (see dispatch.h), NULL where none is compiled in.
+ * alex_set_isa() only accepts instruction sets the CPU supports.
+ */
+static const _poly_eval_kernel _poly_kernels[ALEX_ISA_COUNT] = {
+    [ALEX_ISA_SCALAR] = &_poly_eval_many_scalar,
+#if defined(ALEX_POLY_SSE2)
+    [ALEX_ISA_SSE2] = &_poly_eval_many_sse2,
+#endif
+#if defined(ALEX_POLY_AVX2)
+    [ALEX_ISA_AVX2] = &_poly_eval_many_avx2,
+#endif
+#if defined(ALEX_POLY_AVX512)
+    [ALEX_ISA_AVX512] = &_poly_eval_many_avx512,
+#endif
+#if defined(ALEX_POLY_NEON)
+    [ALEX_ISA_NEON] = &_poly_eval_many_neon,
+#endif
+};
+
+static _poly_eval_kernel _poly_select_kernel(void) {
+    return _poly_kernels[alex_get_isa()];
+}
+
+int alex_poly_eval_r(alex_poly *poly, double x, double *res) {
+    if (poly == NULL) {
+        *res = 0.;
+        return ALEX_INV_PARAM_FLAG;
     }
 
-    alex_set_flag(ALEX_OK_FLAG);
-    return diff;
+    *res = _poly_horner(poly->coeffs, poly->deg, x);
+    return ALEX_OK_FLAG;
 }
 
-alex_poly *alex_poly_integ(alex_poly *poly, double c) {
+double alex_poly_eval(alex_poly *poly, double x) {
+    double res;
+    alex_set_flag(alex_poly_eval_r(poly, x, &res));
+    return res;
+}
+
+int alex_poly_eval_many_r(alex_poly *poly, const double *xs, double *out, size_t n) {
+    ALEX_STATS_SCOPE(ALEX_STATS_POLY);
+    ALEX_STATS_EVALS(n);
+    if (poly == NULL || (n > 0 && (xs == NULL || out == NULL))) {
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    _poly_select_kernel()(poly->coeffs, poly->deg, xs, out, n);
+    return ALEX_OK_FLAG;
+}
+
+void alex_poly_eval_many(alex_poly *poly, const double *xs, double *out, size_t n) {
+    alex_set_flag(alex_poly_eval_many_r(poly, xs, out, n));
+}
+
+/*
+ * The derivative and antiderivative are written straight into the coefficients of the
+ * destination poly, no temporary buffer is involved. Both helpers work in-place (dst == src):
+ * differentiation moves coefficients downwards and runs in ascending order, integration moves
+ * them upwards and runs in descending order.
+ */
+static void _poly_diff_coeffs(alex_poly *dst, alex_poly *src) {
+    unsigned int deg = src->deg;
+    if (deg == 0) {
+        dst->coeffs[0] = 0.;
+    }
+    for (unsigned int i = 0; i < deg; ++i) {
+        dst->coeffs[i] = src->coeffs[i + 1] * ((double) i + 1);
+    }
+    dst->deg = deg == 0 ? 0u : deg - 1;
+}
+
+static void _poly_integ_coeffs(alex_poly *dst, alex_poly *src, double c) {
+    unsigned int deg = src->deg;
+    for (unsigned int i = deg + 1; i-- > 0;) {
+        dst->coeffs[i + 1] = src->coeffs[i] / ((double) (i + 1));
+    }
+    dst->coeffs[0] = c;
+    dst->deg = deg + 1;
+}
+
+static alex_poly *_poly_diff(alex_poly *poly, alex_arena *arena) {
     if (poly == NULL) {
         alex_set_flag(ALEX_INV_PARAM_FLAG);
         return NULL;
     }
 
-    double *coeffs = calloc(poly->deg + 2, sizeof(double));
-    if (coeffs == NULL) {
-        alex_set_flag(ALEX_BAD_ALLOC_FLAG);
+    unsigned int deg = poly->deg == 0 ? 0u : poly->deg - 1;
+    alex_poly *diff = _poly_alloc(deg, deg + 1, arena);
+    if (diff == NULL) {
+        return NULL; // flag already set by _poly_alloc()
+    }
+
+    _poly_diff_coeffs(diff, poly);
+    alex_set_flag(ALEX_OK_FLAG);
+    return diff;
+}
+
+alex_poly *alex_poly_diff(alex_poly *poly) {
+    return _poly_diff(poly, NULL); // flags set by _poly_diff()
+}
+
+alex_poly *alex_poly_diff_arena(alex_poly *poly, alex_arena *arena) {
+    if (arena == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
         return NULL;
     }
 
-    coeffs[0] = c;
-    for (int i = 0; i < poly->deg + 1; ++i) {
-        coeffs[i + 1] = poly->coeffs[i] / ((double) (i + 1));
+    return _poly_diff(poly, arena); // flags set by _poly_diff()
+}
+
+static alex_poly *_poly_integ(alex_poly *poly, double c, alex_arena *arena) {
+    if (poly == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
     }
 
-    alex_poly *integ = alex_make_poly(poly->deg + 1, coeffs);
+    alex_poly *integ = _poly_alloc(poly->deg + 1, poly->deg + 2, arena);
     if (integ == NULL) {
-        return NULL; // flag already set by alex_make_poly()
+        return NULL; // flag already set by _poly_alloc()
     }
 
+    _poly_integ_coeffs(integ, poly, c);
     alex_set_flag(ALEX_OK_FLAG);
     return integ;
 }
 
-double alex_poly_integ_range(alex_poly *poly, alex_range *range) {
-    if (range == NULL) {
+alex_poly *alex_poly_integ(alex_poly *poly, double c) {
+    return _poly_integ(poly, c, NULL); // flags set by _poly_integ()
+}
+
+alex_poly *alex_poly_integ_arena(alex_poly *poly, double c, alex_arena *arena) {
+    if (arena == NULL) {
         alex_set_flag(ALEX_INV_PARAM_FLAG);
-        return 0.;
+        return NULL;
     }
 
-    double integral;
-    alex_poly *integ = alex_poly_integ(poly, 0.);
+    return _poly_integ(poly, c, arena); // flags set by _poly_integ()
+}
 
-    if (integ == NULL) {
-        return 0; // flag already set by alex_poly_integ()
+alex_poly *alex_poly_diff_into(alex_poly *dst, alex_poly *src) {
+    if (dst == NULL || src == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
     }
+    else if (dst->cap < (src->deg == 0 ? 1u : src->deg)) {
+        alex_set_flag(ALEX_POLY_CAP_FLAG);
+        return NULL;
+    }
+
+    _poly_diff_coeffs(dst, src);
+    alex_set_flag(ALEX_OK_FLAG);
+    return dst;
+}
 
-    integral = alex_poly_eval(integ, range->max) - alex_poly_eval(integ, range->min);
-    alex_free_poly(integ);
+alex_poly *alex_poly_integ_into(alex_poly *dst, alex_poly *src, double c) {
+    if (dst == NULL || src == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+    else if (dst->cap < src->deg + 2) {
+        alex_set_flag(ALEX_POLY_CAP_FLAG);
+        return NULL;
+    }
 
+    _poly_integ_coeffs(dst, src, c);
     alex_set_flag(ALEX_OK_FLAG);
-    return integral;
+    return dst;
+}
+
+alex_poly *alex_poly_diff_inplace(alex_poly *poly) {
+    return alex_poly_diff_into(poly, poly); // flags set by alex_poly_diff_into()
+}
+
+alex_poly *alex_poly_integ_inplace(alex_poly *poly, double c) {
+    return alex_poly_integ_into(poly, poly, c); // flags set by alex_poly_integ_into()
+}
+
+/*
+ * Evaluates the antiderivative with integration constant 0 at x by running Horner's scheme
+ * over the coefficients c_i / (i + 1) on the fly, without allocating the integrated poly.
+ */
+static double _poly_horner_integ(const double *coeffs, unsigned int deg, double x) {
+    double res = coeffs[deg] / ((double) deg + 1);
+    for (unsigned int i = deg; i-- > 0;) {
+        res = res * x + coeffs[i] / ((double) i + 1);
+    }
+    return res * x;
+}
+
+int alex_poly_integ_range_r(alex_poly *poly, alex_range *range, double *res) {
+    if (poly == NULL || range == NULL) {
+        *res = 0.;
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    *res = _poly_horner_integ(poly->coeffs, poly->deg, range->max)
+            - _poly_horner_integ(poly->coeffs, poly->deg, range->min);
+    return ALEX_OK_FLAG;
+}
+
+double alex_poly_integ_range(alex_poly *poly, alex_range *range) {
+    double res;
+    alex_set_flag(alex_poly_integ_range_r(poly, range, &res));
+    return res;
 }
 
 static double _poly_func(double x) {
@@ -202,6 +648,36 @@ alex_func_1d alex_poly_func(alex_poly *poly) {
     return &_poly_func;
 }
 
+static double _poly_closure_func(double x, void *ctx) {
+    alex_poly *poly = ctx;
+    return _poly_horner(poly->coeffs, poly->deg, x);
+}
+
+static void _poly_vclosure_func(const double *x, double *y, size_t n, void *ctx) {
+    alex_poly *poly = ctx;
+    _poly_select_kernel()(poly->coeffs, poly->deg, x, y, n);
+}
+
+alex_vclosure_1d alex_poly_vclosure(alex_poly *poly) {
+    if (poly == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return alex_make_vclosure(NULL, NULL);
+    }
+
+    alex_set_flag(ALEX_OK_FLAG);
+    return alex_make_vclosure(&_poly_vclosure_func, poly);
+}
+
+alex_closure_1d alex_poly_closure(alex_poly *poly) {
+    if (poly == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return alex_make_closure(NULL, NULL);
+    }
+
+    alex_set_flag(ALEX_OK_FLAG);
+    return alex_make_closure(&_poly_closure_func, poly);
+}
+
 double alex_poly_lead(alex_poly *poly) {
     if (poly == NULL) {
         alex_set_flag(ALEX_INV_PARAM_FLAG);
@@ -265,3 +741,625 @@ alex_poly *alex_poly_cpy(alex_poly *poly) {
     alex_set_flag(ALEX_OK_FLAG);
     return poly_cpy;
 }
+
+alex_poly *alex_poly_cpy_arena(alex_poly *poly, alex_arena *arena) {
+    if (poly == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+
+    return alex_make_poly_arena(poly->deg, poly->coeffs, arena); // flags set by alex_make_poly_arena()
+}
+
+alex_poly *alex_poly_cpy_into(alex_poly *dst, alex_poly *src) {
+    if (dst == NULL || src == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+    else if (dst->cap < src->deg + 1) {
+        alex_set_flag(ALEX_POLY_CAP_FLAG);
+        return NULL;
+    }
+
+    memmove(dst->coeffs, src->coeffs, ((size_t) src->deg + 1) * sizeof(double));
+    dst->deg = src->deg;
+    alex_set_flag(ALEX_OK_FLAG);
+    return dst;
+}
+
+/*
+ * Arithmetic. The coefficient kernels below work on plain arrays of lengths (ie. degree + 1)
+ * and leave the allocation of results to the alex_poly wrappers further down.
+ */
+
+// returns the degree of c[0] + ... + c[deg] x^deg once leading zero coefficients are dropped
+static unsigned int _poly_trim(const double *c, unsigned int deg) {
+    while (deg > 0 && c[deg] == 0) {
+        --deg;
+    }
+    return deg;
+}
+
+// out[0 .. la + lb - 2] = a * b, out must not overlap a or b
+static void _poly_mul_school(const double *a, size_t la, const double *b, size_t lb, double *out) {
+    memset(out, 0, (la + lb - 1) * sizeof(double));
+    for (size_t i = 0; i < la; ++i) {
+        double ai = a[i];
+        for (size_t j = 0; j < lb; ++j) {
+            out[i + j] += ai * b[j];
+        }
+    }
+}
+
+/*
+ * Karatsuba for two operands of length n: with a = a0 + x^m a1 and b = b0 + x^m b1,
+ * a b = z0 + x^m (z1 - z0 - z2) + x^2m z2 where z0 = a0 b0, z2 = a1 b1 and
+ * z1 = (a0 + a1)(b0 + b1). out receives 2n - 1 coefficients, scratch needs _poly_kara_scratch(n).
+ */
+static size_t _poly_kara_scratch(size_t n) {
+    size_t size = 0;
+    while (n >= ALEX_POLY_KARATSUBA_THRESHOLD) {
+        size_t h = n - n / 2;
+        size += 4 * h;
+        n = h;
+    }
+    return size;
+}
+
+static void _poly_mul_kara(const double *a, const double *b, size_t n, double *out, double *scratch) {
+    if (n < ALEX_POLY_KARATSUBA_THRESHOLD) {
+        _poly_mul_school(a, n, b, n, out);
+        return;
+    }
+
+    size_t m = n / 2, h = n - m, i;
+    double *sa = scratch, *sb = scratch + h, *z1 = scratch + 2 * h;
+    for (i = 0; i < m; ++i) {
+        sa[i] = a[i] + a[m + i];
+        sb[i] = b[i] + b[m + i];
+    }
+    if (h > m) {
+        sa[m] = a[2 * m];
+        sb[m] = b[2 * m];
+    }
+
+    _poly_mul_kara(a, b, m, out, scratch + 4 * h);
+    out[2 * m - 1] = 0.;
+    _poly_mul_kara(a + m, b + m, h, out + 2 * m, scratch + 4 * h);
+    _poly_mul_kara(sa, sb, h, z1, scratch + 4 * h);
+
+    for (i = 0; i < 2 * m - 1; ++i) {
+        z1[i] -= out[i];
+    }
+    for (i = 0; i < 2 * h - 1; ++i) {
+        z1[i] -= out[2 * m + i];
+    }
+    for (i = 0; i < 2 * h - 1; ++i) {
+        out[m + i] += z1[i];
+    }
+}
+
+/*
+ * In-place iterative radix-2 FFT of length n (a power of two). The twiddle factors
+ * exp(-2 pi i k / n), k < n / 2, are passed in (wr, wi), the inverse uses their conjugates
+ * and is not scaled.
+ */
+static void _poly_fft(double *re, double *im, size_t n, const double *wr, const double *wi, int inverse) {
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            double t = re[i];
+            re[i] = re[j];
+            re[j] = t;
+            t = im[i];
+            im[i] = im[j];
+            im[j] = t;
+        }
+    }
+
+    double sign = inverse ? -1. : 1.;
+    for (size_t len = 2; len <= n; len <<= 1) {
+        size_t half = len / 2, step = n / len;
+        for (size_t i = 0; i < n; i += len) {
+            for (size_t k = 0; k < half; ++k) {
+                double cr = wr[k * step], ci = sign * wi[k * step];
+                double ur = re[i + k], ui = im[i + k];
+                double vr = re[i + k + half] * cr - im[i + k + half] * ci;
+                double vi = re[i + k + half] * ci + im[i + k + half] * cr;
+                re[i + k] = ur + vr;
+                im[i + k] = ui + vi;
+                re[i + k + half] = ur - vr;
+                im[i + k + half] = ui - vi;
+            }
+        }
+    }
+}
+
+/*
+ * FFT-based product. Both (real) operands are packed into a single complex transform
+ * z = a + i b, whose spectrum is split into those of a and b by symmetry.
+ */
+static int _poly_mul_fft(const double *a, size_t la, const double *b, size_t lb, double *out) {
+    size_t len = la + lb - 1, n = 1, k;
+    while (n < len) {
+        n <<= 1;
+    }
+
+    double *re = malloc(3 * n * sizeof(double));
+    if (re == NULL) {
+        return ALEX_BAD_ALLOC_FLAG;
+    }
+    double *im = re + n, *wr = im + n, *wi = wr + n / 2;
+
+    for (k = 0; k < n / 2; ++k) {
+        double angle = -2 * M_PI * (double) k / (double) n;
+        wr[k] = cos(angle);
+        wi[k] = sin(angle);
+    }
+    for (k = 0; k < n; ++k) {
+        re[k] = k < la ? a[k] : 0.;
+        im[k] = k < lb ? b[k] : 0.;
+    }
+
+    _poly_fft(re, im, n, wr, wi, 0);
+
+    // A_k = (Z_k + conj Z_-k) / 2, B_k = (Z_k - conj Z_-k) / 2i and C_-k = conj C_k
+    for (k = 0; k <= n / 2; ++k) {
+        size_t j = (n - k) & (n - 1);
+        double ar = (re[k] + re[j]) / 2, ai = (im[k] - im[j]) / 2;
+        double br = (im[k] + im[j]) / 2, bi = (re[j] - re[k]) / 2;
+        double cr = ar * br - ai * bi, ci = ar * bi + ai * br;
+        re[k] = cr;
+        im[k] = ci;
+        re[j] = cr;
+        im[j] = -ci;
+    }
+
+    _poly_fft(re, im, n, wr, wi, 1);
+    for (k = 0; k < len; ++k) {
+        out[k] = re[k] / (double) n;
+    }
+
+    free(re);
+    return ALEX_OK_FLAG;
+}
+
+/*
+ * out[0 .. la + lb - 2] = a * b, picking the algorithm by size. out must not overlap a or b.
+ * Unbalanced Karatsuba products are split into blocks of the shorter operand's length.
+ */
+static int _poly_mul_coeffs(const double *a, size_t la, const double *b, size_t lb, double *out) {
+    if (la < lb) {
+        const double *t = a;
+        a = b;
+        b = t;
+        size_t s = la;
+        la = lb;
+        lb = s;
+    }
+
+    if (lb < ALEX_POLY_KARATSUBA_THRESHOLD) {
+        _poly_mul_school(a, la, b, lb, out);
+        return ALEX_OK_FLAG;
+    }
+    if (lb >= ALEX_POLY_FFT_THRESHOLD) {
+        return _poly_mul_fft(a, la, b, lb, out);
+    }
+
+    // scratch for the Karatsuba recursion, a zero padded last block and a block product
+    size_t scratch = _poly_kara_scratch(lb);
+    double *buf = malloc((scratch + 3 * lb) * sizeof(double));
+    if (buf == NULL) {
+        return ALEX_BAD_ALLOC_FLAG;
+    }
+    double *block = buf + scratch, *prod = block + lb;
+
+    memset(out, 0, (la + lb - 1) * sizeof(double));
+    for (size_t i = 0; i < la; i += lb) {
+        const double *ai = a + i;
+        size_t n = la - i < lb ? la - i : lb;
+        if (n < lb) {
+            memcpy(block, ai, n * sizeof(double));
+            memset(block + n, 0, (lb - n) * sizeof(double));
+            ai = block;
+        }
+        _poly_mul_kara(ai, b, lb, prod, buf);
+        for (size_t j = 0; j < n + lb - 1; ++j) {
+            out[i + j] += prod[j];
+        }
+    }
+
+    free(buf);
+    return ALEX_OK_FLAG;
+}
+
+// dst = p + sign * q, element by element, so dst may be p or q
+static alex_poly *_poly_add_sub(alex_poly *dst, alex_poly *p, alex_poly *q, double sign) {
+    unsigned int deg = p->deg > q->deg ? p->deg : q->deg;
+    for (unsigned int i = 0; i <= deg; ++i) {
+        double a = i <= p->deg ? p->coeffs[i] : 0., b = i <= q->deg ? q->coeffs[i] : 0.;
+        dst->coeffs[i] = a + sign * b;
+    }
+    dst->deg = _poly_trim(dst->coeffs, deg);
+    alex_set_flag(ALEX_OK_FLAG);
+    return dst;
+}
+
+static alex_poly *_poly_add_sub_alloc(alex_poly *p, alex_poly *q, double sign, alex_arena *arena) {
+    if (p == NULL || q == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+
+    unsigned int deg = p->deg > q->deg ? p->deg : q->deg;
+    alex_poly *res = _poly_alloc(deg, deg + 1, arena);
+    if (res == NULL) {
+        return NULL; // flag already set by _poly_alloc()
+    }
+    return _poly_add_sub(res, p, q, sign);
+}
+
+static alex_poly *_poly_add_sub_into(alex_poly *dst, alex_poly *p, alex_poly *q, double sign) {
+    if (dst == NULL || p == NULL || q == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+    else if (dst->cap < (p->deg > q->deg ? p->deg : q->deg) + 1) {
+        alex_set_flag(ALEX_POLY_CAP_FLAG);
+        return NULL;
+    }
+    return _poly_add_sub(dst, p, q, sign); // flags set by _poly_add_sub()
+}
+
+alex_poly *alex_poly_add(alex_poly *p, alex_poly *q) {
+    return _poly_add_sub_alloc(p, q, 1., NULL); // flags set by _poly_add_sub_alloc()
+}
+
+alex_poly *alex_poly_add_arena(alex_poly *p, alex_poly *q, alex_arena *arena) {
+    if (arena == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+    return _poly_add_sub_alloc(p, q, 1., arena); // flags set by _poly_add_sub_alloc()
+}
+
+alex_poly *alex_poly_add_into(alex_poly *dst, alex_poly *p, alex_poly *q) {
+    return _poly_add_sub_into(dst, p, q, 1.); // flags set by _poly_add_sub_into()
+}
+
+alex_poly *alex_poly_sub(alex_poly *p, alex_poly *q) {
+    return _poly_add_sub_alloc(p, q, -1., NULL); // flags set by _poly_add_sub_alloc()
+}
+
+alex_poly *alex_poly_sub_arena(alex_poly *p, alex_poly *q, alex_arena *arena) {
+    if (arena == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+    return _poly_add_sub_alloc(p, q, -1., arena); // flags set by _poly_add_sub_alloc()
+}
+
+alex_poly *alex_poly_sub_into(alex_poly *dst, alex_poly *p, alex_poly *q) {
+    return _poly_add_sub_into(dst, p, q, -1.); // flags set by _poly_add_sub_into()
+}
+
+// dst = p * q, dst must have room for deg(p) + deg(q) + 1 coefficients and may be p or q
+static alex_poly *_poly_mul(alex_poly *dst, alex_poly *p, alex_poly *q) {
+    size_t la = (size_t) p->deg + 1, lb = (size_t) q->deg + 1;
+    double *out = dst->coeffs;
+    if (dst == p || dst == q) {
+        out = malloc((la + lb - 1) * sizeof(double));
+        if (out == NULL) {
+            alex_set_flag(ALEX_BAD_ALLOC_FLAG);
+            return NULL;
+        }
+    }
+
+    int flag = _poly_mul_coeffs(p->coeffs, la, q->coeffs, lb, out);
+    if (out != dst->coeffs) {
+        if (flag == ALEX_OK_FLAG) {
+            memcpy(dst->coeffs, out, (la + lb - 1) * sizeof(double));
+        }
+        free(out);
+    }
+    if (flag != ALEX_OK_FLAG) {
+        alex_set_flag(flag);
+        return NULL;
+    }
+
+    dst->deg = p->deg + q->deg;
+    alex_set_flag(ALEX_OK_FLAG);
+    return dst;
+}
+
+static alex_poly *_poly_mul_alloc(alex_poly *p, alex_poly *q, alex_arena *arena) {
+    ALEX_STATS_SCOPE(ALEX_STATS_POLY);
+    if (p == NULL || q == NULL || p->deg > UINT_MAX - 1 - q->deg) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+
+    alex_poly *res = _poly_alloc(p->deg + q->deg, p->deg + q->deg + 1, arena);
+    if (res == NULL) {
+        return NULL; // flag already set by _poly_alloc()
+    }
+    if (_poly_mul(res, p, q) == NULL) {
+        if (arena == NULL) {
+            free(res);
+        }
+        return NULL; // flag already set by _poly_mul()
+    }
+    return res;
+}
+
+alex_poly *alex_poly_mul(alex_poly *p, alex_poly *q) {
+    return _poly_mul_alloc(p, q, NULL); // flags set by _poly_mul_alloc()
+}
+
+alex_poly *alex_poly_mul_arena(alex_poly *p, alex_poly *q, alex_arena *arena) {
+    if (arena == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+    return _poly_mul_alloc(p, q, arena); // flags set by _poly_mul_alloc()
+}
+
+alex_poly *alex_poly_mul_into(alex_poly *dst, alex_poly *p, alex_poly *q) {
+    ALEX_STATS_SCOPE(ALEX_STATS_POLY);
+    if (dst == NULL || p == NULL || q == NULL || p->deg > UINT_MAX - 1 - q->deg) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+    else if (dst->cap < p->deg + q->deg + 1) {
+        alex_set_flag(ALEX_POLY_CAP_FLAG);
+        return NULL;
+    }
+    return _poly_mul(dst, p, q); // flags set by _poly_mul()
+}
+
+/*
+ * Long division of p by d, where d has been trimmed to degree dd with a nonzero leading
+ * coefficient. The remainder is computed in place of a copy of p, the quotient coefficients
+ * are produced from the top down.
+ */
+static int _poly_divmod(alex_poly *quot, alex_poly *rem, alex_poly *p, alex_poly *d, unsigned int dd) {
+    unsigned int dp = p->deg;
+    double *r = malloc(((size_t) dp + 1) * sizeof(double));
+    if (r == NULL) {
+        return ALEX_BAD_ALLOC_FLAG;
+    }
+    memcpy(r, p->coeffs, ((size_t) dp + 1) * sizeof(double));
+
+    double lead = d->coeffs[dd];
+    if (dp < dd) {
+        quot->coeffs[0] = 0.;
+        quot->deg = 0;
+    }
+    else {
+        for (unsigned int k = dp - dd + 1; k-- > 0;) {
+            double c = r[k + dd] / lead;
+            for (unsigned int j = 0; j < dd; ++j) {
+                r[k + j] -= c * d->coeffs[j];
+            }
+            r[k + dd] = 0.;
+            quot->coeffs[k] = c;
+        }
+        quot->deg = dp - dd;
+    }
+
+    if (rem != NULL) {
+        unsigned int deg = dd == 0 ? 0u : (dp < dd ? dp : dd - 1);
+        memcpy(rem->coeffs, r, ((size_t) deg + 1) * sizeof(double));
+        if (dd == 0) {
+            rem->coeffs[0] = 0.;
+        }
+        rem->deg = _poly_trim(rem->coeffs, deg);
+    }
+
+    free(r);
+    return ALEX_OK_FLAG;
+}
+
+#define _poly_quot_cap(dp, dd) ((dp) < (dd) ? 1u : (dp) - (dd) + 1)
+#define _poly_rem_cap(dp, dd) ((dd) == 0 ? 1u : ((dp) < (dd) ? (dp) + 1 : (dd)))
+
+alex_poly *alex_poly_divmod_into(alex_poly *quot, alex_poly *rem, alex_poly *p, alex_poly *d) {
+    ALEX_STATS_SCOPE(ALEX_STATS_POLY);
+    if (quot == NULL || p == NULL || d == NULL || quot == rem) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+
+    unsigned int dd = _poly_trim(d->coeffs, d->deg);
+    if (d->coeffs[dd] == 0) {
+        alex_set_flag(ALEX_ALG_INV_OP_FLAG);
+        return NULL;
+    }
+    else if (quot->cap < _poly_quot_cap(p->deg, dd) || (rem != NULL && rem->cap < _poly_rem_cap(p->deg, dd))) {
+        alex_set_flag(ALEX_POLY_CAP_FLAG);
+        return NULL;
+    }
+
+    // the divisor is read throughout the division, keep it intact if it is also an output
+    alex_poly *div = d;
+    if (d == quot || d == rem) {
+        div = alex_poly_cpy(d);
+        if (div == NULL) {
+            return NULL; // flag already set by alex_poly_cpy()
+        }
+    }
+
+    int flag = _poly_divmod(quot, rem, p, div, dd);
+    if (div != d) {
+        free(div);
+    }
+    alex_set_flag(flag);
+    return flag == ALEX_OK_FLAG ? quot : NULL;
+}
+
+static alex_poly *_poly_divmod_alloc(alex_poly *p, alex_poly *d, alex_poly **rem, alex_arena *arena) {
+    ALEX_STATS_SCOPE(ALEX_STATS_POLY);
+    if (p == NULL || d == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+
+    unsigned int dd = _poly_trim(d->coeffs, d->deg);
+    if (d->coeffs[dd] == 0) {
+        alex_set_flag(ALEX_ALG_INV_OP_FLAG);
+        return NULL;
+    }
+
+    unsigned int qcap = _poly_quot_cap(p->deg, dd), rcap = _poly_rem_cap(p->deg, dd);
+    alex_poly *quot = _poly_alloc(qcap - 1, qcap, arena), *r = NULL;
+    if (quot != NULL && rem != NULL) {
+        r = _poly_alloc(rcap - 1, rcap, arena);
+    }
+    if (quot == NULL || (rem != NULL && r == NULL)) {
+        if (arena == NULL) {
+            free(quot);
+        }
+        return NULL; // flag already set by _poly_alloc()
+    }
+
+    int flag = _poly_divmod(quot, r, p, d, dd);
+    if (flag != ALEX_OK_FLAG) {
+        if (arena == NULL) {
+            free(quot);
+            free(r);
+        }
+        alex_set_flag(flag);
+        return NULL;
+    }
+
+    if (rem != NULL) {
+        *rem = r;
+    }
+    alex_set_flag(ALEX_OK_FLAG);
+    return quot;
+}
+
+alex_poly *alex_poly_divmod(alex_poly *p, alex_poly *d, alex_poly **rem) {
+    return _poly_divmod_alloc(p, d, rem, NULL); // flags set by _poly_divmod_alloc()
+}
+
+alex_poly *alex_poly_divmod_arena(alex_poly *p, alex_poly *d, alex_poly **rem, alex_arena *arena) {
+    if (arena == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+    return _poly_divmod_alloc(p, d, rem, arena); // flags set by _poly_divmod_alloc()
+}
+
+/*
+ * dst = p(q(x)) by Horner's scheme over polynomials, r <- r * q + p_k, alternating between
+ * two scratch buffers. Every product goes through _poly_mul_coeffs(), so the late, large
+ * steps use the fast multiplication algorithms.
+ */
+static int _poly_compose(double *out, alex_poly *p, alex_poly *q) {
+    size_t len = (size_t) p->deg * q->deg + 1, lq = (size_t) q->deg + 1;
+    if (q->deg == 0) {
+        out[0] = _poly_horner(p->coeffs, p->deg, q->coeffs[0]);
+        return ALEX_OK_FLAG;
+    }
+    else if (p->deg == 0) {
+        out[0] = p->coeffs[0];
+        return ALEX_OK_FLAG;
+    }
+
+    double *buf = malloc(2 * len * sizeof(double));
+    if (buf == NULL) {
+        return ALEX_BAD_ALLOC_FLAG;
+    }
+    double *r = buf, *t = buf + len;
+    size_t lr = 1;
+    r[0] = p->coeffs[p->deg];
+
+    for (unsigned int k = p->deg; k-- > 0;) {
+        int flag = _poly_mul_coeffs(r, lr, q->coeffs, lq, t);
+        if (flag != ALEX_OK_FLAG) {
+            free(buf);
+            return flag;
+        }
+        lr += lq - 1;
+        t[0] += p->coeffs[k];
+        double *s = r;
+        r = t;
+        t = s;
+    }
+
+    memcpy(out, r, len * sizeof(double));
+    free(buf);
+    return ALEX_OK_FLAG;
+}
+
+alex_poly *alex_poly_compose_into(alex_poly *dst, alex_poly *p, alex_poly *q) {
+    ALEX_STATS_SCOPE(ALEX_STATS_POLY);
+    if (dst == NULL || p == NULL || q == NULL || (q->deg != 0 && p->deg > (UINT_MAX - 1) / q->deg)) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+
+    unsigned int deg = p->deg * q->deg;
+    if (dst->cap < deg + 1) {
+        alex_set_flag(ALEX_POLY_CAP_FLAG);
+        return NULL;
+    }
+
+    // the result is assembled in scratch memory, so dst may be p or q
+    double *out = malloc(((size_t) deg + 1) * sizeof(double));
+    if (out == NULL) {
+        alex_set_flag(ALEX_BAD_ALLOC_FLAG);
+        return NULL;
+    }
+    int flag = _poly_compose(out, p, q);
+    if (flag == ALEX_OK_FLAG) {
+        memcpy(dst->coeffs, out, ((size_t) deg + 1) * sizeof(double));
+        dst->deg = deg;
+    }
+    free(out);
+
+    alex_set_flag(flag);
+    return flag == ALEX_OK_FLAG ? dst : NULL;
+}
+
+static alex_poly *_poly_compose_alloc(alex_poly *p, alex_poly *q, alex_arena *arena) {
+    ALEX_STATS_SCOPE(ALEX_STATS_POLY);
+    if (p == NULL || q == NULL || (q->deg != 0 && p->deg > (UINT_MAX - 1) / q->deg)) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+
+    unsigned int deg = p->deg * q->deg;
+    alex_poly *res = _poly_alloc(deg, deg + 1, arena);
+    if (res == NULL) {
+        return NULL; // flag already set by _poly_alloc()
+    }
+
+    int flag = _poly_compose(res->coeffs, p, q);
+    if (flag != ALEX_OK_FLAG) {
+        if (arena == NULL) {
+            free(res);
+        }
+        alex_set_flag(flag);
+        return NULL;
+    }
+    alex_set_flag(ALEX_OK_FLAG);
+    return res;
+}
+
+alex_poly *alex_poly_compose(alex_poly *p, alex_poly *q) {
+    return _poly_compose_alloc(p, q, NULL); // flags set by _poly_compose_alloc()
+}
+
+alex_poly *alex_poly_compose_arena(alex_poly *p, alex_poly *q, alex_arena *arena) {
+    if (arena == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+    return _poly_compose_alloc(p, q, arena); // flags set by _poly_compose_alloc()
+}
@@ -0,0 +1,531 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/polybatch.h"
+#include "../include/dispatch.h"
+#include "../include/flags.h"
+#include "../include/stats.h"
+
+#if defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define ALEX_POLY_BATCH_SSE2
+#if defined(__GNUC__)
+#define ALEX_POLY_BATCH_AVX2
+#define ALEX_POLY_BATCH_AVX512
+#endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define ALEX_POLY_BATCH_NEON
+#endif
+
+/*
+ * The kernels must round every product and every sum, as such no multiplication and addition may be
+ * contracted into a fused multiply-add, whatever -ffp-contract or -march the library is built with.
+ */
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+/*
+ * Row kernels, each processing n lanes of a row:
+ * - horner: acc[j] = acc[j] * x[j] + row[j]
+ * - mul:    dst[j] = src[j] * s
+ * - div:    dst[j] = src[j] / s
+ * As in poly.c, no fused multiply-add is used, so the results match the single polynomial
+ * routines bit for bit.
+ */
+typedef struct {
+    void (*horner)(double *acc, const double *x, const double *row, size_t n);
+    void (*mul)(double *dst, const double *src, double s, size_t n);
+    void (*div)(double *dst, const double *src, double s, size_t n);
+} _batch_kernels;
+
+static void _horner_scalar(double *acc, const double *x, const double *row, size_t n) {
+    for (size_t j = 0; j < n; ++j) {
+        acc[j] = acc[j] * x[j] + row[j];
+    }
+}
+
+static void _mul_scalar(double *dst, const double *src, double s, size_t n) {
+    for (size_t j = 0; j < n; ++j) {
+        dst[j] = src[j] * s;
+    }
+}
+
+static void _div_scalar(double *dst, const double *src, double s, size_t n) {
+    for (size_t j = 0; j < n; ++j) {
+        dst[j] = src[j] / s;
+    }
+}
+
+#if defined(ALEX_POLY_BATCH_SSE2)
+static void _horner_sse2(double *acc, const double *x, const double *row, size_t n) {
+    size_t j = 0;
+    for (; j + 2 <= n; j += 2) {
+        __m128d a = _mm_loadu_pd(acc + j);
+        _mm_storeu_pd(acc + j, _mm_add_pd(_mm_mul_pd(a, _mm_loadu_pd(x + j)), _mm_loadu_pd(row + j)));
+    }
+    _horner_scalar(acc + j, x + j, row + j, n - j);
+}
+
+static void _mul_sse2(double *dst, const double *src, double s, size_t n) {
+    __m128d vs = _mm_set1_pd(s);
+    size_t j = 0;
+    for (; j + 2 <= n; j += 2) {
+        _mm_storeu_pd(dst + j, _mm_mul_pd(_mm_loadu_pd(src + j), vs));
+    }
+    _mul_scalar(dst + j, src + j, s, n - j);
+}
+
+static void _div_sse2(double *dst, const double *src, double s, size_t n) {
+    __m128d vs = _mm_set1_pd(s);
+    size_t j = 0;
+    for (; j + 2 <= n; j += 2) {
+        _mm_storeu_pd(dst + j, _mm_div_pd(_mm_loadu_pd(src + j), vs));
+    }
+    _div_scalar(dst + j, src + j, s, n - j);
+}
+#endif
+
+#if defined(ALEX_POLY_BATCH_AVX2)
+__attribute__((target("avx2")))
+static void _horner_avx2(double *acc, const double *x, const double *row, size_t n) {
+    size_t j = 0;
+    for (; j + 4 <= n; j += 4) {
+        __m256d a = _mm256_loadu_pd(acc + j);
+        _mm256_storeu_pd(acc + j, _mm256_add_pd(_mm256_mul_pd(a, _mm256_loadu_pd(x + j)), _mm256_loadu_pd(row + j)));
+    }
+    _horner_scalar(acc + j, x + j, row + j, n - j);
+}
+
+__attribute__((target("avx2")))
+static void _mul_avx2(double *dst, const double *src, double s, size_t n) {
+    __m256d vs = _mm256_set1_pd(s);
+    size_t j = 0;
+    for (; j + 4 <= n; j += 4) {
+        _mm256_storeu_pd(dst + j, _mm256_mul_pd(_mm256_loadu_pd(src + j), vs));
+    }
+    _mul_scalar(dst + j, src + j, s, n - j);
+}
+
+__attribute__((target("avx2")))
+static void _div_avx2(double *dst, const double *src, double s, size_t n) {
+    __m256d vs = _mm256_set1_pd(s);
+    size_t j = 0;
+    for (; j + 4 <= n; j += 4) {
+        _mm256_storeu_pd(dst + j, _mm256_div_pd(_mm256_loadu_pd(src + j), vs));
+    }
+    _div_scalar(dst + j, src + j, s, n - j);
+}
+#endif
+
+#if defined(ALEX_POLY_BATCH_AVX512)
+/*
+ * AVX-512F implies FMA, which GCC would otherwise contract _mm512_mul_pd() and _mm512_add_pd()
+ * into. The rounding variants are not contracted.
+ */
+#define _horner512(a, x, c) _mm512_add_round_pd(_mm512_mul_round_pd(a, x, _MM_FROUND_CUR_DIRECTION), c, \
+        _MM_FROUND_CUR_DIRECTION)
+
+__attribute__((target("avx512f")))
+static void _horner_avx512(double *acc, const double *x, const double *row, size_t n) {
+    size_t j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m512d a = _mm512_loadu_pd(acc + j);
+        _mm512_storeu_pd(acc + j, _horner512(a, _mm512_loadu_pd(x + j), _mm512_loadu_pd(row + j)));
+    }
+    // masked tail, a scalar one would be contracted as well
+    if (j < n) {
+        __mmask8 m = (__mmask8) ((1u << (n - j)) - 1);
+        __m512d a = _mm512_maskz_loadu_pd(m, acc + j);
+        _mm512_mask_storeu_pd(acc + j, m, _horner512(a, _mm512_maskz_loadu_pd(m, x + j),
+                _mm512_maskz_loadu_pd(m, row + j)));
+    }
+}
+
+__attribute__((target("avx512f")))
+static void _mul_avx512(double *dst, const double *src, double s, size_t n) {
+    __m512d vs = _mm512_set1_pd(s);
+    size_t j = 0;
+    for (; j + 8 <= n; j += 8) {
+        _mm512_storeu_pd(dst + j, _mm512_mul_pd(_mm512_loadu_pd(src + j), vs));
+    }
+    _mul_scalar(dst + j, src + j, s, n - j);
+}
+
+__attribute__((target("avx512f")))
+static void _div_avx512(double *dst, const double *src, double s, size_t n) {
+    __m512d vs = _mm512_set1_pd(s);
+    size_t j = 0;
+    for (; j + 8 <= n; j += 8) {
+        _mm512_storeu_pd(dst + j, _mm512_div_pd(_mm512_loadu_pd(src + j), vs));
+    }
+    _div_scalar(dst + j, src + j, s, n - j);
+}
+#endif
+
+#if defined(ALEX_POLY_BATCH_NEON)
+static void _horner_neon(double *acc, const double *x, const double *row, size_t n) {
+    size_t j = 0;
+    for (; j + 2 <= n; j += 2) {
+        float64x2_t a = vld1q_f64(acc + j);
+        vst1q_f64(acc + j, vaddq_f64(vmulq_f64(a, vld1q_f64(x + j)), vld1q_f64(row + j)));
+    }
+    _horner_scalar(acc + j, x + j, row + j, n - j);
+}
+
+static void _mul_neon(double *dst, const double *src, double s, size_t n) {
+    float64x2_t vs = vdupq_n_f64(s);
+    size_t j = 0;
+    for (; j + 2 <= n; j += 2) {
+        vst1q_f64(dst + j, vmulq_f64(vld1q_f64(src + j), vs));
+    }
+    _mul_scalar(dst + j, src + j, s, n - j);
+}
+
+static void _div_neon(double *dst, const double *src, double s, size_t n) {
+    float64x2_t vs = vdupq_n_f64(s);
+    size_t j = 0;
+    for (; j + 2 <= n; j += 2) {
+        vst1q_f64(dst + j, vdivq_f64(vld1q_f64(src + j), vs));
+    }
+    _div_scalar(dst + j, src + j, s, n - j);
+}
+#endif
+
+// the kernels indexed by instruction set (see dispatch.h), as _poly_kernels in poly.c
+static const _batch_kernels _batch_kernel_table[ALEX_ISA_COUNT] = {
+    [ALEX_ISA_SCALAR] = {&_horner_scalar, &_mul_scalar, &_div_scalar},
+#if defined(ALEX_POLY_BATCH_SSE2)
+    [ALEX_ISA_SSE2] = {&_horner_sse2, &_mul_sse2, &_div_sse2},
+#endif
+#if defined(ALEX_POLY_BATCH_AVX2)
+    [ALEX_ISA_AVX2] = {&_horner_avx2, &_mul_avx2, &_div_avx2},
+#endif
+#if defined(ALEX_POLY_BATCH_AVX512)
+    [ALEX_ISA_AVX512] = {&_horner_avx512, &_mul_avx512, &_div_avx512},
+#endif
+#if defined(ALEX_POLY_BATCH_NEON)
+    [ALEX_ISA_NEON] = {&_horner_neon, &_mul_neon, &_div_neon},
+#endif
+};
+
+static const _batch_kernels *_batch_select_kernels(void) {
+    return &_batch_kernel_table[alex_get_isa()];
+}
+
+/*
+ * The struct is followed by the coefficient matrix, whose start is rounded up to
+ * ALEX_POLY_BATCH_ALIGN. Rows are padded to a multiple of the alignment as well.
+ */
+#define _BATCH_LANES (ALEX_POLY_BATCH_ALIGN / sizeof(double))
+
+alex_poly_batch *alex_make_poly_batch(size_t count, unsigned int deg, unsigned int cap) {
+    if (cap == 0) {
+        cap = deg + 1;
+    }
+    else if (cap < deg + 1) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+
+    size_t stride = (count + _BATCH_LANES - 1) / _BATCH_LANES * _BATCH_LANES;
+    if (stride != 0 && (SIZE_MAX - sizeof(alex_poly_batch) - ALEX_POLY_BATCH_ALIGN) / sizeof(double) / stride < cap) {
+        alex_set_flag(ALEX_BAD_ALLOC_FLAG);
+        return NULL;
+    }
+
+    size_t size = (size_t) cap * stride * sizeof(double);
+    alex_poly_batch *batch = malloc(sizeof(alex_poly_batch) + ALEX_POLY_BATCH_ALIGN + size);
+    if (batch == NULL) {
+        alex_set_flag(ALEX_BAD_ALLOC_FLAG);
+        return NULL;
+    }
+
+    uintptr_t start = (uintptr_t) (batch + 1);
+    batch->coeffs = (double *) ((start + ALEX_POLY_BATCH_ALIGN - 1) & ~(uintptr_t) (ALEX_POLY_BATCH_ALIGN - 1));
+    batch->count = count;
+    batch->stride = stride;
+    batch->deg = deg;
+    batch->cap = cap;
+    memset(batch->coeffs, 0, size);
+
+    alex_set_flag(ALEX_OK_FLAG);
+    return batch;
+}
+
+void alex_free_poly_batch(alex_poly_batch *batch) {
+    if (batch == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return;
+    }
+
+    free(batch); // the coefficients are part of the same block
+    alex_set_flag(ALEX_OK_FLAG);
+}
+
+void alex_poly_batch_set(alex_poly_batch *batch, size_t i, alex_poly *poly) {
+    if (batch == NULL || poly == NULL || i >= batch->count) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return;
+    }
+    else if (poly->deg > batch->deg) {
+        alex_set_flag(ALEX_POLY_CAP_FLAG);
+        return;
+    }
+
+    for (unsigned int k = 0; k <= batch->deg; ++k) {
+        alex_poly_batch_row(batch, k)[i] = k <= poly->deg ? poly->coeffs[k] : 0.;
+    }
+    alex_set_flag(ALEX_OK_FLAG);
+}
+
+alex_poly *alex_poly_batch_get(alex_poly_batch *batch, size_t i, alex_poly *dst) {
+    if (batch == NULL || dst == NULL || i >= batch->count) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+    else if (dst->cap < batch->deg + 1) {
+        alex_set_flag(ALEX_POLY_CAP_FLAG);
+        return NULL;
+    }
+
+    unsigned int deg = 0;
+    for (unsigned int k = 0; k <= batch->deg; ++k) {
+        dst->coeffs[k] = alex_poly_batch_row(batch, k)[i];
+        if (dst->coeffs[k] != 0) {
+            deg = k;
+        }
+    }
+    dst->deg = deg;
+    alex_set_flag(ALEX_OK_FLAG);
+    return dst;
+}
+
+/*
+ * Horner's scheme over the rows for the polynomials first, ..., first + n - 1, with n at most
+ * ALEX_POLY_BATCH_TILE. out is used as the accumulator, x must not overlap it.
+ */
+static void _batch_eval_tile(const _batch_kernels *k, alex_poly_batch *batch, const double *x, double *out,
+        size_t first, size_t n) {
+    memcpy(out, alex_poly_batch_row(batch, batch->deg) + first, n * sizeof(double));
+    for (unsigned int i = batch->deg; i-- > 0;) {
+        k->horner(out, x, alex_poly_batch_row(batch, i) + first, n);
+    }
+}
+
+int alex_poly_batch_eval_r(alex_poly_batch *batch, const double *xs, double *out) {
+    ALEX_STATS_SCOPE(ALEX_STATS_POLY);
+    if (batch == NULL || xs == NULL || out == NULL) {
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    const _batch_kernels *k = _batch_select_kernels();
+    double x[ALEX_POLY_BATCH_TILE];
+    for (size_t first = 0; first < batch->count; first += ALEX_POLY_BATCH_TILE) {
+        size_t n = batch->count - first < ALEX_POLY_BATCH_TILE ? batch->count - first : ALEX_POLY_BATCH_TILE;
+        memcpy(x, xs + first, n * sizeof(double)); // xs may be out
+        _batch_eval_tile(k, batch, x, out + first, first, n);
+    }
+    return ALEX_OK_FLAG;
+}
+
+typedef struct {
+    const _batch_kernels *k;
+    alex_poly_batch *batch;
+    const double *xs;
+    double *out;
+} _batch_eval_job;
+
+static void _batch_eval_par_tile(size_t t, void *ctx) {
+    _batch_eval_job *job = ctx;
+    size_t first = t * ALEX_POLY_BATCH_TILE, count = job->batch->count;
+    size_t n = count - first < ALEX_POLY_BATCH_TILE ? count - first : ALEX_POLY_BATCH_TILE;
+    double x[ALEX_POLY_BATCH_TILE];
+    memcpy(x, job->xs + first, n * sizeof(double)); // xs may be out
+    _batch_eval_tile(job->k, job->batch, x, job->out + first, first, n);
+}
+
+int alex_poly_batch_eval_par(alex_poly_batch *batch, const double *xs, double *out, alex_pool *pool,
+        unsigned int threads) {
+    ALEX_STATS_SCOPE(ALEX_STATS_POLY);
+    if (batch == NULL || xs == NULL || out == NULL) {
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    _batch_eval_job job = {_batch_select_kernels(), batch, xs, out};
+    alex_pool_for(pool, threads, (batch->count + ALEX_POLY_BATCH_TILE - 1) / ALEX_POLY_BATCH_TILE,
+            &_batch_eval_par_tile, &job);
+    return ALEX_OK_FLAG;
+}
+
+void alex_poly_batch_eval(alex_poly_batch *batch, const double *xs, double *out) {
+    alex_set_flag(alex_poly_batch_eval_r(batch, xs, out));
+}
+
+int alex_poly_batch_eval_at_r(alex_poly_batch *batch, double x, double *out) {
+    ALEX_STATS_SCOPE(ALEX_STATS_POLY);
+    if (batch == NULL || out == NULL) {
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    const _batch_kernels *k = _batch_select_kernels();
+    double xt[ALEX_POLY_BATCH_TILE];
+    for (size_t j = 0; j < ALEX_POLY_BATCH_TILE; ++j) {
+        xt[j] = x;
+    }
+    for (size_t first = 0; first < batch->count; first += ALEX_POLY_BATCH_TILE) {
+        size_t n = batch->count - first < ALEX_POLY_BATCH_TILE ? batch->count - first : ALEX_POLY_BATCH_TILE;
+        _batch_eval_tile(k, batch, xt, out + first, first, n);
+    }
+    return ALEX_OK_FLAG;
+}
+
+void alex_poly_batch_eval_at(alex_poly_batch *batch, double x, double *out) {
+    alex_set_flag(alex_poly_batch_eval_at_r(batch, x, out));
+}
+
+// whole rows are processed including their padding, which stays 0
+static void _batch_diff(alex_poly_batch *dst, alex_poly_batch *src) {
+    const _batch_kernels *k = _batch_select_kernels();
+    unsigned int deg = src->deg;
+    if (deg == 0) {
+        memset(dst->coeffs, 0, dst->stride * sizeof(double));
+    }
+    for (unsigned int i = 0; i < deg; ++i) {
+        k->mul(alex_poly_batch_row(dst, i), alex_poly_batch_row(src, i + 1), (double) i + 1, src->stride);
+    }
+    dst->deg = deg == 0 ? 0u : deg - 1;
+}
+
+static void _batch_integ(alex_poly_batch *dst, alex_poly_batch *src, double c) {
+    const _batch_kernels *k = _batch_select_kernels();
+    unsigned int deg = src->deg;
+    // from the top down, so that dst may be src
+    for (unsigned int i = deg + 1; i-- > 0;) {
+        k->div(alex_poly_batch_row(dst, i + 1), alex_poly_batch_row(src, i), (double) i + 1, src->stride);
+    }
+    double *row = alex_poly_batch_row(dst, 0);
+    for (size_t j = 0; j < dst->count; ++j) {
+        row[j] = c;
+    }
+    dst->deg = deg + 1;
+}
+
+alex_poly_batch *alex_poly_batch_diff(alex_poly_batch *batch) {
+    if (batch == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+
+    alex_poly_batch *diff = alex_make_poly_batch(batch->count, batch->deg == 0 ? 0u : batch->deg - 1, 0);
+    if (diff == NULL) {
+        return NULL; // flag already set by alex_make_poly_batch()
+    }
+    _batch_diff(diff, batch);
+    return diff; // flag set by alex_make_poly_batch()
+}
+
+alex_poly_batch *alex_poly_batch_diff_into(alex_poly_batch *dst, alex_poly_batch *src) {
+    if (dst == NULL || src == NULL || dst->count != src->count) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+    else if (dst->cap < (src->deg == 0 ? 1u : src->deg)) {
+        alex_set_flag(ALEX_POLY_CAP_FLAG);
+        return NULL;
+    }
+
+    _batch_diff(dst, src);
+    alex_set_flag(ALEX_OK_FLAG);
+    return dst;
+}
+
+alex_poly_batch *alex_poly_batch_integ(alex_poly_batch *batch, double c) {
+    if (batch == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+
+    alex_poly_batch *integ = alex_make_poly_batch(batch->count, batch->deg + 1, 0);
+    if (integ == NULL) {
+        return NULL; // flag already set by alex_make_poly_batch()
+    }
+    _batch_integ(integ, batch, c);
+    return integ; // flag set by alex_make_poly_batch()
+}
+
+alex_poly_batch *alex_poly_batch_integ_into(alex_poly_batch *dst, alex_poly_batch *src, double c) {
+    if (dst == NULL || src == NULL || dst->count != src->count) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+    else if (dst->cap < src->deg + 2) {
+        alex_set_flag(ALEX_POLY_CAP_FLAG);
+        return NULL;
+    }
+
+    _batch_integ(dst, src, c);
+    alex_set_flag(ALEX_OK_FLAG);
+    return dst;
+}
+
+int alex_poly_batch_integ_range_r(alex_poly_batch *batch, alex_range *range, double *out) {
+    ALEX_STATS_SCOPE(ALEX_STATS_POLY);
+    if (batch == NULL || range == NULL || out == NULL) {
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    /*
+     * Both antiderivatives (integration constant 0) are evaluated at once, applying the same
+     * operations as _poly_horner_integ() in poly.c, so that each row is divided only once.
+     */
+    const _batch_kernels *k = _batch_select_kernels();
+    double lower[ALEX_POLY_BATCH_TILE], row[ALEX_POLY_BATCH_TILE];
+    double xa[ALEX_POLY_BATCH_TILE], xb[ALEX_POLY_BATCH_TILE];
+    for (size_t j = 0; j < ALEX_POLY_BATCH_TILE; ++j) {
+        xa[j] = range->min;
+        xb[j] = range->max;
+    }
+    unsigned int deg = batch->deg;
+    for (size_t first = 0; first < batch->count; first += ALEX_POLY_BATCH_TILE) {
+        size_t n = batch->count - first < ALEX_POLY_BATCH_TILE ? batch->count - first : ALEX_POLY_BATCH_TILE;
+        double *upper = out + first;
+        k->div(upper, alex_poly_batch_row(batch, deg) + first, (double) deg + 1, n);
+        memcpy(lower, upper, n * sizeof(double));
+        for (unsigned int i = deg; i-- > 0;) {
+            k->div(row, alex_poly_batch_row(batch, i) + first, (double) i + 1, n);
+            k->horner(upper, xb, row, n);
+            k->horner(lower, xa, row, n);
+        }
+        for (size_t j = 0; j < n; ++j) {
+            upper[j] = upper[j] * range->max - lower[j] * range->min;
+        }
+    }
+    return ALEX_OK_FLAG;
+}
+
+void alex_poly_batch_integ_range(alex_poly_batch *batch, alex_range *range, double *out) {
+    alex_set_flag(alex_poly_batch_integ_range_r(batch, range, out));
+}
@@ -0,0 +1,347 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "../include/pool.h"
+#include "../include/flags.h"
+#include "sum.h"
+
+#define _POOL_MAX_THREADS 256u
+
+/*
+ * The range of iterations [lo, hi) owned by one thread taking part in a loop. The owner takes
+ * iterations at lo, thieves take the upper half. Each deque has a cache line of its own, the deques
+ * are stored behind the pool in the same block, starting at the first line boundary past it.
+ */
+#define _POOL_LINE 64ul
+
+typedef struct {
+    pthread_mutex_t lock;
+    size_t lo, hi;
+} _pool_deque;
+
+typedef union {
+    _pool_deque deque;
+    char pad[((sizeof(_pool_deque) + _POOL_LINE - 1) / _POOL_LINE) * _POOL_LINE];
+} _pool_padded_deque;
+
+typedef struct {
+    alex_par_body body;
+    void *ctx;
+    unsigned int nslots; // the threads taking part, slot 0 is the calling thread
+    _pool_padded_deque *slots;
+} _pool_job;
+
+struct alex_pool {
+    unsigned int nworkers;
+    pthread_t *tids;
+    pthread_mutex_t busy; // held by the thread running a loop on the pool
+    pthread_mutex_t lock; // guards the fields below
+    pthread_cond_t wake, done;
+    unsigned long gen;
+    _pool_job *job;
+    unsigned int left; // the workers of the current loop which have not finished yet
+    int stop;
+    _pool_padded_deque *slots;
+};
+
+// set on the workers of every pool, and on the calling thread while it runs a loop
+static ALEX_THREAD_LOCAL int _pool_in_loop;
+
+static pthread_once_t _default_once = PTHREAD_ONCE_INIT;
+static alex_pool *_default_pool;
+
+static int _pool_take(_pool_deque *d, size_t *i) {
+    pthread_mutex_lock(&d->lock);
+    int found = d->lo < d->hi;
+    if (found) {
+        *i = d->lo++;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return found;
+}
+
+// moves the upper half of the range of another thread to the (empty) range of slot self
+static int _pool_steal(_pool_job *job, unsigned int self) {
+    for (unsigned int k = 1; k < job->nslots; ++k) {
+        _pool_deque *victim = &job->slots[(self + k) % job->nslots].deque;
+        pthread_mutex_lock(&victim->lock);
+        size_t n = victim->hi - victim->lo;
+        if (n == 0) {
+            pthread_mutex_unlock(&victim->lock);
+            continue;
+        }
+        size_t mid = victim->lo + n / 2, hi = victim->hi;
+        victim->hi = mid;
+        pthread_mutex_unlock(&victim->lock);
+
+        _pool_deque *own = &job->slots[self].deque;
+        pthread_mutex_lock(&own->lock);
+        own->lo = mid;
+        own->hi = hi;
+        pthread_mutex_unlock(&own->lock);
+        return 1;
+    }
+    return 0;
+}
+
+static void _pool_run(_pool_job *job, unsigned int self) {
+    size_t i;
+    do {
+        while (_pool_take(&job->slots[self].deque, &i)) {
+            job->body(i, job->ctx);
+        }
+    } while (_pool_steal(job, self));
+}
+
+static void *_pool_worker(void *arg) {
+    alex_pool *pool = ((void **) arg)[0];
+    unsigned int self = (unsigned int) (size_t) ((void **) arg)[1];
+    free(arg);
+    _pool_in_loop = 1;
+
+    unsigned long seen = 0;
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (pool->gen == seen && !pool->stop) {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+        if (pool->stop) {
+            break;
+        }
+        seen = pool->gen;
+        _pool_job *job = pool->job;
+        if (job == NULL || self >= job->nslots) {
+            continue; // not taking part in this loop
+        }
+
+        pthread_mutex_unlock(&pool->lock);
+        _pool_run(job, self);
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->left == 0) {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+// constructs a pool without accessing the flag, with as many workers as could be created
+static alex_pool *_pool_create(unsigned int threads) {
+    if (threads == 0) {
+        threads = alex_cpu_count();
+    }
+    if (threads > _POOL_MAX_THREADS) {
+        threads = _POOL_MAX_THREADS;
+    }
+
+    alex_pool *pool = malloc(sizeof(alex_pool) + _POOL_LINE + threads * sizeof(_pool_padded_deque));
+    pthread_t *tids = malloc(threads * sizeof(pthread_t));
+    if (pool == NULL || tids == NULL) {
+        free(pool);
+        free(tids);
+        return NULL;
+    }
+    uintptr_t start = (uintptr_t) (pool + 1);
+    _pool_padded_deque *slots = (_pool_padded_deque *) ((start + _POOL_LINE - 1) & ~(uintptr_t) (_POOL_LINE - 1));
+
+    pool->nworkers = 0;
+    pool->tids = tids;
+    pool->gen = 0;
+    pool->job = NULL;
+    pool->left = 0;
+    pool->stop = 0;
+    pool->slots = slots;
+    pthread_mutex_init(&pool->busy, NULL);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    for (unsigned int s = 0; s < threads; ++s) {
+        pthread_mutex_init(&slots[s].deque.lock, NULL);
+    }
+
+    while (pool->nworkers < threads - 1) {
+        void **arg = malloc(2 * sizeof(void *));
+        if (arg == NULL) {
+            break;
+        }
+        arg[0] = pool;
+        arg[1] = (void *) (size_t) (pool->nworkers + 1);
+        if (pthread_create(&tids[pool->nworkers], NULL, &_pool_worker, arg) != 0) {
+            free(arg);
+            break;
+        }
+        ++pool->nworkers;
+    }
+    return pool;
+}
+
+static void _pool_destroy(alex_pool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    for (unsigned int w = 0; w < pool->nworkers; ++w) {
+        pthread_join(pool->tids[w], NULL);
+    }
+
+    for (unsigned int s = 0; s <= pool->nworkers; ++s) {
+        pthread_mutex_destroy(&pool->slots[s].deque.lock);
+    }
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_mutex_destroy(&pool->busy);
+    free(pool->tids);
+    free(pool); // the deques are part of the same block
+}
+
+alex_pool *alex_make_pool(unsigned int threads) {
+    if (threads == 0) {
+        threads = alex_cpu_count();
+    }
+    if (threads > _POOL_MAX_THREADS) {
+        threads = _POOL_MAX_THREADS;
+    }
+
+    // unlike the default pool, a pool missing some of its threads is a failure
+    alex_pool *pool = _pool_create(threads);
+    if (pool != NULL && pool->nworkers + 1 < threads) {
+        _pool_destroy(pool);
+        pool = NULL;
+    }
+    if (pool == NULL) {
+        alex_set_flag(ALEX_BAD_ALLOC_FLAG);
+        return NULL;
+    }
+
+    alex_set_flag(ALEX_OK_FLAG);
+    return pool;
+}
+
+void alex_free_pool(alex_pool *pool) {
+    if (pool == NULL || pool == _default_pool) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return;
+    }
+
+    _pool_destroy(pool);
+    alex_set_flag(ALEX_OK_FLAG);
+}
+
+static void _default_init(void) {
+    _default_pool = _pool_create(0);
+}
+
+alex_pool *alex_default_pool(void) {
+    pthread_once(&_default_once, &_default_init);
+    return _default_pool;
+}
+
+unsigned int alex_pool_threads(alex_pool *pool) {
+    if (pool == NULL) {
+        pool = alex_default_pool();
+    }
+    return pool == NULL ? 1u : pool->nworkers + 1;
+}
+
+void alex_pool_for(alex_pool *pool, unsigned int threads, size_t count, alex_par_body body, void *ctx) {
+    if (pool == NULL) {
+        pool = alex_default_pool();
+    }
+    unsigned int nslots = pool == NULL ? 1u : pool->nworkers + 1;
+    if (threads != 0 && threads < nslots) {
+        nslots = threads;
+    }
+    if (count < nslots) {
+        nslots = (unsigned int) count;
+    }
+
+    // nested loops, and loops while the pool is busy elsewhere, run on the calling thread alone
+    if (nslots <= 1 || _pool_in_loop || pthread_mutex_trylock(&pool->busy) != 0) {
+        for (size_t i = 0; i < count; ++i) {
+            body(i, ctx);
+        }
+        return;
+    }
+
+    _pool_job job = {body, ctx, nslots, pool->slots};
+    for (unsigned int s = 0; s < nslots; ++s) {
+        pool->slots[s].deque.lo = (size_t) ((unsigned long long) count * s / nslots);
+        pool->slots[s].deque.hi = (size_t) ((unsigned long long) count * (s + 1) / nslots);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->job = &job;
+    pool->left = nslots - 1;
+    ++pool->gen;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    _pool_in_loop = 1;
+    _pool_run(&job, 0);
+    _pool_in_loop = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->left > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pool->job = NULL;
+    pthread_mutex_unlock(&pool->lock);
+    pthread_mutex_unlock(&pool->busy);
+}
+
+typedef struct {
+    alex_par_reduce_body body;
+    void *ctx;
+    double *values;
+} _pool_reduce_job;
+
+static void _pool_reduce_iter(size_t i, void *ctx) {
+    _pool_reduce_job *job = ctx;
+    job->values[i] = job->body(i, job->ctx);
+}
+
+double alex_internal_sum_pairwise(const double *v, size_t n) {
+    if (n <= 8) {
+        double sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            sum += v[i];
+        }
+        return sum;
+    }
+    return alex_internal_sum_pairwise(v, n / 2) + alex_internal_sum_pairwise(v + n / 2, n - n / 2);
+}
+
+int alex_pool_reduce(alex_pool *pool, unsigned int threads, size_t count, alex_par_reduce_body body, void *ctx,
+        double *res) {
+    double *values = malloc((count > 0 ? count : 1) * sizeof(double));
+    if (values == NULL) {
+        *res = 0;
+        return ALEX_BAD_ALLOC_FLAG;
+    }
+
+    _pool_reduce_job job = {body, ctx, values};
+    alex_pool_for(pool, threads, count, &_pool_reduce_iter, &job);
+    *res = alex_internal_sum_pairwise(values, count);
+    free(values);
+    return ALEX_OK_FLAG;
+}
@@ -0,0 +1,321 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+
+#include "../include/spoly.h"
+#include "../include/poly.h"
+#include "../include/flags.h"
+#include "../include/stats.h"
+
+/*
+ * The header is padded to the alignment of double and followed by the nterms coefficients, then
+ * by the nterms exponents.
+ */
+#define _SPOLY_HEADER_SIZE (((sizeof(alex_spoly) + sizeof(double) - 1) / sizeof(double)) * sizeof(double))
+#define _spoly_block_size(n) (_SPOLY_HEADER_SIZE + (size_t) (n) * (sizeof(double) + sizeof(unsigned int)))
+
+typedef struct {
+    unsigned int exp;
+    double coeff;
+} _spoly_term;
+
+/*
+ * Allocates an uninitialized spoly with room for nterms terms. Sets the flag on failure only.
+ */
+static alex_spoly *_spoly_alloc(size_t nterms) {
+    if (nterms > (SIZE_MAX - _SPOLY_HEADER_SIZE) / (sizeof(double) + sizeof(unsigned int))) {
+        alex_set_flag(ALEX_BAD_ALLOC_FLAG);
+        return NULL;
+    }
+
+    alex_spoly *spoly = malloc(_spoly_block_size(nterms));
+    if (spoly == NULL) {
+        alex_set_flag(ALEX_BAD_ALLOC_FLAG);
+        return NULL;
+    }
+    ALEX_STATS_ALLOC(_spoly_block_size(nterms));
+
+    spoly->nterms = nterms;
+    spoly->coeffs = (double *) ((char *) spoly + _SPOLY_HEADER_SIZE);
+    spoly->exps = (unsigned int *) (spoly->coeffs + nterms);
+    return spoly;
+}
+
+static int _spoly_term_cmp(const void *a, const void *b) {
+    unsigned int ea = ((const _spoly_term *) a)->exp, eb = ((const _spoly_term *) b)->exp;
+    return (ea > eb) - (ea < eb);
+}
+
+// x^n by squaring, n >= 1
+static double _spoly_ipow(double x, unsigned int n) {
+    double res = 1.0;
+    while (n > 1) {
+        if (n & 1u)
+            res *= x;
+        x *= x;
+        n >>= 1;
+    }
+    return res * x;
+}
+
+/*
+ * Horner's scheme over the terms: the partial sum is multiplied by x^(gap to the next lower
+ * exponent) before adding the next coefficient, and by x^(lowest exponent) at the end.
+ */
+static double _spoly_horner(const alex_spoly *spoly, double x) {
+    size_t k = spoly->nterms;
+    if (k == 0)
+        return 0.0;
+
+    const unsigned int *exps = spoly->exps;
+    const double *coeffs = spoly->coeffs;
+    double res = coeffs[--k];
+    while (k > 0) {
+        unsigned int gap = exps[k] - exps[k - 1];
+        res = res * (gap == 1 ? x : _spoly_ipow(x, gap)) + coeffs[k - 1];
+        k--;
+    }
+
+    return exps[0] == 0 ? res : res * _spoly_ipow(x, exps[0]);
+}
+
+alex_spoly *alex_make_spoly(size_t nterms, const unsigned int exps[], const double coeffs[]) {
+    if (nterms > 0 && (exps == NULL || coeffs == NULL)) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+
+    // the common case of strictly increasing exponents needs no sorting
+    int sorted = 1;
+    for (size_t i = 1; i < nterms && sorted; i++)
+        sorted = exps[i - 1] < exps[i];
+
+    _spoly_term *terms = NULL;
+    if (!sorted) {
+        terms = malloc(nterms * sizeof(_spoly_term));
+        if (terms == NULL) {
+            alex_set_flag(ALEX_BAD_ALLOC_FLAG);
+            return NULL;
+        }
+        for (size_t i = 0; i < nterms; i++) {
+            terms[i].exp = exps[i];
+            terms[i].coeff = coeffs[i];
+        }
+        qsort(terms, nterms, sizeof(_spoly_term), &_spoly_term_cmp);
+    }
+
+    alex_spoly *spoly = _spoly_alloc(nterms);
+    if (spoly == NULL) {
+        free(terms);
+        return NULL; // flag already set by _spoly_alloc()
+    }
+
+    // merges runs of equal exponents and drops zero sums, the result never has more terms
+    size_t n = 0;
+    for (size_t i = 0; i < nterms;) {
+        unsigned int exp = sorted ? exps[i] : terms[i].exp;
+        double coeff = 0.0;
+        for (; i < nterms && (sorted ? exps[i] : terms[i].exp) == exp; i++)
+            coeff += sorted ? coeffs[i] : terms[i].coeff;
+        if (coeff != 0.0) {
+            spoly->exps[n] = exp;
+            spoly->coeffs[n] = coeff;
+            n++;
+        }
+    }
+    free(terms);
+
+    if (n < nterms) {
+        // the exponents start behind the coefficients, move them up to where n terms expect them
+        memmove(spoly->coeffs + n, spoly->exps, n * sizeof(unsigned int));
+        spoly->exps = (unsigned int *) (spoly->coeffs + n);
+        spoly->nterms = n;
+    }
+
+    alex_set_flag(ALEX_OK_FLAG);
+    return spoly;
+}
+
+void alex_free_spoly(alex_spoly *spoly) {
+    if (spoly == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return;
+    }
+
+    free(spoly); // the terms are part of the same block
+    alex_set_flag(ALEX_OK_FLAG);
+}
+
+unsigned int alex_spoly_deg(alex_spoly *spoly) {
+    if (spoly == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return 0;
+    }
+
+    alex_set_flag(ALEX_OK_FLAG);
+    return spoly->nterms == 0 ? 0 : spoly->exps[spoly->nterms - 1];
+}
+
+size_t alex_spoly_nterms(alex_spoly *spoly) {
+    if (spoly == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return 0;
+    }
+
+    alex_set_flag(ALEX_OK_FLAG);
+    return spoly->nterms;
+}
+
+double alex_spoly_eval(alex_spoly *spoly, double x) {
+    double res;
+    alex_set_flag(alex_spoly_eval_r(spoly, x, &res));
+    return res;
+}
+
+int alex_spoly_eval_r(alex_spoly *spoly, double x, double *res) {
+    if (spoly == NULL) {
+        *res = 0.0;
+        return ALEX_INV_PARAM_FLAG;
+    }
+
+    *res = _spoly_horner(spoly, x);
+    return ALEX_OK_FLAG;
+}
+
+alex_spoly *alex_spoly_diff(alex_spoly *spoly) {
+    if (spoly == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+
+    // only the constant term vanishes, and only the first term can be constant
+    size_t skip = spoly->nterms > 0 && spoly->exps[0] == 0;
+    alex_spoly *res = _spoly_alloc(spoly->nterms - skip);
+    if (res == NULL) {
+        return NULL; // flag already set by _spoly_alloc()
+    }
+
+    for (size_t k = 0; k < res->nterms; k++) {
+        unsigned int exp = spoly->exps[k + skip];
+        res->exps[k] = exp - 1;
+        res->coeffs[k] = spoly->coeffs[k + skip] * exp;
+    }
+
+    alex_set_flag(ALEX_OK_FLAG);
+    return res;
+}
+
+alex_spoly *alex_spoly_integ(alex_spoly *spoly, double c) {
+    if (spoly == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+    else if (spoly->nterms > 0 && spoly->exps[spoly->nterms - 1] == UINT_MAX) {
+        alex_set_flag(ALEX_ALG_OVERFLOW_FLAG);
+        return NULL;
+    }
+
+    // every exponent is shifted up by one, as such the constant term goes in front
+    size_t lead = c != 0.0;
+    alex_spoly *res = _spoly_alloc(spoly->nterms + lead);
+    if (res == NULL) {
+        return NULL; // flag already set by _spoly_alloc()
+    }
+
+    if (lead) {
+        res->exps[0] = 0;
+        res->coeffs[0] = c;
+    }
+    for (size_t k = 0; k < spoly->nterms; k++) {
+        unsigned int exp = spoly->exps[k] + 1;
+        res->exps[k + lead] = exp;
+        res->coeffs[k + lead] = spoly->coeffs[k] / exp;
+    }
+
+    alex_set_flag(ALEX_OK_FLAG);
+    return res;
+}
+
+alex_spoly *alex_poly_to_spoly(alex_poly *poly) {
+    if (poly == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+
+    size_t nterms = 0;
+    for (unsigned int k = 0; k <= poly->deg; k++)
+        nterms += poly->coeffs[k] != 0.0;
+
+    alex_spoly *spoly = _spoly_alloc(nterms);
+    if (spoly == NULL) {
+        return NULL; // flag already set by _spoly_alloc()
+    }
+
+    size_t n = 0;
+    for (unsigned int k = 0; k <= poly->deg; k++) {
+        if (poly->coeffs[k] != 0.0) {
+            spoly->exps[n] = k;
+            spoly->coeffs[n] = poly->coeffs[k];
+            n++;
+        }
+    }
+
+    alex_set_flag(ALEX_OK_FLAG);
+    return spoly;
+}
+
+alex_poly *alex_spoly_to_poly(alex_spoly *spoly) {
+    if (spoly == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return NULL;
+    }
+
+    unsigned int deg = spoly->nterms == 0 ? 0 : spoly->exps[spoly->nterms - 1];
+    if (deg == UINT_MAX) {
+        alex_set_flag(ALEX_BAD_ALLOC_FLAG); // deg + 1 coefficients cannot be addressed
+        return NULL;
+    }
+
+    alex_poly *poly = alex_make_poly(deg, NULL);
+    if (poly == NULL) {
+        return NULL; // flag already set by alex_make_poly()
+    }
+
+    for (size_t k = 0; k < spoly->nterms; k++)
+        poly->coeffs[spoly->exps[k]] = spoly->coeffs[k];
+
+    return poly; // flag set to ALEX_OK_FLAG by alex_make_poly()
+}
+
+static double _spoly_closure_func(double x, void *ctx) {
+    return _spoly_horner(ctx, x);
+}
+
+alex_closure_1d alex_spoly_closure(alex_spoly *spoly) {
+    if (spoly == NULL) {
+        alex_set_flag(ALEX_INV_PARAM_FLAG);
+        return alex_make_closure(NULL, NULL);
+    }
+
+    alex_set_flag(ALEX_OK_FLAG);
+    return alex_make_closure(&_spoly_closure_func, spoly);
+}
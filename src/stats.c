@@ -0,0 +1,249 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <string.h>
+
+#include "../include/stats.h"
+
+static const char *const _api_names[ALEX_STATS_APIS] = {"integrate", "cubature", "root", "poly", "approx"};
+
+const char *alex_stats_api_name(unsigned int api) {
+    return api < ALEX_STATS_APIS ? _api_names[api] : "unknown";
+}
+
+#if defined(ALEX_STATS)
+
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "../include/flags.h"
+
+/*
+ * The counters of one thread, linked into the list of live threads. Only the owning thread writes
+ * them, with relaxed atomic stores, so that the snapshots may read them at any time without a lock
+ * prefix on the hot path.
+ */
+typedef struct _stats_block {
+    alex_stats stats;
+    struct _stats_block *prev, *next;
+} _stats_block;
+
+static pthread_mutex_t _stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t _stats_once = PTHREAD_ONCE_INIT;
+static pthread_key_t _stats_key;
+static _stats_block *_stats_live;
+// the counters of the threads which have exited, and the totals at the last reset
+static alex_stats _stats_retired, _stats_baseline;
+
+static ALEX_THREAD_LOCAL _stats_block *_local;
+// the family of the outermost running call of this thread and the nesting depth
+static ALEX_THREAD_LOCAL unsigned int _depth, _current;
+
+// adds (or subtracts, if negate) the counters of src to those of dst
+static void _stats_add(alex_stats *dst, const alex_stats *src, int negate) {
+    for (unsigned int api = 0; api < ALEX_STATS_APIS; ++api) {
+        const unsigned long long *s = &src->apis[api].calls;
+        unsigned long long *d = &dst->apis[api].calls;
+        for (size_t k = 0; k < sizeof(alex_stats_counters) / sizeof(unsigned long long); ++k) {
+            unsigned long long v = __atomic_load_n(&s[k], __ATOMIC_RELAXED);
+            d[k] = negate ? d[k] - v : d[k] + v;
+        }
+    }
+}
+
+// folds the counters of an exiting thread into the retired ones
+static void _stats_retire(void *arg) {
+    _stats_block *block = arg;
+    pthread_mutex_lock(&_stats_lock);
+    _stats_add(&_stats_retired, &block->stats, 0);
+    if (block->prev != NULL)
+        block->prev->next = block->next;
+    else
+        _stats_live = block->next;
+    if (block->next != NULL)
+        block->next->prev = block->prev;
+    pthread_mutex_unlock(&_stats_lock);
+    free(block);
+}
+
+static void _stats_init(void) {
+    pthread_key_create(&_stats_key, &_stats_retire);
+}
+
+// the counters of the calling thread, NULL if they could not be allocated
+static _stats_block *_stats_local(void) {
+    if (_local != NULL) {
+        return _local;
+    }
+
+    _stats_block *block = calloc(1, sizeof(_stats_block));
+    if (block == NULL) {
+        return NULL;
+    }
+    pthread_once(&_stats_once, &_stats_init);
+    pthread_mutex_lock(&_stats_lock);
+    block->next = _stats_live;
+    if (_stats_live != NULL)
+        _stats_live->prev = block;
+    _stats_live = block;
+    pthread_mutex_unlock(&_stats_lock);
+    pthread_setspecific(_stats_key, block);
+    return _local = block;
+}
+
+static inline void _stats_inc(unsigned long long *counter, unsigned long long n) {
+    __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + n, __ATOMIC_RELAXED);
+}
+
+static unsigned long long _stats_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long) ts.tv_sec * 1000000000ull + (unsigned long long) ts.tv_nsec;
+}
+
+alex_stats_scope alex_stats_begin(unsigned int api) {
+    alex_stats_scope scope = {api, _depth++ == 0, 0, 0};
+    if (scope.active) {
+        _current = api;
+        scope.start = _stats_now();
+    }
+    return scope;
+}
+
+void alex_stats_end(alex_stats_scope *scope) {
+    --_depth;
+    if (!scope->active) {
+        return;
+    }
+
+    unsigned long long nanos = _stats_now() - scope->start;
+    _stats_block *block = _stats_local();
+    if (block != NULL) {
+        alex_stats_counters *c = &block->stats.apis[scope->api];
+        _stats_inc(&c->calls, 1);
+        _stats_inc(&c->evals, __atomic_load_n(&scope->evals, __ATOMIC_RELAXED));
+        _stats_inc(&c->nanos, nanos);
+    }
+}
+
+void alex_stats_evals(alex_stats_scope *scope, unsigned long long n) {
+    if (scope->active) {
+        __atomic_fetch_add(&scope->evals, n, __ATOMIC_RELAXED);
+    }
+}
+
+void alex_stats_alloc(size_t bytes) {
+    _stats_block *block = _stats_local();
+    if (block != NULL) {
+        alex_stats_counters *c = &block->stats.apis[_depth > 0 ? _current : ALEX_STATS_POLY];
+        _stats_inc(&c->allocs, 1);
+        _stats_inc(&c->bytes, bytes);
+    }
+}
+
+// the counting closures may be called from worker threads, hence the atomic increments
+static double _count_func(double x, void *ctx) {
+    alex_stats_closure *counted = ctx;
+    __atomic_fetch_add(&counted->scope->evals, 1, __ATOMIC_RELAXED);
+    return alex_closure_eval(counted->inner, x);
+}
+
+static void _count_vfunc(const double *x, double *y, size_t n, void *ctx) {
+    alex_stats_vclosure *counted = ctx;
+    __atomic_fetch_add(&counted->scope->evals, n, __ATOMIC_RELAXED);
+    counted->inner.func(x, y, n, counted->inner.ctx);
+}
+
+static void _count_vfunc_nd(unsigned int dim, const double *x, double *y, size_t n, void *ctx) {
+    alex_stats_vclosure_nd *counted = ctx;
+    __atomic_fetch_add(&counted->scope->evals, n, __ATOMIC_RELAXED);
+    counted->inner.func(dim, x, y, n, counted->inner.ctx);
+}
+
+alex_closure_1d alex_stats_count(alex_stats_scope *scope, alex_stats_closure *counted, alex_closure_1d f) {
+    // the nested calls receive the closure already counted by the outer one
+    if (!scope->active) {
+        return f;
+    }
+    counted->inner = f;
+    counted->scope = scope;
+    return alex_make_closure(&_count_func, counted);
+}
+
+alex_vclosure_1d alex_stats_vcount(alex_stats_scope *scope, alex_stats_vclosure *counted, alex_vclosure_1d f) {
+    if (!scope->active) {
+        return f;
+    }
+    counted->inner = f;
+    counted->scope = scope;
+    return alex_make_vclosure(&_count_vfunc, counted);
+}
+
+alex_vclosure_nd alex_stats_ndcount(alex_stats_scope *scope, alex_stats_vclosure_nd *counted, alex_vclosure_nd f) {
+    if (!scope->active) {
+        return f;
+    }
+    counted->inner = f;
+    counted->scope = scope;
+    return alex_make_vclosure_nd(&_count_vfunc_nd, counted);
+}
+
+// the totals of all threads, since the start of the process
+static alex_stats _stats_total(void) {
+    alex_stats total = _stats_retired;
+    for (_stats_block *block = _stats_live; block != NULL; block = block->next) {
+        _stats_add(&total, &block->stats, 0);
+    }
+    return total;
+}
+
+int alex_stats_enabled(void) {
+    return 1;
+}
+
+alex_stats alex_stats_snapshot(void) {
+    pthread_mutex_lock(&_stats_lock);
+    alex_stats stats = _stats_total();
+    _stats_add(&stats, &_stats_baseline, 1);
+    pthread_mutex_unlock(&_stats_lock);
+    return stats;
+}
+
+void alex_stats_reset(void) {
+    pthread_mutex_lock(&_stats_lock);
+    _stats_baseline = _stats_total();
+    pthread_mutex_unlock(&_stats_lock);
+}
+
+#else
+
+int alex_stats_enabled(void) {
+    return 0;
+}
+
+alex_stats alex_stats_snapshot(void) {
+    alex_stats stats;
+    memset(&stats, 0, sizeof(stats));
+    return stats;
+}
+
+void alex_stats_reset(void) {
+}
+
+#endif
@@ -0,0 +1,38 @@
+/*
+ *   ALEX is a C library and framework for mathematical operations
+ *   Copyright (C) 2020  Lorenzo Calza
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*
+ * Private header, shared by the parallel routines of the library and not installed with the
+ * public headers. Its functions are hidden, as such they are not exported from the shared library.
+ */
+
+#ifndef _ALEX_SRC_SUM_H
+#define _ALEX_SRC_SUM_H
+
+#include <stddef.h>
+
+#if defined(__GNUC__) && !defined(_WIN32)
+#define ALEX_INTERNAL __attribute__((visibility("hidden")))
+#else
+#define ALEX_INTERNAL
+#endif
+
+// the pairwise sum of the n values at v, in the order alex_pool_reduce() combines its terms
+ALEX_INTERNAL double alex_internal_sum_pairwise(const double *v, size_t n);
+
+#endif
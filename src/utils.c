@@ -18,16 +18,57 @@
  */
 
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 
 #include "../include/utils.h"
 
+#if defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+#include <emmintrin.h>
+#define ALEX_UTILS_SSE2
+#endif
+
+/*
+ * Both are forwarded to the platform memset, which the compiler also expands inline for
+ * small constant sizes. Libc implementations pick the widest stores the CPU supports and
+ * handle the unaligned head and tail, which a portable loop here could not do better.
+ */
 void alex_mclear(void *ptr, size_t size) {
-    alex_mset(ptr, size, 0);
+    memset(ptr, 0, size);
 }
 
 void alex_mset(void *ptr, size_t size, char val) {
-    while (size-- > 0) {
-        *(char *) ptr = val;
-        ++ptr;
+    memset(ptr, (unsigned char) val, size);
+}
+
+void alex_mclear_nt(void *ptr, size_t size) {
+#ifdef ALEX_UTILS_SSE2
+    if (size < ALEX_MCLEAR_NT_THRESHOLD) {
+        memset(ptr, 0, size);
+        return;
     }
-}
\ No newline at end of file
+
+    // regular stores up to the first 16-byte boundary, streaming stores for the aligned body
+    unsigned char *p = ptr;
+    size_t head = (16 - ((uintptr_t) p & 15)) & 15;
+    memset(p, 0, head);
+    p += head;
+    size -= head;
+
+    const __m128i zero = _mm_setzero_si128();
+    __m128i *q = (__m128i *) p;
+    size_t blocks = size / 64;
+    for (size_t i = 0; i < blocks; ++i, q += 4) {
+        _mm_stream_si128(q, zero);
+        _mm_stream_si128(q + 1, zero);
+        _mm_stream_si128(q + 2, zero);
+        _mm_stream_si128(q + 3, zero);
+    }
+    // streaming stores are weakly ordered, make them visible before returning
+    _mm_sfence();
+
+    memset(q, 0, size % 64);
+#else
+    memset(ptr, 0, size);
+#endif
+}